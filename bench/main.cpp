@@ -0,0 +1,551 @@
+// Headless benchmark suite comparing the simulation backends across grid
+// sizes, CPU thread counts and OpenCL kernel variants.
+//
+// Usage: greyscott_bench [--sizes 256,512,...] [--threads 1,4,...]
+//                        [--backends cpu,opencl] [--kernels file:name,...]
+//                        [--warmup N] [--reps N] [--min-time SECONDS]
+//                        [--json FILE] [--csv FILE]
+//                        [--io DIR] [--io-depth N] [--io-time SECONDS]
+//                        [--shm-time SECONDS] [--shm-slots N]
+//                        [--ensemble MEMBERS]
+#include "Checkpoint.hpp"
+#include "SharedFrameRing.hpp"
+#include "SimulationCPU.hpp"
+#include "SimulationCPUEnsemble.hpp"
+#ifdef USE_OPENCL
+#include "ComputeManager.hpp"
+#include "Simulation.hpp"
+#include "SimulationEnsemble.hpp"
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Each cell reads and writes one float2 per step (ideal, cache-perfect)
+    constexpr double kBytesPerCell{ 4.0 * sizeof(float) };
+
+    struct BenchOptions {
+        std::vector<int> sizes{ 256, 512, 1024, 2048, 4096, 8192 };
+        std::vector<int> threads{};
+        std::vector<std::string> backends{ "cpu", "opencl" };
+        std::vector<std::string> kernels{ "kernels/grey_scott.cl:grey_scott_step" };
+        int warmupSteps{ 3 };
+        int repetitions{ 5 };
+        double minRepSeconds{ 0.25 };
+        std::string jsonPath{};
+        std::string csvPath{};
+        // Checkpoint write throughput, measured only when a directory is given
+        std::string ioDirectory{};
+        int ioQueueDepth{ 32 };
+        double ioSeconds{ 2.0 };
+        // Shared-memory ring throughput, measured only when positive
+        double shmSeconds{ 0.0 };
+        int shmSlots{ 4 };
+        // Members of the batched OpenCL ensemble, measured only when positive;
+        // also enables the CPU SIMD-lane ensemble
+        int ensembleMembers{};
+    };
+
+    struct BenchResult {
+        std::string backend{};
+        std::string variant{};
+        int width{};
+        int height{};
+        int threads{};
+        int stepsPerRep{};
+        std::vector<double> stepsPerSecond{};
+        double median{};
+        double p10{};
+        double p90{};
+        double min{};
+        double max{};
+        double cellsPerSecond{};
+        double gigabytesPerSecond{};
+        double kernelMs{};
+    };
+
+    std::vector<std::string> splitList(const std::string& text, char delimiter) {
+        std::vector<std::string> items{};
+        std::stringstream stream{ text };
+        std::string item{};
+        while (std::getline(stream, item, delimiter)) {
+            if (!item.empty()) { items.push_back(item); }
+        }
+        return items;
+    }
+
+    std::vector<int> parseIntList(const std::string& text) {
+        std::vector<int> values{};
+        for (const auto& item : splitList(text, ',')) {
+            values.push_back(std::stoi(item));
+        }
+        return values;
+    }
+
+    double percentile(std::vector<double> values, double p) {
+        if (values.empty()) { return 0.0; }
+        std::sort(values.begin(), values.end());
+        double rank{ p * (values.size() - 1) };
+        size_t lower{ static_cast<size_t>(std::floor(rank)) };
+        size_t upper{ static_cast<size_t>(std::ceil(rank)) };
+        return values[lower] + (values[upper] - values[lower]) * (rank - lower);
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count();
+    }
+
+    // Warms up, sizes repetitions to at least minRepSeconds each, then times
+    // them; kernelTime reports the backend's own per-step compute time
+    BenchResult measure(const BenchOptions& options, int width, int height,
+                        const std::function<void()>& step,
+                        const std::function<float()>& kernelTime) {
+        BenchResult result{};
+        result.width = width;
+        result.height = height;
+
+        auto warmupStart{ std::chrono::steady_clock::now() };
+        for (int i{}; i < options.warmupSteps; ++i) { step(); }
+        double perStep{ secondsSince(warmupStart) / std::max(options.warmupSteps, 1) };
+
+        result.stepsPerRep = static_cast<int>(std::clamp(
+            std::ceil(options.minRepSeconds / std::max(perStep, 1e-9)), 1.0, 100000.0));
+
+        std::vector<double> kernelSamples{};
+        for (int rep{}; rep < options.repetitions; ++rep) {
+            auto start{ std::chrono::steady_clock::now() };
+            for (int i{}; i < result.stepsPerRep; ++i) { step(); }
+            double elapsed{ secondsSince(start) };
+
+            result.stepsPerSecond.push_back(result.stepsPerRep / elapsed);
+            kernelSamples.push_back(kernelTime());
+        }
+
+        result.median = percentile(result.stepsPerSecond, 0.5);
+        result.p10 = percentile(result.stepsPerSecond, 0.1);
+        result.p90 = percentile(result.stepsPerSecond, 0.9);
+        result.min = percentile(result.stepsPerSecond, 0.0);
+        result.max = percentile(result.stepsPerSecond, 1.0);
+        result.cellsPerSecond = result.median * width * height;
+        result.gigabytesPerSecond = result.cellsPerSecond * kBytesPerCell / 1e9;
+        result.kernelMs = percentile(kernelSamples, 0.5);
+        return result;
+    }
+
+    void printResult(const BenchResult& result) {
+        std::cout << std::left << std::setw(8) << result.backend << std::setw(28)
+                  << result.variant << std::right << std::setw(6) << result.width
+                  << 'x' << std::left << std::setw(6) << result.height << std::right
+                  << std::setw(4) << result.threads << std::fixed
+                  << std::setprecision(1) << std::setw(12) << result.median
+                  << std::setw(12) << result.p10 << std::setw(12) << result.p90
+                  << std::setprecision(3) << std::setw(12)
+                  << result.cellsPerSecond / 1e9 << std::setw(10)
+                  << result.gigabytesPerSecond << std::setw(12) << result.kernelMs
+                  << '\n';
+    }
+
+    bool writeJson(const std::string& path, const std::vector<BenchResult>& results) {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open JSON output: " << path << '\n';
+            return false;
+        }
+
+        file << std::setprecision(9) << "{\n  \"results\": [\n";
+        for (size_t i{}; i < results.size(); ++i) {
+            const auto& r{ results[i] };
+            file << "    {\"backend\": \"" << r.backend << "\", \"variant\": \""
+                 << r.variant << "\", \"width\": " << r.width
+                 << ", \"height\": " << r.height << ", \"threads\": " << r.threads
+                 << ", \"steps_per_rep\": " << r.stepsPerRep
+                 << ", \"steps_per_s\": {\"median\": " << r.median
+                 << ", \"p10\": " << r.p10 << ", \"p90\": " << r.p90
+                 << ", \"min\": " << r.min << ", \"max\": " << r.max
+                 << ", \"samples\": [";
+            for (size_t s{}; s < r.stepsPerSecond.size(); ++s) {
+                file << (s ? ", " : "") << r.stepsPerSecond[s];
+            }
+            file << "]}, \"cells_per_s\": " << r.cellsPerSecond
+                 << ", \"effective_gb_per_s\": " << r.gigabytesPerSecond
+                 << ", \"kernel_ms\": " << r.kernelMs << '}'
+                 << (i + 1 < results.size() ? "," : "") << '\n';
+        }
+        file << "  ]\n}\n";
+        return file.good();
+    }
+
+    bool writeCsv(const std::string& path, const std::vector<BenchResult>& results) {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open CSV output: " << path << '\n';
+            return false;
+        }
+
+        file << "backend,variant,width,height,threads,steps_per_rep,"
+                "steps_per_s_median,steps_per_s_p10,steps_per_s_p90,"
+                "steps_per_s_min,steps_per_s_max,cells_per_s,"
+                "effective_gb_per_s,kernel_ms\n";
+        file << std::setprecision(9);
+        for (const auto& r : results) {
+            file << r.backend << ',' << r.variant << ',' << r.width << ','
+                 << r.height << ',' << r.threads << ',' << r.stepsPerRep << ','
+                 << r.median << ',' << r.p10 << ',' << r.p90 << ',' << r.min << ','
+                 << r.max << ',' << r.cellsPerSecond << ',' << r.gigabytesPerSecond
+                 << ',' << r.kernelMs << '\n';
+        }
+        return file.good();
+    }
+
+    void printUsage() {
+        std::cout << "Usage: greyscott_bench [options]\n"
+                  << "  --sizes LIST      Square grid sizes (default 256,...,8192)\n"
+                  << "  --threads LIST    CPU thread counts (default 1,<cores>)\n"
+                  << "  --backends LIST   cpu,opencl (default both)\n"
+                  << "  --kernels LIST    OpenCL variants as file:kernel_name\n"
+                  << "  --warmup N        Warmup steps per configuration (default 3)\n"
+                  << "  --reps N          Timed repetitions (default 5)\n"
+                  << "  --min-time S      Minimum seconds per repetition (default 0.25)\n"
+                  << "  --json FILE       Write results as JSON\n"
+                  << "  --csv FILE        Write results as CSV\n"
+                  << "  --io DIR          Also measure sustained checkpoint writes to DIR\n"
+                  << "  --io-depth N      io_uring queue depth for direct writes (default 32)\n"
+                  << "  --io-time S       Seconds of writing per I/O configuration (default 2)\n"
+                  << "  --shm-time S      Also measure the shared-memory frame ring for S seconds\n"
+                  << "  --shm-slots N     Slots in the shared-memory ring (default 4)\n"
+                  << "  --ensemble N      Also step N grids of each size in one OpenCL launch,\n"
+                  << "                    and 8/16 per CPU SIMD-lane ensemble\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+        for (int i{ 1 }; i < argc; ++i) {
+            std::string arg{ argv[i] };
+            if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return false;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << '\n';
+                return false;
+            }
+
+            std::string value{ argv[++i] };
+            if (arg == "--sizes") { options.sizes = parseIntList(value); }
+            else if (arg == "--threads") { options.threads = parseIntList(value); }
+            else if (arg == "--backends") { options.backends = splitList(value, ','); }
+            else if (arg == "--kernels") { options.kernels = splitList(value, ','); }
+            else if (arg == "--warmup") { options.warmupSteps = std::stoi(value); }
+            else if (arg == "--reps") { options.repetitions = std::max(1, std::stoi(value)); }
+            else if (arg == "--min-time") { options.minRepSeconds = std::stod(value); }
+            else if (arg == "--json") { options.jsonPath = value; }
+            else if (arg == "--csv") { options.csvPath = value; }
+            else if (arg == "--io") { options.ioDirectory = value; }
+            else if (arg == "--io-depth") { options.ioQueueDepth = std::max(1, std::stoi(value)); }
+            else if (arg == "--io-time") { options.ioSeconds = std::stod(value); }
+            else if (arg == "--shm-time") { options.shmSeconds = std::stod(value); }
+            else if (arg == "--shm-slots") { options.shmSlots = std::max(2, std::stoi(value)); }
+            else if (arg == "--ensemble") { options.ensembleMembers = std::stoi(value); }
+            else {
+                std::cerr << "Unknown option: " << arg << '\n';
+                printUsage();
+                return false;
+            }
+        }
+
+        if (options.threads.empty()) {
+            options.threads.push_back(1);
+            int cores{ static_cast<int>(std::thread::hardware_concurrency()) };
+            if (cores > 1) { options.threads.push_back(cores); }
+        }
+        return true;
+    }
+
+    // Writes synced checkpoints back to back for ioSeconds per configuration,
+    // so the rate includes writeback rather than just filling the page cache
+    void benchmarkWrites(const BenchOptions& options) {
+        using namespace GreyScott;
+
+        struct Variant {
+            const char* name{};
+            IOMode mode{};
+            bool useUring{};
+        };
+        const Variant variants[]{
+            { "buffered", IOMode::Buffered, false },
+            { "direct+pwrite", IOMode::Direct, false },
+            { "direct+io_uring", IOMode::Direct, true },
+        };
+        std::string path{ options.ioDirectory + "/greyscott_bench_io.ckpt" };
+
+        std::cout << '\n' << std::left << std::setw(18) << "io" << std::right
+                  << std::setw(13) << "grid" << std::setw(8) << "writes"
+                  << std::setw(10) << "GB/s" << '\n';
+
+        for (int size : options.sizes) {
+            try {
+                std::vector<float, AlignedAllocator<float>> field(
+                    static_cast<size_t>(size) * size * 2, 0.5f);
+                CheckpointInfo info{};
+                info.width = size;
+                info.height = size;
+
+                for (const Variant& variant : variants) {
+                    FileWriterOptions io{};
+                    io.mode = variant.mode;
+                    io.useUring = variant.useUring;
+                    io.queueDepth = options.ioQueueDepth;
+
+                    int writes{};
+                    auto start{ std::chrono::steady_clock::now() };
+                    do {
+                        if (!writeCheckpoint(path, info, field.data(), io)) { break; }
+                        ++writes;
+                    } while (secondsSince(start) < options.ioSeconds || writes < 3);
+                    double elapsed{ secondsSince(start) };
+
+                    double bytes{ static_cast<double>(writes) * field.size() * sizeof(float) };
+                    std::cout << std::left << std::setw(18) << variant.name << std::right
+                              << std::setw(13) << (std::to_string(size) + "x" + std::to_string(size))
+                              << std::setw(8) << writes << std::setw(10) << std::fixed
+                              << std::setprecision(2) << bytes / elapsed / 1e9
+                              << std::defaultfloat << '\n';
+                }
+            } catch (const std::bad_alloc&) {
+                std::cerr << "Skipping I/O " << size << "x" << size << ": out of memory\n";
+            }
+        }
+        std::remove(path.c_str());
+    }
+
+    // Publishes back to back into a shared-memory ring while a second
+    // mapping reads the newest frame in place, as an external consumer
+    // would, for shmSeconds per grid size
+    void benchmarkSharedMemory(const BenchOptions& options) {
+        using namespace GreyScott;
+        const std::string name{ "/greyscott_bench" };
+
+        std::cout << '\n' << std::left << std::setw(18) << "shm" << std::right
+                  << std::setw(13) << "grid" << std::setw(12) << "pub/s"
+                  << std::setw(10) << "GB/s" << std::setw(12) << "read/s"
+                  << std::setw(10) << "GB/s" << std::setw(8) << "torn" << '\n';
+
+        for (int size : options.sizes) {
+            try {
+                std::vector<float> field(static_cast<size_t>(size) * size * 2, 0.5f);
+                size_t bytes{ field.size() * sizeof(float) };
+
+                SharedFramePublisher publisher{};
+                SharedFrameReader reader{};
+                if (!publisher.open(name, size, size, options.shmSlots) || !reader.open(name)) {
+                    return;
+                }
+
+                std::atomic<bool> done{};
+                uint64_t read{};
+                uint64_t torn{};
+                std::thread consumer{ [&] {
+                    uint64_t lastFrame{ UINT64_MAX };
+                    volatile float sink{};
+                    while (!done.load(std::memory_order_relaxed)) {
+                        SharedFrameView view{};
+                        if (!reader.acquire(view) || view.frame == lastFrame) { continue; }
+                        float sum{};
+                        for (size_t i{}; i < field.size(); i += 2) { sum += view.field[i]; }
+                        sink = sum;
+                        if (reader.validate(view)) {
+                            lastFrame = view.frame;
+                            ++read;
+                        } else {
+                            ++torn;
+                        }
+                    }
+                    (void)sink;
+                } };
+
+                CheckpointInfo info{};
+                auto start{ std::chrono::steady_clock::now() };
+                do {
+                    publisher.publish(info, [&](float* slot) {
+                        std::copy(field.begin(), field.end(), slot);
+                    });
+                    ++info.step;
+                } while (secondsSince(start) < options.shmSeconds);
+                double elapsed{ secondsSince(start) };
+                done = true;
+                consumer.join();
+
+                double published{ static_cast<double>(publisher.getPublished()) };
+                std::cout << std::left << std::setw(18)
+                          << (std::to_string(options.shmSlots) + " slots") << std::right
+                          << std::setw(13) << (std::to_string(size) + "x" + std::to_string(size))
+                          << std::fixed << std::setprecision(1) << std::setw(12)
+                          << published / elapsed << std::setprecision(2) << std::setw(10)
+                          << published * bytes / elapsed / 1e9 << std::setprecision(1)
+                          << std::setw(12) << read / elapsed << std::setprecision(2)
+                          << std::setw(10) << read * bytes / elapsed / 1e9
+                          << std::defaultfloat << std::setw(8) << torn << '\n';
+            } catch (const std::bad_alloc&) {
+                std::cerr << "Skipping shared memory " << size << "x" << size
+                          << ": out of memory\n";
+            }
+        }
+    }
+
+    bool wants(const BenchOptions& options, const std::string& backend) {
+        return std::find(options.backends.begin(), options.backends.end(), backend) !=
+               options.backends.end();
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace GreyScott;
+
+    BenchOptions options{};
+    try {
+        if (!parseOptions(argc, argv, options)) { return 1; }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid argument: " << e.what() << '\n';
+        return 1;
+    }
+
+    std::vector<BenchResult> results{};
+
+    std::cout << std::left << std::setw(8) << "backend" << std::setw(28) << "variant"
+              << std::right << std::setw(13) << "grid" << std::setw(4) << "thr"
+              << std::setw(12) << "steps/s" << std::setw(12) << "p10"
+              << std::setw(12) << "p90" << std::setw(12) << "Gcells/s"
+              << std::setw(10) << "GB/s" << std::setw(12) << "kernel ms" << '\n';
+
+    if (wants(options, "cpu")) {
+        for (int size : options.sizes) {
+            for (int threads : options.threads) {
+                try {
+                    SimulationCPU simulation(size, size);
+                    simulation.initialize();
+                    simulation.setThreadCount(threads);
+
+                    BenchResult result{ measure(
+                        options, size, size,
+                        [&] { simulation.step(simulation.getParams()); },
+                        [&] { return simulation.getLastComputeTime(); }) };
+                    result.backend = "cpu";
+                    result.variant = "stencil";
+                    result.threads = simulation.getThreadCount();
+                    printResult(result);
+                    results.push_back(result);
+                } catch (const std::bad_alloc&) {
+                    std::cerr << "Skipping CPU " << size << "x" << size
+                              << ": out of memory\n";
+                }
+
+                if (options.ensembleMembers <= 0) { continue; }
+                try {
+                    SimulationCPUEnsemble ensemble(size, size);
+                    ensemble.initialize();
+                    ensemble.setThreadCount(threads);
+
+                    // Cells and GB/s count every lane
+                    BenchResult result{ measure(
+                        options, size, size * ensemble.getLanes(), [&] { ensemble.step(); },
+                        [&] { return ensemble.getLastComputeTime(); }) };
+                    result.backend = "cpu";
+                    result.variant = "ensemble x" + std::to_string(ensemble.getLanes()) + " " +
+                                     ensemble.getInstructionSet();
+                    result.threads = ensemble.getThreadCount();
+                    printResult(result);
+                    results.push_back(result);
+                } catch (const std::bad_alloc&) {
+                    std::cerr << "Skipping CPU ensemble " << size << "x" << size
+                              << ": out of memory\n";
+                }
+            }
+        }
+    }
+
+#ifdef USE_OPENCL
+    if (wants(options, "opencl")) {
+        ComputeManager computeManager{};
+        if (!computeManager.initialize(false)) {
+            std::cerr << "OpenCL unavailable, skipping GPU benchmarks\n";
+        } else {
+            for (const auto& kernelSpec : options.kernels) {
+                auto parts{ splitList(kernelSpec, ':') };
+                if (parts.size() != 2) {
+                    std::cerr << "Kernel variant must be file:name, got " << kernelSpec
+                              << '\n';
+                    continue;
+                }
+
+                for (int size : options.sizes) {
+                    try {
+                        Simulation simulation(size, size, &computeManager);
+                        simulation.setKernel(parts[0], parts[1]);
+                        if (!simulation.initialize()) { continue; }
+
+                        BenchResult result{ measure(
+                            options, size, size, [&] { simulation.step(); },
+                            [&] { return simulation.getLastComputeTime(); }) };
+                        result.backend = "opencl";
+                        result.variant = parts[1];
+                        result.threads = 0;
+                        printResult(result);
+                        results.push_back(result);
+                    } catch (const std::bad_alloc&) {
+                        std::cerr << "Skipping OpenCL " << size << "x" << size
+                                  << ": out of memory\n";
+                    }
+                }
+            }
+
+            // Cells and GB/s count every member; steps/s are ensemble steps
+            for (int size : options.sizes) {
+                if (options.ensembleMembers <= 0) { break; }
+                try {
+                    SimulationEnsemble ensemble(size, size, options.ensembleMembers,
+                                                &computeManager);
+                    if (!ensemble.initialize()) { continue; }
+
+                    BenchResult result{ measure(
+                        options, size, size * options.ensembleMembers, [&] { ensemble.step(); },
+                        [&] { return ensemble.getLastComputeTime(); }) };
+                    result.backend = "opencl";
+                    result.variant = "ensemble x" + std::to_string(options.ensembleMembers);
+                    result.threads = 0;
+                    printResult(result);
+                    results.push_back(result);
+                } catch (const std::bad_alloc&) {
+                    std::cerr << "Skipping ensemble " << size << "x" << size
+                              << ": out of memory\n";
+                }
+            }
+        }
+    }
+#else
+    if (wants(options, "opencl")) {
+        std::cerr << "Built without OpenCL, skipping GPU benchmarks\n";
+    }
+#endif
+
+    if (!options.ioDirectory.empty()) { benchmarkWrites(options); }
+    if (options.shmSeconds > 0.0) { benchmarkSharedMemory(options); }
+
+    bool ok{ true };
+    if (!options.jsonPath.empty()) { ok &= writeJson(options.jsonPath, results); }
+    if (!options.csvPath.empty()) { ok &= writeCsv(options.csvPath, results); }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace GreyScott {
+    // Page alignment satisfies O_DIRECT on every common block device
+    constexpr size_t kPageAlignment{ 4096 };
+
+    /**
+     * @brief std::allocator replacement handing out over-aligned storage
+     *
+     * Used for buffers that are written with direct I/O, which needs the
+     * memory (not only the file offset) aligned to the device block size.
+     */
+    template <typename T, size_t Alignment = kPageAlignment>
+    struct AlignedAllocator {
+        using value_type = T;
+
+        template <typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+        T* allocate(size_t count) {
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{ Alignment }));
+        }
+
+        void deallocate(T* pointer, size_t) {
+            ::operator delete(pointer, std::align_val_t{ Alignment });
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+    };
+
+} // namespace GreyScott
@@ -1,16 +1,39 @@
 #pragma once
 
+#include "Backend.hpp"
+#include "Backpressure.hpp"
+#include "ControlServer.hpp"
+#include "DisplayFormat.hpp"
+#include "FrameExporter.hpp"
+#include "IOMode.hpp"
+#include "MPSCQueue.hpp"
+#include "StepBudget.hpp"
 #include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace GreyScott {
 #ifdef USE_OPENCL
     class ComputeManager;
     class Simulation;
 #endif
+    class CheckpointWriter;
+    class FrameProfiler;
+    class GpuTimer;
     class Renderer;
     class SimulationCPU;
+#ifndef __APPLE__
+    class SimulationGL;
+#endif
+    class SharedFramePublisher;
+    class SimulationThread;
+    class TimeSeriesWriter;
+    struct CheckpointInfo;
+    struct SimulationFrame;
 
     class Application {
     public:
@@ -18,9 +41,67 @@ namespace GreyScott {
             const std::string windowTitle{ "Grey-Scott Simulation" };
             constexpr static int windowWidth{ 1024 };
             constexpr static int windowHeight{ 1024 };
-            constexpr static int gridWidth{ 512 };
-            constexpr static int gridHeight{ 512 };
             constexpr static bool vsync{ true };
+            constexpr static int maxStepsPerFrame{ 1000 };
+            // Longest idle sleep, a safety net should a wake-up get lost
+            constexpr static int idleWaitMs{ 250 };
+            // Lockstep frame period while the window is hidden, which takes
+            // vsync's place in pacing the steps
+            constexpr static int hiddenFrameMs{ 16 };
+
+            int gridWidth{ 512 };
+            int gridHeight{ 512 };
+            // Stream visible tiles even when the grid fits in one texture
+            // (always done beyond GL_MAX_TEXTURE_SIZE)
+            bool tiledView{ false };
+            // Step on a dedicated thread instead of in lockstep with rendering
+            bool simulationThread{ true };
+            // Steps per second for the simulation thread, 0 = unlimited
+            float targetStepRate{ 0.0f };
+            // Steps between displayed frames, 0 = fit the frame-time budget
+            int stepsPerFrame{ 1 };
+            // Engine to start with; GL compute needs the lockstep loop
+            Backend backend{ Backend::OpenCL };
+            // Texture format of the displayed channel
+            DisplayFormat displayFormat{ DisplayFormat::R16F };
+            // Checkpoint file for S/L and periodic saves
+            std::string checkpointPath{ "greyscott.ckpt" };
+            // Save a checkpoint every N steps, 0 = only on demand
+            uint64_t checkpointInterval{ 0 };
+            // Checkpoint to resume from; its grid size wins over gridWidth/Height
+            std::string restorePath{};
+            // Write a snapshot every N steps in the background, 0 = off
+            uint64_t snapshotInterval{ 0 };
+            // Snapshot files are <prefix>_<step>.ckpt
+            std::string snapshotPrefix{ "snapshot" };
+            int snapshotBuffers{ 4 };
+            int snapshotThreads{ 2 };
+            Backpressure snapshotBackpressure{ Backpressure::Throttle };
+            // Append snapshots to this compressed time series instead
+            std::string snapshotSeries{};
+            // Quantization error bound of the time series, 0 = lossless
+            float snapshotErrorBound{ 0.0f };
+            int snapshotKeyframeInterval{ 16 };
+            // Checkpoint and snapshot writes: page cache, or O_DIRECT with
+            // up to ioQueueDepth io_uring writes in flight
+            IOMode ioMode{ IOMode::Buffered };
+            int ioQueueDepth{ 32 };
+            // Record heat-map frames: a file prefix, or for Pipe an encoder
+            // command fed raw RGB24 frames; empty = off
+            std::string recordTarget{};
+            FrameFormat recordFormat{ FrameFormat::PNG };
+            uint64_t recordInterval{ 10 };
+            int recordBuffers{ 8 };
+            // 0 = half the hardware threads
+            int recordThreads{ 0 };
+            Backpressure recordBackpressure{ Backpressure::Block };
+            // Publish the field into this POSIX shared-memory ring for
+            // external readers (e.g. "/greyscott"); empty = off
+            std::string shmName{};
+            uint64_t shmInterval{ 1 };
+            int shmSlots{ 4 };
+            // Unix-domain socket taking scripted commands; empty = off
+            std::string controlSocket{};
         };
 
         explicit Application(const Config& config);
@@ -40,32 +121,97 @@ namespace GreyScott {
         bool initSDL();
         bool initOpenGL();
         void handleEvents();
+        bool isIdle() const;
         void update(float deltaTime);
         void render();
+        void exportTrace();
+        void exportCommandReport();
+
+        void runOnSimulation(std::function<void()> command);
+        static void wakeRenderThread();
+        void setPaused(bool paused);
+        bool runPendingCommands();
+        // Control requests: parsed on the server thread, run where the
+        // engines live, answered through the returned future
+        ControlServer::Reply handleControl(const std::vector<std::string>& words);
+        ControlServer::Reply runControl(std::function<std::string()> command);
+        void adjustParams(float deltaF, float deltaK);
+        template <typename Function>
+        void withActiveEngine(Function&& function);
+        bool isBackendAvailable(Backend backend) const;
+        void switchBackend(Backend target);
+        const float* readEngineState(Backend backend);
+        void writeEngineState(Backend backend, const float* state);
+        int chooseStepCount();
+        // 0 = as many steps as the stepping mode chooses
+        int stepActiveEngine(int steps = 0);
+        void publishFrame(SimulationFrame& frame);
+        void uploadField(const float* field);
+        void recordComputeTime(float computeTimeMs);
+        CheckpointInfo describeState();
+        void saveCheckpoint();
+        SnapshotWriter::FillFunction stateFill();
+        void captureSnapshot();
+        void captureFrame();
+        void publishSharedFrame();
+        bool loadCheckpoint(const std::string& path);
 
         Config m_config{};
         SDL_Window* m_window{};
         SDL_GLContext m_glContext{};
         bool m_running{};
         bool m_initialized{};
-        bool m_paused{};
+        std::atomic<bool> m_paused{};
+        bool m_windowVisible{ true };
+        // Frames to draw after input, so ImGui can settle before idling
+        int m_pendingRedraws{ 2 };
 
         uint64_t m_lastFrameTime{};
         int m_frameCount{};
         float m_fpsTimer{};
-        int m_currentFps{};
-        bool m_useCPU{};
+        std::atomic<int> m_currentFps{};
+        std::atomic<Backend> m_backend{ Backend::CPU };
+        bool m_frameReady{};
+        std::vector<uint8_t> m_displayData{};
 
         float m_computeTimeMs{};
         float m_avgComputeTimeMs{};
         int m_computeSamples{};
 
+        // Steps per frame (lockstep) or per published frame (threaded)
+        std::atomic<int> m_stepsPerFrame{ 1 };
+        std::atomic<bool> m_autoStepsPerFrame{};
+        std::atomic<int> m_lastStepCount{};
+        float m_stepCostMs{};
+        float m_framePeriodMs{ 1000.0f / 60.0f };
+        // Steps since the start (or the restored checkpoint)
+        std::atomic<uint64_t> m_stepCount{};
+
 #ifdef USE_OPENCL
         std::unique_ptr<ComputeManager> m_computeManager{};
         std::unique_ptr<Simulation> m_simulation{};
 #endif
+        std::unique_ptr<FrameProfiler> m_profiler{};
+        std::unique_ptr<GpuTimer> m_gpuTimer{};
+        std::unique_ptr<CheckpointWriter> m_checkpointWriter{};
+        std::unique_ptr<SnapshotWriter> m_snapshotWriter{};
+        std::unique_ptr<TimeSeriesWriter> m_timeSeries{};
+        std::unique_ptr<FrameExporter> m_frameExporter{};
+        // Toggled with V while a recording is configured
+        std::atomic<bool> m_recording{};
+        std::unique_ptr<SharedFramePublisher> m_sharedFrames{};
+        std::unique_ptr<ControlServer> m_controlServer{};
+        // Control requests for the render thread in lockstep mode
+        MPSCQueue<std::function<void()>> m_pendingCommands{};
+        // Lockstep "step N" requests; the simulation thread keeps its own
+        StepBudget m_stepBudget{};
+        std::atomic<uint64_t> m_pauseGeneration{};
         std::unique_ptr<Renderer> m_renderer{};
         std::unique_ptr<SimulationCPU> m_simulationCPU{};
+#ifndef __APPLE__
+        std::unique_ptr<SimulationGL> m_simulationGL{};
+#endif
+        std::unique_ptr<SimulationThread> m_simThread{};
     };
 
 } // namespace GreyScott
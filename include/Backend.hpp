@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace GreyScott {
+    // Simulation engine currently stepping the state
+    enum class Backend : uint8_t {
+        CPU,
+        OpenCL,
+        GLCompute,
+        Count
+    };
+
+    inline const char* backendName(Backend backend) {
+        switch (backend) {
+        case Backend::CPU: return "CPU (Serial)";
+        case Backend::OpenCL: return "GPU (OpenCL)";
+        case Backend::GLCompute: return "GPU (GL Compute)";
+        default: return "Unknown";
+        }
+    }
+
+} // namespace GreyScott
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace GreyScott {
+    // What the simulation does when every snapshot buffer is still queued
+    // or being written
+    enum class Backpressure : uint8_t {
+        Block,   // Wait for a writer to return a buffer (stalls stepping)
+        Drop,    // Skip this snapshot
+        Throttle // Skip it and double the snapshot interval until writers keep up
+    };
+
+    inline const char* backpressureName(Backpressure policy) {
+        switch (policy) {
+        case Backpressure::Block: return "block";
+        case Backpressure::Drop: return "drop";
+        case Backpressure::Throttle: return "throttle";
+        default: return "unknown";
+        }
+    }
+
+} // namespace GreyScott
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace GreyScott {
+    /**
+     * @brief Lock-free bounded multi-producer/multi-consumer queue
+     *
+     * Each cell carries a sequence number telling producers and consumers
+     * whose turn it is, so push and pop are a single compare-exchange on
+     * their index with no shared lock (Vyukov's bounded MPMC queue). The
+     * capacity is rounded up to a power of two; push fails when full and
+     * pop when empty, leaving the waiting policy to the caller.
+     */
+    template <typename T>
+    class BoundedQueue {
+    public:
+        explicit BoundedQueue(size_t capacity) {
+            size_t size{ 1 };
+            while (size < capacity) { size <<= 1; }
+            m_mask = size - 1;
+            m_cells = std::make_unique<Cell[]>(size);
+            for (size_t i{}; i < size; ++i) {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        bool push(const T& value) {
+            size_t position{ m_tail.load(std::memory_order_relaxed) };
+            for (;;) {
+                Cell& cell{ m_cells[position & m_mask] };
+                size_t sequence{ cell.sequence.load(std::memory_order_acquire) };
+                auto turn{ static_cast<ptrdiff_t>(sequence - position) };
+                if (turn == 0) {
+                    if (m_tail.compare_exchange_weak(position, position + 1,
+                                                     std::memory_order_relaxed)) {
+                        cell.value = value;
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (turn < 0) {
+                    return false; // Full
+                } else {
+                    position = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool pop(T& value) {
+            size_t position{ m_head.load(std::memory_order_relaxed) };
+            for (;;) {
+                Cell& cell{ m_cells[position & m_mask] };
+                size_t sequence{ cell.sequence.load(std::memory_order_acquire) };
+                auto turn{ static_cast<ptrdiff_t>(sequence - (position + 1)) };
+                if (turn == 0) {
+                    if (m_head.compare_exchange_weak(position, position + 1,
+                                                     std::memory_order_relaxed)) {
+                        value = cell.value;
+                        cell.sequence.store(position + m_mask + 1,
+                                            std::memory_order_release);
+                        return true;
+                    }
+                } else if (turn < 0) {
+                    return false; // Empty
+                } else {
+                    position = m_head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Approximate while other threads are pushing or popping
+        size_t size() const {
+            size_t tail{ m_tail.load(std::memory_order_acquire) };
+            size_t head{ m_head.load(std::memory_order_acquire) };
+            return tail > head ? tail - head : 0;
+        }
+        size_t capacity() const { return m_mask + 1; }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence{};
+            T value{};
+        };
+
+        std::unique_ptr<Cell[]> m_cells{};
+        size_t m_mask{};
+        // Separate lines so producers and consumers don't false-share
+        alignas(64) std::atomic<size_t> m_tail{};
+        alignas(64) std::atomic<size_t> m_head{};
+    };
+
+} // namespace GreyScott
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "AlignedAllocator.hpp"
+#include "FileWriter.hpp"
+#include "SimulationParams.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GreyScott {
+    // On-disk header, little-endian; the field follows at dataOffset, which
+    // is page-aligned so a mapping of the file hands out an aligned field
+    struct CheckpointHeader {
+        static constexpr char kMagic[8]{ 'G', 'S', 'C', 'K', 'P', 'T', '\0', '\0' };
+        static constexpr uint32_t kVersion{ 1 };
+        static constexpr uint32_t kDataAlignment{ 4096 };
+
+        enum class Layout : uint32_t {
+            InterleavedUV // Row-major (u, v) pairs
+        };
+
+        char magic[8]{};
+        uint32_t version{ kVersion };
+        uint32_t dataOffset{ kDataAlignment };
+        uint32_t width{};
+        uint32_t height{};
+        uint32_t channels{ 2 };
+        Layout layout{ Layout::InterleavedUV };
+        uint32_t bytesPerValue{ sizeof(float) };
+        uint32_t seed{};
+        uint64_t step{};
+        uint64_t dataBytes{};
+        SimulationParams params{};
+        uint32_t reserved[7]{};
+    };
+    static_assert(sizeof(CheckpointHeader) == 104, "Checkpoint header layout changed");
+
+    struct CheckpointInfo {
+        int width{};
+        int height{};
+        SimulationParams params{};
+        uint64_t step{};
+        uint32_t seed{};
+    };
+
+    // Writes synchronously, to `path`.tmp first and renamed once complete,
+    // so a crash mid-write never clobbers the previous checkpoint. A
+    // page-aligned field is written in place with direct I/O.
+    bool writeCheckpoint(const std::string& path, const CheckpointInfo& info,
+                         const float* field, const FileWriterOptions& io = {});
+
+    /**
+     * @brief Writes checkpoints on a background thread
+     *
+     * save() copies the field and returns; the copy is written while the
+     * simulation goes on. A save issued while the previous one is still
+     * being written waits for it first.
+     */
+    class CheckpointWriter {
+    public:
+        explicit CheckpointWriter(const FileWriterOptions& io = {}) : m_io{ io } {}
+        ~CheckpointWriter();
+
+        CheckpointWriter(const CheckpointWriter&) = delete;
+        CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+        void save(const std::string& path, const CheckpointInfo& info, const float* field);
+        void wait();
+        bool isBusy() const { return m_busy.load(std::memory_order_acquire); }
+
+    private:
+        FileWriterOptions m_io{};
+        std::thread m_thread{};
+        std::vector<float, AlignedAllocator<float>> m_field{};
+        std::atomic<bool> m_busy{};
+    };
+
+    /**
+     * @brief Read-only memory mapping of a checkpoint file
+     *
+     * The field is paged in on demand straight from the page cache, so
+     * handing it to syncFrom costs one copy instead of a read plus a copy.
+     * Falls back to reading the file where mmap is unavailable (Windows).
+     */
+    class MappedCheckpoint {
+    public:
+        MappedCheckpoint() = default;
+        ~MappedCheckpoint();
+
+        MappedCheckpoint(const MappedCheckpoint&) = delete;
+        MappedCheckpoint& operator=(const MappedCheckpoint&) = delete;
+
+        bool open(const std::string& path);
+        void close();
+
+        const CheckpointInfo& getInfo() const { return m_info; }
+        const float* getField() const { return m_field; }
+
+    private:
+        CheckpointInfo m_info{};
+        const float* m_field{};
+        void* m_mapping{};
+        size_t m_mappingSize{};
+        std::vector<float> m_buffer{};
+    };
+
+} // namespace GreyScott
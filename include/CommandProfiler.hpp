@@ -0,0 +1,103 @@
+#pragma once
+
+#ifdef USE_OPENCL
+
+#define CL_TARGET_OPENCL_VERSION 300
+#include <CL/cl.h>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace GreyScott {
+    enum class CommandKind {
+        Kernel,
+        DisplayKernel,
+        CopyToImage,
+        AcquireGL,
+        ReleaseGL,
+        ReadBuffer,
+        WriteBuffer,
+        MapBuffer,
+        UnmapBuffer,
+        Count
+    };
+
+    const char* commandKindName(CommandKind kind);
+
+    /**
+     * @brief Log2-bucketed latency histogram in microseconds
+     *
+     * Bucket 0 holds samples below 1 us, bucket i holds [2^(i-1), 2^i) us.
+     */
+    struct LatencyHistogram {
+        static constexpr int kBuckets{ 24 };
+
+        std::array<uint64_t, kBuckets> counts{};
+        uint64_t samples{};
+        double totalUs{};
+        double maxUs{};
+
+        void add(double us);
+        double mean() const { return samples ? totalUs / samples : 0.0; }
+        double percentile(double p) const;
+    };
+
+    struct CommandStats {
+        LatencyHistogram queued{};    // QUEUED -> SUBMIT
+        LatencyHistogram submitted{}; // SUBMIT -> START
+        LatencyHistogram executed{};  // START  -> END
+    };
+
+    /**
+     * @brief Aggregates OpenCL event timelines per enqueued command type
+     *
+     * Commands hand their event to track(); collect() harvests events that
+     * have completed without blocking, reads the QUEUED/SUBMIT/START/END
+     * timestamps and releases them.
+     *
+     * Everything but getSnapshot() belongs to the thread that enqueues the
+     * commands (the simulation thread, when there is one). collect() and
+     * reset() publish a copy of the statistics under a mutex, which other
+     * threads read with getSnapshot().
+     */
+    class CommandProfiler {
+    public:
+        using StatsArray = std::array<CommandStats, static_cast<size_t>(CommandKind::Count)>;
+
+        CommandProfiler() = default;
+        ~CommandProfiler();
+
+        CommandProfiler(const CommandProfiler&) = delete;
+        CommandProfiler& operator=(const CommandProfiler&) = delete;
+
+        void track(CommandKind kind, cl_event event);
+        void collect();
+        void reset();
+
+        const CommandStats& getStats(CommandKind kind) const {
+            return m_stats[static_cast<size_t>(kind)];
+        }
+        // Any thread: the statistics as of the last collect() or reset()
+        StatsArray getSnapshot() const;
+
+        bool writeReport(const std::string& filename) const;
+
+    private:
+        struct PendingEvent {
+            CommandKind kind{};
+            cl_event event{};
+        };
+
+        void publishSnapshot();
+
+        std::vector<PendingEvent> m_pending{};
+        StatsArray m_stats{};
+        mutable std::mutex m_snapshotMutex{};
+        StatsArray m_snapshot{};
+    };
+
+} // namespace GreyScott
+
+#endif // USE_OPENCL
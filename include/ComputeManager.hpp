@@ -7,6 +7,9 @@
 #include <string>
 #include <vector>
 
+// Same declaration as the GL headers, which this header doesn't pull in
+typedef struct __GLsync* GLsync;
+
 namespace GreyScott {
     struct DeviceInfo {
         std::string name{};
@@ -18,6 +21,8 @@ namespace GreyScott {
         cl_ulong globalMemSize{};
         cl_ulong localMemSize{};
         bool available{};
+        bool hostUnifiedMemory{};
+        bool fineGrainSVM{};
     };
 
     /**
@@ -29,6 +34,8 @@ namespace GreyScott {
      * - Context and command queue creation
      * - Kernel compilation and execution
      * - Memory buffer management
+     * - Detection of cl_khr_gl_event/GL_ARB_cl_event, so GL and CL can wait
+     *   on each other's fences instead of draining the queue
      */
     class ComputeManager {
     public:
@@ -38,7 +45,8 @@ namespace GreyScott {
         ComputeManager(const ComputeManager&) = delete;
         ComputeManager& operator=(const ComputeManager&) = delete;
 
-        bool initialize();
+        // deviceIndex follows queryDevices(); -1 picks the first GPU
+        bool initialize(bool enableGLInterop = true, int deviceIndex = -1);
         std::vector<DeviceInfo> queryDevices() const;
         void printDeviceInfo() const;
 
@@ -48,6 +56,10 @@ namespace GreyScott {
 
         bool isInitialized() const { return m_initialized; }
         bool hasGLInterop() const { return m_hasGLInterop; }
+        bool hasGLEventSync() const { return m_createEventFromGLsync != nullptr; }
+
+        // Wraps a GL fence in a CL event; requires hasGLEventSync()
+        cl_event createEventFromGLsync(GLsync sync) const;
 
         cl_kernel loadKernel(const std::string& filename,
                              const std::string& kernelName);
@@ -59,6 +71,7 @@ namespace GreyScott {
     private:
         DeviceInfo getDeviceInfo(cl_device_id device) const;
         bool checkGLInteropSupport() const;
+        void initGLEventSync();
 
         std::string getDeviceTypeString(cl_device_type type) const;
         std::string readKernelSource(const std::string& filename) const;
@@ -70,6 +83,10 @@ namespace GreyScott {
         cl_context m_context{};
         cl_command_queue m_queue{};
         DeviceInfo m_currentDeviceInfo{};
+
+        using CreateEventFromGLsyncFunction =
+            cl_event(CL_API_CALL*)(cl_context, GLsync, cl_int*);
+        CreateEventFromGLsyncFunction m_createEventFromGLsync{};
     };
 
 } // namespace GreyScott
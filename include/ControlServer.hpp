@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GreyScott {
+    /**
+     * @brief Line-based command interface on a Unix-domain socket
+     *
+     * This class handles:
+     * - Accepting any number of local clients on its own thread
+     * - Splitting requests into lines and lines into words
+     * - Passing each request to a handler, which returns a future so slow
+     *   commands (e.g. stepping) don't hold up other clients
+     * - Sending replies in request order, one line each
+     *
+     * The socket is created with owner-only permissions and removed on stop.
+     */
+    class ControlServer {
+    public:
+        using Reply = std::future<std::string>;
+        // Called on the server thread with the words of one request line
+        using Handler = std::function<Reply(const std::vector<std::string>& words)>;
+
+        ControlServer() = default;
+        ~ControlServer();
+
+        ControlServer(const ControlServer&) = delete;
+        ControlServer& operator=(const ControlServer&) = delete;
+
+        bool start(const std::string& path, Handler handler);
+        void stop();
+
+        // For handlers answering right away
+        static Reply ready(std::string reply);
+
+    private:
+        struct Client {
+            int fd{ -1 };
+            std::string input{};
+            std::string output{};
+            std::deque<Reply> pending{};
+            bool reading{ true }; // Until the client shuts down its side
+            bool open{ true };
+        };
+
+        void run();
+        bool readRequests(Client& client);
+        bool collectReplies(Client& client);
+        bool flushOutput(Client& client);
+
+        std::string m_path{};
+        Handler m_handler{};
+        std::thread m_thread{};
+        // Futures can't be copied, and deque's move may throw, so no vector
+        std::list<Client> m_clients{};
+        int m_listenFd{ -1 };
+        // Written by stop() to interrupt poll()
+        int m_wakeFds[2]{ -1, -1 };
+        std::atomic<bool> m_running{};
+    };
+
+} // namespace GreyScott
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace GreyScott {
+    /**
+     * @brief Texel format of the display texture
+     *
+     * The fragment shader only samples U, so the reduced formats carry just
+     * that channel: R16F halves it, R8 stores it normalized to [0, 255].
+     * RGBA8 is already colormapped, and the renderer just blits it.
+     */
+    enum class DisplayFormat : uint8_t {
+        RG32F, // Full U/V state, no conversion
+        R16F,
+        R8,
+        RGBA8 // Heat-map colors
+    };
+
+    inline const char* displayFormatName(DisplayFormat format) {
+        switch (format) {
+        case DisplayFormat::RG32F: return "RG32F";
+        case DisplayFormat::R16F: return "R16F";
+        case DisplayFormat::R8: return "R8";
+        case DisplayFormat::RGBA8: return "RGBA8";
+        default: return "Unknown";
+        }
+    }
+
+    inline size_t displayBytesPerTexel(DisplayFormat format) {
+        switch (format) {
+        case DisplayFormat::R16F: return 2;
+        case DisplayFormat::R8: return 1;
+        case DisplayFormat::RGBA8: return 4;
+        default: return 2 * sizeof(float);
+        }
+    }
+
+    // Converts the U channel of an interleaved (U, V) field of `cells` cells
+    // into `out`, which must hold cells * displayBytesPerTexel(format) bytes
+    void convertDisplayChannel(const float* field, size_t cells,
+                               DisplayFormat format, void* out);
+
+    // Heat-map colors of the U channel, as in RGBA8 but 3 bytes per cell
+    // (for image export)
+    void convertHeatMapRGB(const float* field, size_t cells, uint8_t* rgb);
+
+} // namespace GreyScott
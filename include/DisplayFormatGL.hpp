@@ -0,0 +1,25 @@
+#pragma once
+
+#include "DisplayFormat.hpp"
+#include <GL/glew.h>
+
+namespace GreyScott {
+    struct GLTextureFormat {
+        GLenum internalFormat;
+        GLenum format;
+        GLenum type;
+        const char* imageFormat; // GLSL image layout qualifier
+    };
+
+    // GL texture layout for each display format, shared by everything that
+    // creates or fills the display texture
+    inline GLTextureFormat glTextureFormat(DisplayFormat format) {
+        switch (format) {
+        case DisplayFormat::R16F: return { GL_R16F, GL_RED, GL_HALF_FLOAT, "r16f" };
+        case DisplayFormat::R8: return { GL_R8, GL_RED, GL_UNSIGNED_BYTE, "r8" };
+        case DisplayFormat::RGBA8: return { GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, "rgba8" };
+        default: return { GL_RG32F, GL_RG, GL_FLOAT, "rg32f" };
+        }
+    }
+
+} // namespace GreyScott
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "AlignedAllocator.hpp"
+#include "IOMode.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GreyScott {
+    struct FileWriterOptions {
+        IOMode mode{ IOMode::Buffered };
+        // Writes in flight at once with io_uring
+        int queueDepth{ 32 };
+        // Largest single write, and the size of each staging buffer
+        size_t chunkBytes{ size_t{ 1 } << 20 };
+        // Direct mode: false forces synchronous pwrite (for comparison)
+        bool useUring{ true };
+    };
+
+    /**
+     * @brief Sequential file writer with an optional direct I/O path
+     *
+     * This class handles:
+     * - Buffered writes with plain pwrite (stdio on Windows)
+     * - O_DIRECT writes, which bypass the page cache so large snapshot
+     *   volumes don't evict the simulation's memory or stall on writeback
+     * - Queueing direct writes through io_uring so several are in flight,
+     *   falling back to pwrite where io_uring is unavailable or blocked
+     * - Staging unaligned data in page-aligned buffers, and padding and
+     *   trimming the last block
+     *
+     * Page-aligned data is written in place: it must stay untouched until
+     * wait() or close(). Anything else is copied before write() returns.
+     */
+    class FileWriter {
+    public:
+        FileWriter();
+        ~FileWriter();
+
+        FileWriter(const FileWriter&) = delete;
+        FileWriter& operator=(const FileWriter&) = delete;
+
+        bool open(const std::string& path, const FileWriterOptions& options = {});
+        bool write(const void* data, size_t bytes);
+        // Blocks until everything written so far is in the file
+        bool wait();
+        // With `sync`, also waits for the data to reach the disk
+        bool close(bool sync = false);
+
+        bool isOpen() const;
+        uint64_t getSize() const { return m_size; }
+        // What open() got after falling back
+        bool usesDirect() const { return m_direct; }
+        bool usesUring() const { return m_ring != nullptr; }
+
+    private:
+        struct Ring;
+        using Buffer = std::vector<uint8_t, AlignedAllocator<uint8_t>>;
+
+        bool submit(const uint8_t* data, size_t bytes, int staging);
+        bool submitStaging(bool final);
+        bool reap(unsigned minimum);
+        bool writeAt(const uint8_t* data, size_t bytes, uint64_t offset);
+        int acquireStaging();
+
+        FileWriterOptions m_options{};
+        std::unique_ptr<Ring> m_ring{};
+        std::vector<Buffer> m_staging{};
+        std::vector<bool> m_stagingBusy{};
+        int m_current{ -1 }; // Staging buffer being filled
+        size_t m_fill{};
+        uint64_t m_size{};   // Bytes appended
+        uint64_t m_offset{}; // File offset of the next write
+        bool m_direct{};
+        bool m_failed{};
+        int m_fd{ -1 };
+#ifdef _WIN32
+        std::FILE* m_file{};
+#endif
+    };
+
+} // namespace GreyScott
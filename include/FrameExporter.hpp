@@ -0,0 +1,99 @@
+#pragma once
+
+#include "SnapshotWriter.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GreyScott {
+    enum class FrameFormat : uint8_t {
+        PNG,
+        PPM,
+        Pipe // Raw RGB24 frames on the stdin of an external encoder
+    };
+
+    inline const char* frameFormatName(FrameFormat format) {
+        switch (format) {
+        case FrameFormat::PNG: return "png";
+        case FrameFormat::PPM: return "ppm";
+        case FrameFormat::Pipe: return "pipe";
+        default: return "unknown";
+        }
+    }
+
+    struct FrameExportOptions {
+        FrameFormat format{ FrameFormat::PNG };
+        // PNG/PPM: files are <target>_<step>.png|ppm; Pipe: a shell command
+        // such as `ffmpeg -f rawvideo -pix_fmt rgb24 -s 512x512 -i - out.mp4`
+        std::string target{ "frame" };
+        // Steps between frames
+        uint64_t interval{ 10 };
+        // Fields in flight between the simulation and the encoders
+        int buffers{ 8 };
+        // Encoder threads, 0 = half the hardware threads; a pipe takes
+        // frames in order, so it always gets one
+        int threads{ 0 };
+        // Block keeps every frame of a movie; Drop/Throttle never stall stepping
+        Backpressure backpressure{ Backpressure::Block };
+        // PNG zlib level, 1 (fastest) to 9
+        int level{ 1 };
+        FileWriterOptions io{};
+    };
+
+    // 8-bit RGB PNG in one IDAT chunk; `level` is the zlib level, and
+    // without zlib the data is stored uncompressed
+    bool encodePNG(const uint8_t* rgb, int width, int height, int level,
+                   std::vector<uint8_t>& png);
+
+    /**
+     * @brief Records the heat-map view of the field as images or a video
+     *
+     * This class handles:
+     * - Capturing fields through a SnapshotWriter pool, so stepping only pays
+     *   for a copy (or an asynchronous readback) per frame
+     * - Applying the renderer's colormap on the encoder threads, with the
+     *   rows flipped to match the screen
+     * - Encoding PNG (or PPM) files on a pool of threads, several frames at a
+     *   time
+     * - Streaming frames in order through a pipe to an external encoder
+     */
+    class FrameExporter {
+    public:
+        FrameExporter() = default;
+        ~FrameExporter();
+
+        FrameExporter(const FrameExporter&) = delete;
+        FrameExporter& operator=(const FrameExporter&) = delete;
+
+        bool open(const FrameExportOptions& options, int width, int height);
+        // Writes the frames still queued, then closes the pipe; the totals
+        // stay readable
+        void close();
+
+        // Simulation thread, as for SnapshotWriter
+        bool isDue(uint64_t previous, uint64_t step) const;
+        bool capture(const CheckpointInfo& info, const SnapshotWriter::FillFunction& fill);
+
+        const FrameExportOptions& getOptions() const { return m_options; }
+        uint64_t getExported() const;
+        uint64_t getDropped() const;
+        size_t getQueued() const;
+
+    private:
+        bool writeFrame(const CheckpointInfo& info, const float* field);
+
+        FrameExportOptions m_options{};
+        int m_width{};
+        int m_height{};
+        std::unique_ptr<SnapshotWriter> m_writer{};
+        std::FILE* m_pipe{};
+        std::atomic<bool> m_pipeBroken{};
+        // Totals of the last recording, kept past close()
+        uint64_t m_exported{};
+        uint64_t m_dropped{};
+    };
+
+} // namespace GreyScott
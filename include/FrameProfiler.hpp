@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace GreyScott {
+    enum class FramePhase : uint8_t {
+        Events,
+        Step,
+        Readback,
+        Upload,
+        Render,
+        ImGui,
+        Swap,
+        // GPU execution time of the phases above, from timer queries
+        GpuUpload,
+        GpuRender,
+        GpuImGui,
+        Count
+    };
+
+    const char* framePhaseName(FramePhase phase);
+    // GPU phases overlap the CPU ones and are traced on their own track
+    inline bool isGpuPhase(FramePhase phase) { return phase >= FramePhase::GpuUpload; }
+
+    /**
+     * @brief Collects per-phase frame timings for profiling
+     *
+     * This class handles:
+     * - Recording timed phases from any thread into a fixed-size lock-free
+     *   ring buffer (the newest kCapacity events are kept)
+     * - Smoothed per-phase averages for the overlay
+     * - Exporting the ring as a Chrome/Perfetto JSON trace, with GPU phases
+     *   on a separate "GPU" track
+     */
+    class FrameProfiler {
+    public:
+        static constexpr size_t kCapacity{ 1 << 16 };
+
+        FrameProfiler();
+
+        FrameProfiler(const FrameProfiler&) = delete;
+        FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+        static uint64_t now();
+
+        void record(FramePhase phase, uint64_t startNs, uint64_t endNs);
+        float getAverageMs(FramePhase phase) const;
+
+        bool exportChromeTrace(const std::string& filename) const;
+
+    private:
+        struct Slot {
+            // 0 while a writer owns the slot, otherwise 1 + event index
+            std::atomic<uint64_t> sequence{};
+            std::atomic<uint64_t> startNs{};
+            std::atomic<uint64_t> durationNs{};
+            std::atomic<uint32_t> threadId{};
+            std::atomic<uint8_t> phase{};
+        };
+
+        static uint32_t currentThreadId();
+
+        std::unique_ptr<Slot[]> m_slots{};
+        std::atomic<uint64_t> m_head{};
+        std::array<std::atomic<float>, static_cast<size_t>(FramePhase::Count)>
+            m_averageMs{};
+        uint64_t m_epochNs{};
+    };
+
+    class ScopedTimer {
+    public:
+        ScopedTimer(FrameProfiler* profiler, FramePhase phase) :
+            m_profiler{ profiler },
+            m_phase{ phase },
+            m_startNs{ profiler ? FrameProfiler::now() : 0 }
+            {}
+
+        ~ScopedTimer() {
+            if (m_profiler) {
+                m_profiler->record(m_phase, m_startNs, FrameProfiler::now());
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        FrameProfiler* m_profiler{};
+        FramePhase m_phase{};
+        uint64_t m_startNs{};
+    };
+
+} // namespace GreyScott
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "FrameProfiler.hpp"
+#include <GL/glew.h>
+#include <array>
+#include <cstdint>
+
+namespace GreyScott {
+    /**
+     * @brief Measures GPU time of frame phases with GL_TIME_ELAPSED queries
+     *
+     * This class handles:
+     * - One query pair per GPU phase, used on alternate frames so results
+     *   are read a frame late instead of stalling the pipeline
+     * - Feeding the elapsed times to the FrameProfiler under the GPU phases,
+     *   anchored at the CPU time the work was issued
+     */
+    class GpuTimer {
+    public:
+        explicit GpuTimer(FrameProfiler* profiler);
+        ~GpuTimer();
+
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+
+        bool initialize();
+        bool isAvailable() const { return m_available; }
+
+        // Only one phase may be timed at a time (queries can't nest)
+        void begin(FramePhase phase);
+        void end();
+        // Once per frame, after the last end()
+        void endFrame();
+
+    private:
+        constexpr static int kPhases{ static_cast<int>(FramePhase::Count) -
+                                      static_cast<int>(FramePhase::GpuUpload) };
+
+        struct PhaseQueries {
+            GLuint queries[2]{};
+            uint64_t issuedNs[2]{};
+            bool pending[2]{};
+        };
+
+        void collect(int phase, int slot, bool wait);
+
+        FrameProfiler* m_profiler{};
+        std::array<PhaseQueries, kPhases> m_phases{};
+        int m_active{ -1 };
+        uint64_t m_frame{};
+        bool m_available{};
+    };
+
+    class ScopedGpuTimer {
+    public:
+        ScopedGpuTimer(GpuTimer* timer, FramePhase phase) :
+            m_timer{ timer && timer->isAvailable() ? timer : nullptr }
+            {
+                if (m_timer) { m_timer->begin(phase); }
+            }
+
+        ~ScopedGpuTimer() {
+            if (m_timer) { m_timer->end(); }
+        }
+
+        ScopedGpuTimer(const ScopedGpuTimer&) = delete;
+        ScopedGpuTimer& operator=(const ScopedGpuTimer&) = delete;
+
+    private:
+        GpuTimer* m_timer{};
+    };
+
+} // namespace GreyScott
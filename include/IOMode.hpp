@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace GreyScott {
+    // How checkpoints and snapshots reach the disk
+    enum class IOMode : uint8_t {
+        Buffered, // Through the page cache
+        Direct    // O_DIRECT, queued with io_uring where available
+    };
+
+    inline const char* ioModeName(IOMode mode) {
+        switch (mode) {
+        case IOMode::Buffered: return "buffered";
+        case IOMode::Direct: return "direct";
+        default: return "unknown";
+        }
+    }
+
+} // namespace GreyScott
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace GreyScott {
+    /**
+     * @brief Lock-free unbounded multi-producer/single-consumer queue
+     *
+     * Producers swap their node in as the new head with one atomic exchange
+     * and then link the previous head to it; the single consumer follows the
+     * links from the tail (Vyukov's non-intrusive MPSC queue). push never
+     * fails or waits. A node whose producer was preempted between the swap
+     * and the link is briefly invisible, so pop may report empty while a push
+     * is still completing; callers that park the consumer must notify it after
+     * push returns.
+     */
+    template <typename T>
+    class MPSCQueue {
+    public:
+        MPSCQueue() :
+            m_head{ new Node{} }
+        {
+            m_tail = m_head.load(std::memory_order_relaxed);
+        }
+
+        ~MPSCQueue() {
+            T value{};
+            while (pop(value)) {}
+            delete m_tail;
+        }
+
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+        // Any thread
+        void push(T value) {
+            auto* node{ new Node{} };
+            node->value = std::move(value);
+            Node* previous{ m_head.exchange(node, std::memory_order_acq_rel) };
+            previous->next.store(node, std::memory_order_release);
+        }
+
+        // Consumer thread only
+        bool pop(T& value) {
+            Node* next{ m_tail->next.load(std::memory_order_acquire) };
+            if (!next) { return false; }
+            value = std::move(next->value);
+            next->value = T{};
+            delete m_tail;
+            m_tail = next; // Becomes the new stub
+            return true;
+        }
+
+        bool empty() const { return m_tail->next.load(std::memory_order_acquire) == nullptr; }
+
+    private:
+        struct Node {
+            std::atomic<Node*> next{};
+            T value{};
+        };
+
+        // Separate lines so producers and the consumer don't false-share
+        alignas(64) std::atomic<Node*> m_head;
+        alignas(64) Node* m_tail{};
+    };
+
+} // namespace GreyScott
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "SimulationParams.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace GreyScott {
+    struct SweepOptions {
+        // Grid of (F, k) pairs, both ends included; F runs along the atlas
+        // rows (highest at the top) and k along the columns
+        float fMin{ 0.010f };
+        float fMax{ 0.070f };
+        int fCount{ 16 };
+        float kMin{ 0.040f };
+        float kMax{ 0.070f };
+        int kCount{ 16 };
+        // Du, Dv and dt of every member
+        SimulationParams base{};
+        // Side of each member's grid
+        int size{ 128 };
+        // Step budget per member
+        uint64_t maxSteps{ 10000 };
+        // Steps between steady-state checks
+        uint64_t checkInterval{ 500 };
+        // Steady once the RMS change of U per step drops below this; 0 always
+        // runs the whole budget
+        float tolerance{ 1e-6f };
+        // Every member starts from the same pattern, so tiles are comparable
+        uint32_t seed{ 1 };
+        // CPU workers, 0 = one per hardware thread
+        int threads{ 0 };
+        // Members each CPU worker steps at once in SIMD lanes, 8 or 16
+        // (SimulationCPUEnsemble); 0 = 16 with AVX-512, else 8
+        int lanes{ 0 };
+        // OpenCL devices (queryDevices() order) that take jobs next to the CPU
+        std::vector<int> devices{};
+        // Members each device steps at once, as one SimulationEnsemble
+        int deviceBatch{ 64 };
+    };
+
+    struct SweepResult {
+        float F{};
+        float k{};
+        uint64_t steps{};
+        bool steady{};
+        // RMS change of U per step over the last check
+        float change{};
+        float meanU{};
+        float stdU{};
+        float minU{};
+        float maxU{};
+        float meanV{};
+        float maxV{};
+        // Share of cells where V > 0.1, i.e. covered by the pattern
+        float coverage{};
+        float seconds{};
+        // -1 for the CPU, else the OpenCL device index
+        int device{ -1 };
+    };
+
+    // Coarse class of a finished member, written to the CSV's class column
+    const char* sweepClassName(const SweepResult& result);
+
+    /**
+     * @brief Maps pattern classes over a grid of (F, k) values
+     *
+     * This class handles:
+     * - Running one small, independent simulation per (F, k) pair, on every
+     *   core (8 or 16 pairs per core in SIMD lanes) and optionally on OpenCL
+     *   devices, which step a batch of pairs per launch
+     * - Balancing members that stop early at steady state against those that
+     *   run the whole budget, with a work-stealing job queue
+     * - Summary statistics of each member's final field
+     * - Writing the final fields as one heat-map atlas PNG and the statistics
+     *   as CSV
+     */
+    class ParameterSweep {
+    public:
+        ParameterSweep() = default;
+
+        ParameterSweep(const ParameterSweep&) = delete;
+        ParameterSweep& operator=(const ParameterSweep&) = delete;
+
+        // Blocks until every member is done, printing progress
+        bool run(const SweepOptions& options);
+
+        bool writeAtlas(const std::string& path, int level = 6) const;
+        bool writeCSV(const std::string& path) const;
+
+        const SweepOptions& getOptions() const { return m_options; }
+        // Row-major, F outer, from fMin/kMin up
+        const std::vector<SweepResult>& getResults() const { return m_results; }
+        int getAtlasWidth() const { return m_options.kCount * m_options.size; }
+        int getAtlasHeight() const { return m_options.fCount * m_options.size; }
+
+    private:
+        class JobQueue;
+
+        // How a worker drives its batch of members
+        struct BatchEngine {
+            // Loads the shared initial state into a member
+            std::function<bool(int member, const SimulationParams& params)> load{};
+            // Every member; false (as for the others) when the device failed
+            std::function<bool(int steps)> step{};
+            // Fields of members [0, count), back to back
+            std::function<bool(int count, float* stack)> read{};
+        };
+
+        SimulationParams startMember(int job, int device);
+        void runWorker(JobQueue& jobs, int worker, int device);
+        void runCPUWorker(JobQueue& jobs, int worker);
+        void runDeviceWorker(JobQueue& jobs, int worker, int device);
+        void runBatches(JobQueue& jobs, int worker, int device, int members,
+                        const BatchEngine& engine);
+        void finishMember(int job, const float* field, SweepResult& result);
+        float parameterAt(float low, float high, int count, int index) const;
+
+        SweepOptions m_options{};
+        std::vector<SweepResult> m_results{};
+        std::vector<float> m_initialState{};
+        std::vector<uint8_t> m_atlas{}; // RGB, top row first
+        std::atomic<int> m_completed{};
+        std::atomic<int> m_activeWorkers{};
+    };
+
+} // namespace GreyScott
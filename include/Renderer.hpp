@@ -1,16 +1,28 @@
 #pragma once
 
+#include "DisplayFormat.hpp"
 #include <GL/glew.h>
 // Note: GL/gl.h is included by glew.h
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace GreyScott {
     /**
      * @brief Handles OpenGL rendering of the simulation grid
      *
      * This class manages:
-     * - Texture creation for displaying simulation data
+     * - Texture creation for displaying simulation data, either the full
+     *   RG32F state or only the displayed channel as R16F/R8
      * - Shader programs for rendering
      * - Quad geometry for full-screen display
+     * - Asynchronous uploads through a ring of persistently mapped pixel
+     *   buffers (falls back to direct glTexSubImage2D without
+     *   ARB_buffer_storage, e.g. on macOS)
+     * - Zoom and pan over the grid
+     * - Tiled streaming for grids beyond GL_MAX_TEXTURE_SIZE: only the tiles
+     *   intersecting the view are uploaded, point-sampled at the level of
+     *   detail matching the screen, into a fixed-size LRU tile atlas
      */
     class Renderer {
     public:
@@ -23,19 +35,51 @@ namespace GreyScott {
 
         bool initialize();
         void setExternalTexture(GLuint externalTexture);
-        void updateTexture(const float* data);
-        void render();
+        // Stream visible tiles instead of keeping the whole grid on the GPU
+        void setTiledView(bool tiled);
+        bool usesTiledView() const { return m_tiled; }
+        void setDisplayFormat(DisplayFormat format);
+        DisplayFormat getDisplayFormat() const { return m_displayFormat; }
+        // Expects width * height texels in the display format; the tiled
+        // view reads them lazily, so they must stay valid until the next call
+        void updateTexture(const void* data);
+
+        // Direct access to the next upload slot, for producers on the GL
+        // thread that can write the grid in place; nullptr without PBOs
+        void* acquireUploadBuffer();
+        void commitUpload();
+        bool usesPersistentUpload() const { return m_persistentUpload; }
+        // Draws `texture` when given (same display format), else our own
+        void render(GLuint texture = 0);
         GLuint getTextureID() const { return m_texture; }
 
+        // View controls, in window coordinates normalized to [0, 1] with
+        // the origin at the bottom left
+        void zoomAt(float x, float y, float factor);
+        void pan(float dx, float dy);
+        void resetView();
+        float getZoom() const { return 1.0f / m_viewSize; }
+        int getViewLevel() const { return m_viewLevel; }
+        int getVisibleTiles() const { return m_visibleTiles; }
+        int getTileUploads() const { return m_tileUploads; }
+
     private:
         bool createShaders();
         bool createTexture();
         bool createQuad();
+        bool createUploadRing();
+        bool createTileAtlas();
+        void clampView();
+        void drawQuad(const float screenRect[4], const float texRect[4]);
+        void renderTiles();
+        int residentTile(int level, int tileX, int tileY);
+        void uploadTile(int slot, int level, int tileX, int tileY, int width, int height);
 
         int m_width{};
         int m_height{};
         bool m_initialized{};
         bool m_usingExternalTexture{};
+        DisplayFormat m_displayFormat{ DisplayFormat::RG32F };
 
         // OpenGL resources
         GLuint m_texture{};
@@ -44,6 +88,46 @@ namespace GreyScott {
         GLuint m_shaderProgram{};
         GLuint m_vertexShader{};
         GLuint m_fragmentShader{};
+        GLint m_screenRectLocation{ -1 };
+        GLint m_texRectLocation{ -1 };
+
+        // Visible part of the grid, normalized to [0, 1]
+        float m_viewX{};
+        float m_viewY{};
+        float m_viewSize{ 1.0f };
+
+        // Persistent-mapped PBO ring: the CPU fills one slot while the GPU
+        // may still be sourcing the others; fences guard reuse
+        struct UploadSlot {
+            GLuint buffer{};
+            void* mapped{};
+            GLsync fence{};
+        };
+        constexpr static int kUploadSlots{ 3 };
+        UploadSlot m_uploadSlots[kUploadSlots]{};
+        int m_uploadIndex{};
+        bool m_persistentUpload{};
+        bool m_uploadAcquired{};
+
+        // Tiled view: atlas slots hold (level, x, y) tiles, refreshed when
+        // the source changed and evicted least recently used first
+        struct TileSlot {
+            uint64_t key{ UINT64_MAX };
+            uint64_t version{};
+            uint64_t lastUsed{};
+        };
+        constexpr static int kTileSize{ 256 };
+        constexpr static int kAtlasTiles{ 8 }; // Per side
+        bool m_tiled{};
+        const uint8_t* m_tileSource{};
+        uint64_t m_sourceVersion{};
+        uint64_t m_frameIndex{};
+        std::vector<TileSlot> m_tileSlots{};
+        std::unordered_map<uint64_t, int> m_tileLookup{};
+        std::vector<uint8_t> m_tileStaging{};
+        int m_viewLevel{};
+        int m_visibleTiles{};
+        int m_tileUploads{};
     };
 
 } // namespace GreyScott
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GreyScott {
+    /**
+     * @brief Persistent threads that split a grid's rows into bands
+     *
+     * This class handles:
+     * - Keeping threadCount - 1 helper threads parked between steps, so a
+     *   step costs a wake-up instead of a thread spawn and join
+     * - Running one task over equal row bands, the caller thread taking the
+     *   last one, and returning once every band is done
+     *
+     * Used by SimulationCPU and SimulationCPUEnsemble. run() must be called
+     * by one thread at a time.
+     */
+    class RowWorkerPool {
+    public:
+        using Task = std::function<void(int yBegin, int yEnd)>;
+
+        RowWorkerPool() = default;
+        ~RowWorkerPool();
+
+        RowWorkerPool(const RowWorkerPool&) = delete;
+        RowWorkerPool& operator=(const RowWorkerPool&) = delete;
+
+        // Threads including the caller; restarts the helpers if it changes
+        void setThreadCount(int threads);
+        int getThreadCount() const { return m_threadCount; }
+
+        void run(int rows, const Task& task);
+
+    private:
+        void workerLoop(int band, uint64_t seen);
+        void stopWorkers();
+
+        std::vector<std::thread> m_workers{};
+        std::mutex m_mutex{};
+        std::condition_variable m_start{};
+        std::condition_variable m_done{};
+        const Task* m_task{};
+        int m_threadCount{ 1 };
+        int m_rows{};
+        int m_pending{};
+        uint64_t m_generation{};
+        bool m_stopping{};
+    };
+
+} // namespace GreyScott
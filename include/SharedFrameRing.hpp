@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Checkpoint.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace GreyScott {
+    // Shared-memory layout: one page holding SharedRingHeader, then
+    // slotCount slots of slotStride bytes. Each slot starts with a page
+    // holding its SharedSlotHeader, followed by the interleaved (U, V)
+    // field, so the field is page-aligned too. Only the publisher writes.
+    struct SharedRingHeader {
+        static constexpr char kMagic[8]{ 'G', 'S', 'S', 'H', 'R', 'I', 'N', 'G' };
+        static constexpr uint32_t kVersion{ 1 };
+
+        char magic[8]{};
+        // Stored last, so a reader seeing kVersion sees the whole header
+        std::atomic<uint32_t> version{};
+        uint32_t slotCount{};
+        uint32_t width{};
+        uint32_t height{};
+        uint32_t channels{ 2 };
+        uint32_t reserved0{};
+        uint64_t slotStride{};
+        // Frames published so far; the newest is in slot (published - 1) % slotCount
+        std::atomic<uint64_t> published{};
+        uint64_t reserved[3]{};
+    };
+    static_assert(sizeof(SharedRingHeader) == 72, "Shared ring header layout changed");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "Shared-memory atomics must be lock-free to work across processes");
+
+    struct SharedSlotHeader {
+        // Seqlock: odd while the publisher writes the slot, and bumped by 2
+        // per frame, so an unchanged even value means an untorn read
+        std::atomic<uint64_t> sequence{};
+        uint64_t frame{}; // Publish index
+        uint64_t step{};
+        SimulationParams params{};
+        uint32_t seed{};
+        uint32_t reserved[6]{};
+    };
+    static_assert(sizeof(SharedSlotHeader) == 72, "Shared slot header layout changed");
+
+    /**
+     * @brief Publishes fields into a POSIX shared-memory ring
+     *
+     * This class handles:
+     * - Creating and sizing the named segment (replacing a stale one) and
+     *   unlinking it on close
+     * - Writing each frame into the next slot under its seqlock, so readers
+     *   never block the publisher and detect frames overwritten mid-read
+     * - Letting the caller fill the slot in place, e.g. by a device readback
+     *   straight into the mapping
+     */
+    class SharedFramePublisher {
+    public:
+        // Writes width * height * 2 floats into the slot
+        using FillFunction = std::function<void(float* field)>;
+
+        SharedFramePublisher() = default;
+        ~SharedFramePublisher();
+
+        SharedFramePublisher(const SharedFramePublisher&) = delete;
+        SharedFramePublisher& operator=(const SharedFramePublisher&) = delete;
+
+        // `name` as for shm_open, e.g. "/greyscott"
+        bool open(const std::string& name, int width, int height, int slots = 4);
+        void close();
+        bool isOpen() const { return m_header != nullptr; }
+
+        void publish(const CheckpointInfo& info, const FillFunction& fill);
+
+        uint64_t getPublished() const { return m_published; }
+        const std::string& getName() const { return m_name; }
+
+    private:
+        std::string m_name{};
+        void* m_map{};
+        size_t m_mapBytes{};
+        SharedRingHeader* m_header{};
+        uint64_t m_published{};
+    };
+
+    // A frame read in place from the ring; the pointers stay valid, but the
+    // data is only known to be consistent once validate() returns true
+    struct SharedFrameView {
+        const float* field{};
+        CheckpointInfo info{};
+        uint64_t frame{};
+        uint64_t sequence{};
+        uint32_t slot{};
+    };
+
+    /**
+     * @brief Maps a ring created by SharedFramePublisher, read-only
+     *
+     * acquire() hands out the newest frame without copying it; process it in
+     * place and then call validate(), which fails if the publisher came back
+     * around to the slot meanwhile (more slots give readers more time).
+     * readLatest() copies instead and retries until it gets a clean frame.
+     */
+    class SharedFrameReader {
+    public:
+        SharedFrameReader() = default;
+        ~SharedFrameReader();
+
+        SharedFrameReader(const SharedFrameReader&) = delete;
+        SharedFrameReader& operator=(const SharedFrameReader&) = delete;
+
+        bool open(const std::string& name);
+        void close();
+
+        const SharedRingHeader& getHeader() const { return *m_header; }
+        uint64_t getPublished() const;
+
+        // False while nothing has been published
+        bool acquire(SharedFrameView& view) const;
+        bool validate(const SharedFrameView& view) const;
+        // `field` holds width * height * 2 floats; `info` may be null
+        bool readLatest(float* field, CheckpointInfo* info = nullptr) const;
+
+    private:
+        const SharedSlotHeader& slotHeader(uint32_t slot) const;
+
+        const void* m_map{};
+        size_t m_mapBytes{};
+        const SharedRingHeader* m_header{};
+    };
+
+} // namespace GreyScott
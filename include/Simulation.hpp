@@ -2,8 +2,12 @@
 
 #ifdef USE_OPENCL
 
+#include "CommandProfiler.hpp"
 #include "ComputeManager.hpp"
+#include "DisplayFormat.hpp"
 #include "SimulationParams.hpp"
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace GreyScott {
@@ -16,7 +20,16 @@ namespace GreyScott {
      * - Kernel execution for each simulation step
      * - Initial conditions and state reset
      * - Parameter management (F, k, Du, Dv, dt)
-     * - Data readback for visualization
+     * - Data readback for visualization (explicit, via forceReadBack, so
+     *   callers can batch steps and time transfers separately)
+     * - Conversion of the displayed channel to R16F/R8/RGBA8 on the device,
+     *   for both the interop texture and readback; with RGBA8 interop the
+     *   last step of a batch colormaps straight into the texture
+     * - Fence-based hand-off of the interop texture when cl_khr_gl_event is
+     *   available: GL waits on the release (waitForDisplay) while CL keeps
+     *   queuing, and kernel times are reported one batch late
+     * - Zero-copy host access to the state for the CPU engine, backed by
+     *   fine-grained SVM when available and mapped buffers otherwise
      */
     class Simulation {
     public:
@@ -26,20 +39,36 @@ namespace GreyScott {
         Simulation(const Simulation&) = delete;
         Simulation& operator=(const Simulation&) = delete;
 
+        void setKernel(const std::string& filename, const std::string& kernelName);
+        void setDisplayFormat(DisplayFormat format);
+        DisplayFormat getDisplayFormat() const { return m_displayFormat; }
         bool initialize();
-        void step();
+        void step(int iterations = 1);
         void reset();
+        void setSeed(uint32_t seed) { m_seed = seed; }
+        uint32_t getSeed() const { return m_seed; }
         void syncFrom(const float* data);
         void forceReadBack();
+        // Enqueues a copy of the current state into `out` without waiting;
+        // `out` is valid once `done` completes (caller releases it)
+        bool readStateAsync(float* out, cl_event* done);
+        bool readDisplay(void* out);
 
-        const float* getData() const { return m_hostData.data(); }
+        bool mapHostState(float*& current, float*& next);
+        void unmapHostState(const float* current);
+        bool usesSVM() const { return m_svmCurrent && m_svmNext; }
+
+        const float* getData() const;
         const SimulationParams& getParams() const { return m_params; }
         unsigned int getSharedTexture() const { return m_sharedTexture; }
         bool usesGLInterop() const { return m_useGLInterop; }
+        // GL thread: makes the GL server wait for the last texture update
+        void waitForDisplay();
 
         void setParams(const SimulationParams& params) { m_params = params; }
         void loadPreset(int presetIndex);
         float getLastComputeTime() const { return m_lastComputeTime; }
+        CommandProfiler& getCommandProfiler() { return m_commandProfiler; }
 
         int getWidth() const { return m_width; }
         int getHeight() const { return m_height; }
@@ -47,6 +76,12 @@ namespace GreyScott {
     private:
         void initializeState();
         void createBuffers();
+        cl_mem createStateBuffer(void*& svmPtr, cl_int* err);
+        bool setStepArguments(cl_kernel kernel);
+        bool acquireSharedTexture();
+        void releaseSharedTexture();
+        void copyToSharedTexture(cl_mem source);
+        bool convertDisplay(cl_mem source);
         void readBackData();
 
         int m_width{};
@@ -58,15 +93,33 @@ namespace GreyScott {
         cl_mem m_clImageCurrent{};
         cl_mem m_clImageNext{};
         bool m_useGLInterop{};
+        GLsync m_displaySync{}; // Signaled by the last release
+        std::vector<cl_event> m_pendingKernelEvents{};
 
         cl_mem m_bufferCurrent{};
         cl_mem m_bufferNext{};
-        
+
+        bool m_useSVM{};
+        void* m_svmCurrent{};
+        void* m_svmNext{};
+        bool m_hostMapped{};
+        float* m_mappedCurrent{};
+        float* m_mappedNext{};
+
         cl_kernel m_kernel{};
+        std::string m_kernelFile{ "kernels/grey_scott.cl" };
+        std::string m_kernelName{ "grey_scott_step" };
+
+        DisplayFormat m_displayFormat{ DisplayFormat::RG32F };
+        cl_kernel m_displayKernel{};
+        cl_kernel m_fusedKernel{};
+        cl_mem m_displayBuffer{};
 
+        CommandProfiler m_commandProfiler{};
         std::vector<float> m_hostData{};
         bool m_initialized{};
         float m_lastComputeTime{};
+        uint32_t m_seed{};
     };
 
 } // namespace GreyScott
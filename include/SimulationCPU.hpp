@@ -1,6 +1,8 @@
 #pragma once
 
+#include "RowWorkerPool.hpp"
 #include "SimulationParams.hpp"
+#include <cstdint>
 #include <vector>
 
 namespace GreyScott {
@@ -13,28 +15,43 @@ namespace GreyScott {
         SimulationCPU& operator=(const SimulationCPU&) = delete;
 
         void initialize();
-        void step(const SimulationParams& params);
+        void step(const SimulationParams& params, int iterations = 1);
+        void step(int iterations) { step(m_params, iterations); }
         void reset();
+        void setSeed(uint32_t seed) { m_seed = seed; }
+        uint32_t getSeed() const { return m_seed; }
         void syncFrom(const float* data);
+        void attachStorage(float* current, float* next);
+        void detachStorage();
+        bool hasExternalStorage() const { return m_externalStorage; }
 
-        const float* getData() const { return m_data.data(); }
+        const float* getData() const { return m_current; }
         const SimulationParams& getParams() const { return m_params; }
         void setParams(const SimulationParams& params) { m_params = params; }
         void loadPreset(int presetIndex);
         float getLastComputeTime() const { return m_lastComputeTime; }
+        void setThreadCount(int threads);
+        int getThreadCount() const { return m_threadCount; }
         int getWidth() const { return m_width; }
         int getHeight() const { return m_height; }
 
     private:
         void initializeState();
-        float computeLaplacian(const std::vector<float>& field, int x, int y, int component);
+        void stepRows(const SimulationParams& params, int yBegin, int yEnd);
+        float computeLaplacian(const float* field, int x, int y, int component);
 
         int m_width{};
         int m_height{};
         std::vector<float> m_data{};
         std::vector<float> m_dataNext{};
+        float* m_current{};
+        float* m_next{};
+        bool m_externalStorage{};
         SimulationParams m_params{};
         float m_lastComputeTime{};
+        uint32_t m_seed{};
+        int m_threadCount{ 1 };
+        RowWorkerPool m_workers{};
     };
 
 } // namespace GreyScott
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "AlignedAllocator.hpp"
+#include "RowWorkerPool.hpp"
+#include "SimulationParams.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace GreyScott {
+    /**
+     * @brief 8 or 16 independent CPU simulations stepped together, one per
+     * SIMD lane
+     *
+     * This class handles:
+     * - A lane-interleaved layout: each cell holds U of every member, then V
+     *   of every member, so one vector load fetches a cell of all members
+     * - Stepping all members with one AVX-512 (16 lanes) or AVX2 (8 lanes
+     *   per register) stencil, picked at run time, with a scalar fallback
+     * - Per-member parameters and seeds, so members can differ in (F, k),
+     *   diffusion rates or initial pattern
+     * - Loading and extracting any member's field in SimulationCPU's
+     *   interleaved U,V layout
+     * - Splitting rows over a RowWorkerPool, as SimulationCPU does
+     *
+     * Every member goes through the same operations in the same order as
+     * SimulationCPU (no FMA contraction), so an extracted member matches a
+     * SimulationCPU run with the same seed and parameters bit for bit.
+     */
+    class SimulationCPUEnsemble {
+    public:
+        // lanes: 8 or 16; 0 picks 16 where AVX-512 is available, else 8
+        SimulationCPUEnsemble(int width, int height, int lanes = 0);
+        ~SimulationCPUEnsemble() = default;
+
+        SimulationCPUEnsemble(const SimulationCPUEnsemble&) = delete;
+        SimulationCPUEnsemble& operator=(const SimulationCPUEnsemble&) = delete;
+
+        // Every member from SimulationCPU's pattern for its own seed
+        void initialize();
+        void step(int iterations = 1);
+
+        void setParams(int member, const SimulationParams& params);
+        SimulationParams getParams(int member) const;
+        void setSeed(int member, uint32_t seed) { m_seeds[member] = seed; }
+        uint32_t getSeed(int member) const { return m_seeds[member]; }
+
+        // Interleaved U,V of one member (width * height * 2 floats)
+        void loadMember(int member, const float* data);
+        void extractMember(int member, float* out) const;
+
+        void setThreadCount(int threads);
+        int getThreadCount() const { return m_threadCount; }
+        int getLanes() const { return m_lanes; }
+        int getWidth() const { return m_width; }
+        int getHeight() const { return m_height; }
+        // "avx512", "avx2" or "scalar"
+        const char* getInstructionSet() const;
+        // Mean time per step of the last batch, for all members
+        float getLastComputeTime() const { return m_lastComputeTime; }
+
+    private:
+        using Buffer = std::vector<float, AlignedAllocator<float, 64>>;
+
+        void stepRows(int yBegin, int yEnd);
+
+        int m_width{};
+        int m_height{};
+        int m_lanes{};
+        Buffer m_data{};
+        Buffer m_dataNext{};
+        float* m_current{};
+        float* m_next{};
+        // Du, Dv, F, k and dt, each for every lane
+        Buffer m_laneParams{};
+        std::vector<uint32_t> m_seeds{};
+        int m_threadCount{ 1 };
+        RowWorkerPool m_workers{};
+        float m_lastComputeTime{};
+    };
+
+} // namespace GreyScott
@@ -0,0 +1,88 @@
+#pragma once
+
+#ifdef USE_OPENCL
+
+#include "ComputeManager.hpp"
+#include "SimulationParams.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace GreyScott {
+    /**
+     * @brief Many independent small Grey-Scott simulations stepped together
+     * on an OpenCL device
+     *
+     * This class handles:
+     * - One pair of state buffers holding every member's grid back to back,
+     *   instead of a buffer pair and a launch per simulation
+     * - A parameter buffer with one SimulationParams entry per member,
+     *   uploaded again only after a change
+     * - Stepping the whole ensemble with one 3D launch per step, so even
+     *   128x128 members fill the device
+     * - Loading and reading back single members or the whole stack
+     *
+     * All members share the grid size and the step count; members that are
+     * done can be left running or reloaded with new work.
+     */
+    class SimulationEnsemble {
+    public:
+        SimulationEnsemble(int width, int height, int members,
+                           ComputeManager* computeManager);
+        ~SimulationEnsemble();
+
+        SimulationEnsemble(const SimulationEnsemble&) = delete;
+        SimulationEnsemble& operator=(const SimulationEnsemble&) = delete;
+
+        // Variants must keep grey_scott_ensemble_step's argument list
+        void setKernel(const std::string& filename, const std::string& kernelName);
+        // Every member starts from the same seeded pattern
+        bool initialize();
+        // False when a launch or the device failed; the state is then undefined
+        bool step(int iterations = 1);
+
+        void setSeed(uint32_t seed) { m_seed = seed; }
+        uint32_t getSeed() const { return m_seed; }
+        void setParams(int member, const SimulationParams& params);
+        const SimulationParams& getParams(int member) const { return m_params[member]; }
+
+        // Interleaved U,V of one member (width * height * 2 floats)
+        bool loadMember(int member, const float* data);
+        bool readMember(int member, float* out) const;
+        // Every member, back to back
+        bool readAll(float* out) const;
+
+        int getWidth() const { return m_width; }
+        int getHeight() const { return m_height; }
+        int getMemberCount() const { return m_members; }
+        // Mean kernel time per step of the last batch, for the whole ensemble
+        float getLastComputeTime() const { return m_lastComputeTime; }
+
+    private:
+        size_t memberBytes() const;
+        bool uploadParams();
+
+        int m_width{};
+        int m_height{};
+        int m_members{};
+        ComputeManager* m_computeManager{};
+
+        std::vector<SimulationParams> m_params{};
+        bool m_paramsDirty{ true };
+
+        cl_mem m_bufferCurrent{};
+        cl_mem m_bufferNext{};
+        cl_mem m_paramsBuffer{};
+
+        cl_kernel m_kernel{};
+        std::string m_kernelFile{ "kernels/grey_scott.cl" };
+        std::string m_kernelName{ "grey_scott_ensemble_step" };
+
+        bool m_initialized{};
+        float m_lastComputeTime{};
+        uint32_t m_seed{};
+    };
+
+} // namespace GreyScott
+
+#endif // USE_OPENCL
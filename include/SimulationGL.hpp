@@ -0,0 +1,84 @@
+#pragma once
+
+#ifndef __APPLE__
+
+#include "DisplayFormat.hpp"
+#include "SimulationParams.hpp"
+#include <GL/glew.h>
+#include <cstdint>
+#include <vector>
+
+namespace GreyScott {
+    /**
+     * @brief Grey-Scott simulation as an OpenGL compute shader
+     *
+     * This class handles:
+     * - SSBO ping-pong of the interleaved (U, V) state, same layout as the
+     *   other engines so state can be moved between them as-is
+     * - Writing the last step of each batch into a display texture in the
+     *   renderer's format, which is then sampled without any cross-API sync;
+     *   uploaded states (reset, syncFrom) are written to it as well
+     * - Kernel timing through double-buffered GL_TIME_ELAPSED queries
+     *
+     * Needs a current GL 4.3+ context (compute shaders), so it can only be
+     * stepped from the thread that owns the context. Not available on macOS.
+     */
+    class SimulationGL {
+    public:
+        SimulationGL(int width, int height);
+        ~SimulationGL();
+
+        SimulationGL(const SimulationGL&) = delete;
+        SimulationGL& operator=(const SimulationGL&) = delete;
+
+        void setDisplayFormat(DisplayFormat format);
+        bool initialize();
+        void step(int iterations = 1);
+        void reset();
+        void setSeed(uint32_t seed) { m_seed = seed; }
+        uint32_t getSeed() const { return m_seed; }
+        void syncFrom(const float* data);
+        void forceReadBack();
+
+        const float* getData() const { return m_hostData.data(); }
+        const SimulationParams& getParams() const { return m_params; }
+        void setParams(const SimulationParams& params) { m_params = params; }
+        void loadPreset(int presetIndex);
+        float getLastComputeTime() const { return m_lastComputeTime; }
+        GLuint getDisplayTexture() const { return m_displayTexture; }
+        DisplayFormat getDisplayFormat() const { return m_displayFormat; }
+
+        int getWidth() const { return m_width; }
+        int getHeight() const { return m_height; }
+
+    private:
+        bool createProgram();
+        void initializeState();
+        // Display texture from the current state, without stepping
+        void writeDisplay();
+        void collectTiming();
+
+        int m_width{};
+        int m_height{};
+        SimulationParams m_params{};
+        DisplayFormat m_displayFormat{ DisplayFormat::RG32F };
+
+        GLuint m_program{};
+        GLuint m_bufferCurrent{};
+        GLuint m_bufferNext{};
+        GLuint m_displayTexture{};
+
+        // Two queries so the previous batch can be read without stalling
+        GLuint m_timerQueries[2]{};
+        int m_timerSteps[2]{};
+        int m_timerIndex{};
+
+        std::vector<float> m_hostData{};
+        bool m_initialized{};
+        float m_lastComputeTime{};
+        uint32_t m_seed{};
+    };
+
+} // namespace GreyScott
+
+#endif // __APPLE__
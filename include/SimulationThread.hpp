@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Backend.hpp"
+#include "MPSCQueue.hpp"
+#include "SimulationParams.hpp"
+#include "StepBudget.hpp"
+#include "TripleBuffer.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GreyScott {
+    struct SimulationFrame {
+        std::vector<uint8_t> display{}; // Displayed texels in the display format
+        SimulationParams params{};
+        uint64_t step{};
+        float computeTimeMs{};
+        Backend backend{};
+    };
+
+    /**
+     * @brief Runs the simulation on its own thread, decoupled from rendering
+     *
+     * This class handles:
+     * - Stepping the active engine in batches, as fast as possible or at a
+     *   target rate
+     * - Publishing completed states to the render thread through a
+     *   lock-free triple buffer (only when the previous one was picked up)
+     * - Running commands posted from any thread (parameter changes,
+     *   resets, engine switches, control requests) between steps; they pass
+     *   through a lock-free queue, the mutex only parks the thread
+     * - Taking a requested number of steps, paused or not, in batches
+     *   between commands and publishes
+     * - Notifying the render thread after each publish, so it can sleep
+     *   while nothing new arrives
+     */
+    class SimulationThread {
+    public:
+        // Takes `steps` steps, or as many as it sees fit for 0; returns the
+        // number taken
+        using StepFunction = std::function<int(int steps)>;
+        using PublishFunction = std::function<void(SimulationFrame&)>;
+        using Command = std::function<void()>;
+        // Called on the simulation thread after a frame was published
+        using NotifyFunction = std::function<void()>;
+
+        SimulationThread(StepFunction step, PublishFunction publish,
+                         NotifyFunction published = {});
+        ~SimulationThread();
+
+        SimulationThread(const SimulationThread&) = delete;
+        SimulationThread& operator=(const SimulationThread&) = delete;
+
+        void start();
+        void stop();
+
+        // Any thread
+        void post(Command command);
+        void setPaused(bool paused);
+        void setTargetRate(float stepsPerSecond);
+        // Takes `steps` more steps in batches of at most `batch`, paused or
+        // not. `done` runs on the simulation thread, with false when
+        // setPaused(), a newer stepBy() or stop() comes first
+        void stepBy(uint64_t steps, int batch, StepBudget::Done done);
+
+        // Render thread: swaps in the newest frame if one was published
+        bool acquireLatest() { return m_frames.update(); }
+        const SimulationFrame& latest() const { return m_frames.front(); }
+        bool hasNewFrame() const { return !m_frames.consumed(); }
+
+        uint64_t getStepCount() const { return m_stepCount.load(std::memory_order_relaxed); }
+        // e.g. when a checkpoint is restored
+        void setStepCount(uint64_t step) { m_stepCount.store(step, std::memory_order_relaxed); }
+        float getStepsPerSecond() const { return m_stepsPerSecond.load(std::memory_order_relaxed); }
+
+    private:
+        void run();
+        bool runCommands();
+
+        StepFunction m_step{};
+        PublishFunction m_publish{};
+        NotifyFunction m_published{};
+        TripleBuffer<SimulationFrame> m_frames{};
+
+        std::thread m_thread{};
+        std::mutex m_mutex{};
+        std::condition_variable m_wake{};
+        MPSCQueue<Command> m_commands{};
+        bool m_running{};
+        bool m_paused{};
+        float m_targetRate{};
+        // Bumped by setPaused(); a budget started before a change is dropped
+        std::atomic<uint64_t> m_pauseGeneration{};
+        StepBudget m_budget{};
+
+        std::atomic<uint64_t> m_stepCount{};
+        std::atomic<float> m_stepsPerSecond{};
+    };
+
+} // namespace GreyScott
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Backpressure.hpp"
+#include "BoundedQueue.hpp"
+#include "Checkpoint.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace GreyScott {
+    struct SnapshotOptions {
+        // Files are named <prefix>_<step>.ckpt
+        std::string prefix{ "snapshot" };
+        // Steps between snapshots
+        uint64_t interval{ 1000 };
+        // Preallocated field buffers, i.e. snapshots in flight
+        int buffers{ 4 };
+        int threads{ 2 };
+        Backpressure backpressure{ Backpressure::Throttle };
+        // For the checkpoint files; pool buffers are page-aligned, so direct
+        // I/O writes them in place
+        FileWriterOptions io{};
+    };
+
+    /**
+     * @brief Writes periodic field snapshots without stalling the step loop
+     *
+     * This class handles:
+     * - A fixed pool of field buffers, allocated once up front
+     * - Filling a free buffer on the simulation thread, either by a plain
+     *   copy or by an asynchronous readback that the writer waits for
+     * - Handing filled buffers to writer threads and back through lock-free
+     *   queues; the mutex only parks idle threads
+     * - Applying the backpressure policy when no buffer is free
+     */
+    class SnapshotWriter {
+    public:
+        // Returned by a fill that completes asynchronously; called on the
+        // writer thread before the buffer is read
+        using Completion = std::function<void()>;
+        using FillFunction = std::function<Completion(float* field)>;
+        using WriteFunction = std::function<bool(const CheckpointInfo& info, const float* field)>;
+
+        // `fieldSize` is in floats; without `write`, each snapshot becomes a
+        // checkpoint file named after the prefix and step
+        SnapshotWriter(const SnapshotOptions& options, size_t fieldSize,
+                       WriteFunction write = {});
+        ~SnapshotWriter();
+
+        SnapshotWriter(const SnapshotWriter&) = delete;
+        SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+        // Simulation thread: true when a snapshot falls within (previous, step]
+        bool isDue(uint64_t previous, uint64_t step) const;
+        // Returns false when the snapshot was dropped
+        bool capture(const CheckpointInfo& info, const FillFunction& fill);
+        // Blocks until every captured snapshot is written
+        void flush();
+
+        // Current interval, raised above the configured one by Throttle
+        uint64_t getInterval() const { return m_interval.load(std::memory_order_relaxed); }
+        const SnapshotOptions& getOptions() const { return m_options; }
+        uint64_t getWritten() const { return m_written.load(std::memory_order_relaxed); }
+        uint64_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+        uint64_t getFailed() const { return m_failed.load(std::memory_order_relaxed); }
+        size_t getQueued() const { return m_ready.size(); }
+        // Per writer thread, averaged over the snapshots written so far
+        float getWriteMBps() const;
+
+    private:
+        struct Slot {
+            CheckpointInfo info{};
+            std::vector<float, AlignedAllocator<float>> field{};
+            Completion completion{};
+        };
+
+        void writerLoop();
+        bool acquireSlot(uint32_t& index);
+        void releaseSlot(uint32_t index);
+
+        SnapshotOptions m_options{};
+        WriteFunction m_write{};
+        std::vector<Slot> m_slots{};
+        BoundedQueue<uint32_t> m_free;
+        BoundedQueue<uint32_t> m_ready;
+        std::vector<std::thread> m_threads{};
+
+        // Parking only; buffers never pass through it
+        std::mutex m_mutex{};
+        std::condition_variable m_readyWake{};
+        std::condition_variable m_freeWake{};
+        bool m_stopping{};
+
+        std::atomic<uint64_t> m_interval{};
+        std::atomic<int> m_inFlight{};
+        std::atomic<uint64_t> m_written{};
+        std::atomic<uint64_t> m_dropped{};
+        std::atomic<uint64_t> m_failed{};
+        std::atomic<uint64_t> m_bytesWritten{};
+        std::atomic<uint64_t> m_writeNs{};
+    };
+
+} // namespace GreyScott
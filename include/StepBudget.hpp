@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+namespace GreyScott {
+    /**
+     * @brief A number of steps still to take on request, in bounded batches
+     *
+     * This class handles:
+     * - Handing out the budget in batches, so the owning loop keeps running
+     *   commands and publishing frames in between
+     * - Reporting completion, or interruption when a newer budget replaces
+     *   it, the pause state changes (tracked through a generation counter
+     *   the caller bumps) or the owner shuts down
+     *
+     * Belongs to the thread that steps the engines.
+     */
+    class StepBudget {
+    public:
+        // Runs on the owning thread; false when interrupted
+        using Done = std::function<void(bool completed)>;
+
+        StepBudget() = default;
+        ~StepBudget() { interrupt(); }
+
+        StepBudget(const StepBudget&) = delete;
+        StepBudget& operator=(const StepBudget&) = delete;
+
+        // Replaces a pending budget, which is reported as interrupted
+        void start(uint64_t steps, int batch, uint64_t generation, Done done) {
+            interrupt();
+            m_remaining = steps;
+            m_batch = std::max(batch, 1);
+            m_generation = generation;
+            m_done = std::move(done);
+            if (m_remaining == 0) { finish(true); }
+        }
+
+        bool active() const { return m_remaining > 0; }
+        uint64_t getGeneration() const { return m_generation; }
+        int nextBatch() const { return static_cast<int>(std::min<uint64_t>(m_remaining, m_batch)); }
+
+        void consume(int steps) {
+            if (!active()) { return; }
+            m_remaining -= std::min<uint64_t>(m_remaining, static_cast<uint64_t>(std::max(steps, 0)));
+            if (m_remaining == 0) { finish(true); }
+        }
+
+        void interrupt() {
+            if (active()) { finish(false); }
+        }
+
+    private:
+        void finish(bool completed) {
+            m_remaining = 0;
+            Done done{ std::move(m_done) };
+            m_done = {};
+            if (done) { done(completed); }
+        }
+
+        uint64_t m_remaining{};
+        int m_batch{ 1 };
+        uint64_t m_generation{};
+        Done m_done{};
+    };
+
+} // namespace GreyScott
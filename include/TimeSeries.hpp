@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Checkpoint.hpp"
+#include "FileWriter.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace GreyScott {
+    // File layout: TimeSeriesHeader, then one frame per append (a
+    // TimeSeriesFrameHeader, a table of tile sizes and the tiles), then on
+    // close an index of every frame and a trailer pointing at it. Without
+    // the trailer (e.g. after a crash) readers rebuild the index by walking
+    // the frame headers.
+    struct TimeSeriesHeader {
+        static constexpr char kMagic[8]{ 'G', 'S', 'S', 'E', 'R', 'I', 'E', 'S' };
+        static constexpr uint32_t kVersion{ 1 };
+
+        enum class Codec : uint32_t {
+            Raw, // Shuffled residuals stored as-is (built without zlib)
+            Zlib
+        };
+
+        char magic[8]{};
+        uint32_t version{ kVersion };
+        uint32_t width{};
+        uint32_t height{};
+        uint32_t channels{ 2 };
+        uint32_t tileSize{};
+        uint32_t keyframeInterval{};
+        Codec codec{ Codec::Raw };
+        // Largest absolute error of a quantized value, 0 = lossless
+        float errorBound{};
+        uint32_t reserved[6]{};
+    };
+    static_assert(sizeof(TimeSeriesHeader) == 64, "Time-series header layout changed");
+
+    struct TimeSeriesFrameHeader {
+        static constexpr uint32_t kMagic{ 0x52464753 }; // "GSFR"
+        static constexpr uint32_t kKeyframe{ 1u << 0 };
+
+        uint32_t magic{ kMagic };
+        uint32_t flags{};
+        uint64_t step{};
+        // Tile size table plus tiles
+        uint64_t payloadBytes{};
+        SimulationParams params{};
+        uint32_t seed{};
+        uint32_t tileCount{};
+        uint32_t reserved{};
+    };
+    static_assert(sizeof(TimeSeriesFrameHeader) == 56, "Time-series frame layout changed");
+
+    struct TimeSeriesIndexEntry {
+        uint64_t step{};
+        uint64_t offset{}; // Of the frame header
+        uint32_t flags{};
+        uint32_t reserved{};
+    };
+
+    struct TimeSeriesTrailer {
+        static constexpr char kMagic[8]{ 'G', 'S', 'I', 'N', 'D', 'E', 'X', '\0' };
+
+        char magic[8]{};
+        uint64_t indexOffset{};
+        uint64_t frameCount{};
+    };
+
+    struct TimeSeriesOptions {
+        // Smallest non-zero error bound: below it, quantized values of the
+        // field's 0..1 range (with headroom) no longer fit in 32 bits
+        static constexpr float kMinErrorBound{ 1e-9f };
+
+        int tileSize{ 256 };
+        // Every N-th frame is encoded without reference to the previous one
+        int keyframeInterval{ 16 };
+        // Quantize to within this absolute error (plus float rounding),
+        // 0 = bit-exact, else at least kMinErrorBound
+        float errorBound{ 0.0f };
+        // zlib level, 1 (fastest) to 9
+        int level{ 1 };
+        // Tile encoding threads, 0 = hardware concurrency
+        int threads{ 0 };
+        FileWriterOptions io{};
+    };
+
+    /**
+     * @brief Appends fields to a compressed, seekable time-series file
+     *
+     * This class handles:
+     * - Splitting each frame into tiles that are encoded in parallel
+     * - Residuals against the previous frame (XOR of the float bits, or the
+     *   difference of quantized values), or against the left neighbour on
+     *   keyframes
+     * - Byte-shuffling residuals into planes so zlib sees the long runs of
+     *   zero high bytes
+     * - Tracking the compression ratio and encoding throughput
+     * - Refusing further frames once a write failed, since they would be
+     *   residuals against a frame that isn't in the file
+     *
+     * Frames must be appended in order by one thread at a time.
+     */
+    class TimeSeriesWriter {
+    public:
+        TimeSeriesWriter() = default;
+        ~TimeSeriesWriter();
+
+        TimeSeriesWriter(const TimeSeriesWriter&) = delete;
+        TimeSeriesWriter& operator=(const TimeSeriesWriter&) = delete;
+
+        bool open(const std::string& path, int width, int height,
+                  const TimeSeriesOptions& options = {});
+        bool append(const CheckpointInfo& info, const float* field);
+        // Writes the index; also done by the destructor
+        bool close();
+
+        // Statistics may be read from any thread
+        uint64_t getFrameCount() const { return m_frameCount.load(std::memory_order_relaxed); }
+        uint64_t getRawBytes() const { return m_rawBytes.load(std::memory_order_relaxed); }
+        uint64_t getStoredBytes() const { return m_storedBytes.load(std::memory_order_relaxed); }
+        float getRatio() const;
+        float getMBps() const;
+
+    private:
+        FileWriter m_file{};
+        TimeSeriesHeader m_header{};
+        TimeSeriesOptions m_options{};
+        std::vector<uint32_t> m_previous{};
+        std::vector<std::vector<uint8_t>> m_tiles{};
+        std::vector<TimeSeriesIndexEntry> m_index{};
+        std::atomic<uint64_t> m_frameCount{};
+        std::atomic<uint64_t> m_rawBytes{};
+        std::atomic<uint64_t> m_storedBytes{};
+        std::atomic<uint64_t> m_encodeNs{};
+        bool m_failed{};
+    };
+
+    /**
+     * @brief Random access to the frames of a time-series file
+     *
+     * readFrame decodes forward from the closest keyframe at or before the
+     * requested frame, or from the last decoded frame when that is closer;
+     * reading the last decoded frame again decodes nothing.
+     */
+    class TimeSeriesReader {
+    public:
+        bool open(const std::string& path);
+
+        const TimeSeriesHeader& getHeader() const { return m_header; }
+        size_t getFrameCount() const { return m_index.size(); }
+        const TimeSeriesIndexEntry& getEntry(size_t frame) const { return m_index[frame]; }
+        // Stored size including the frame header
+        uint64_t getFrameBytes(size_t frame) const;
+        // `field` holds width * height * 2 floats; `info` may be null
+        bool readFrame(size_t frame, float* field, CheckpointInfo* info = nullptr);
+
+    private:
+        bool buildIndex(uint64_t fileSize);
+        bool readFrameHeader(size_t frame, TimeSeriesFrameHeader& header);
+        void fillInfo(const TimeSeriesFrameHeader& header, CheckpointInfo* info) const;
+        bool decodeNext(size_t frame, CheckpointInfo* info);
+
+        std::ifstream m_file{};
+        TimeSeriesHeader m_header{};
+        std::vector<TimeSeriesIndexEntry> m_index{};
+        std::vector<uint32_t> m_previous{};
+        std::vector<uint8_t> m_payload{};
+        uint64_t m_framesEnd{}; // Offset past the last frame
+        size_t m_decoded{ SIZE_MAX }; // Frame held in m_previous
+    };
+
+} // namespace GreyScott
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace GreyScott {
+    /**
+     * @brief Lock-free single-producer/single-consumer triple buffer
+     *
+     * The writer fills back() and publishes it; the reader calls update() to
+     * take the most recent published slot as front(). Neither side ever
+     * waits: the writer overwrites an unread middle slot, and the reader
+     * keeps showing its front slot until something newer arrives.
+     */
+    template <typename T>
+    class TripleBuffer {
+    public:
+        TripleBuffer() = default;
+
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        // Writer side
+        T& back() { return m_slots[m_backIndex]; }
+
+        void publish() {
+            uint8_t previous{ m_middle.exchange(
+                static_cast<uint8_t>(m_backIndex | kFreshBit),
+                std::memory_order_acq_rel) };
+            m_backIndex = previous & kIndexMask;
+        }
+
+        // True once the reader has taken the last published slot, i.e. a
+        // new publish would actually be seen rather than overwrite one;
+        // the reader can use it to check for a new slot without taking it
+        bool consumed() const {
+            return (m_middle.load(std::memory_order_acquire) & kFreshBit) == 0;
+        }
+
+        // Reader side
+        bool update() {
+            if ((m_middle.load(std::memory_order_acquire) & kFreshBit) == 0) {
+                return false;
+            }
+            uint8_t previous{ m_middle.exchange(m_frontIndex,
+                                                std::memory_order_acq_rel) };
+            m_frontIndex = previous & kIndexMask;
+            return true;
+        }
+
+        const T& front() const { return m_slots[m_frontIndex]; }
+
+    private:
+        static constexpr uint8_t kFreshBit{ 0x4 };
+        static constexpr uint8_t kIndexMask{ 0x3 };
+
+        T m_slots[3]{};
+        uint8_t m_backIndex{ 0 };
+        std::atomic<uint8_t> m_middle{ 1 };
+        uint8_t m_frontIndex{ 2 };
+    };
+
+} // namespace GreyScott
@@ -0,0 +1,52 @@
+/**
+ * Display conversion kernels
+ *
+ * Extract the displayed channel (U) of the simulation state into a compact
+ * texture format, so readback or the interop copy moves 4, 2 or 1 bytes
+ * per cell instead of 8.
+ */
+__kernel void display_r16f(
+    __global const float2* state,   // Simulation state (U, V)
+    __global half* out,             // U as IEEE half (storage only)
+    const int count)
+{
+    int i = get_global_id(0);
+    if (i >= count) return;
+
+    vstore_half_rte(state[i].x, i, out);
+}
+
+__kernel void display_r8(
+    __global const float2* state,   // Simulation state (U, V)
+    __global uchar* out,            // U normalized to [0, 255]
+    const int count)
+{
+    int i = get_global_id(0);
+    if (i >= count) return;
+
+    out[i] = convert_uchar_sat_rte(state[i].x * 255.0f);
+}
+
+// Same colormap as the renderer's heatMap() GLSL function
+uchar4 heat_map(float u)
+{
+    const float3 purple = (float3)(0.15f, 0.0f, 0.2f);
+    const float3 green  = (float3)(0.0f, 0.6f, 0.2f);
+    const float3 yellow = (float3)(1.0f, 0.95f, 0.3f);
+
+    float t = 1.0f - u;
+    float3 color = t < 0.5f ? mix(purple, green, t * 2.0f)
+                            : mix(green, yellow, (t - 0.5f) * 2.0f);
+    return convert_uchar4_sat_rte((float4)(color, 1.0f) * 255.0f);
+}
+
+__kernel void display_rgba8(
+    __global const float2* state,   // Simulation state (U, V)
+    __global uchar4* out,           // Heat-map colors
+    const int count)
+{
+    int i = get_global_id(0);
+    if (i >= count) return;
+
+    out[i] = heat_map(state[i].x);
+}
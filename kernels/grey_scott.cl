@@ -10,22 +10,19 @@
  * - k: kill rate
  * - ∇^2: Laplacian operator (discrete approximation)
  */
-__kernel void grey_scott_step(
-    __global const float2* current,  // Current state (U, V)
-    __global float2* next,           // Next state (U, V)
-    const float Du,                  // Diffusion rate for U
-    const float Dv,                  // Diffusion rate for V
-    const float F,                   // Feed rate
-    const float k,                   // Kill rate
-    const float dt,                  // Time step
+// Forward Euler update of one cell, shared by the plain and fused kernels
+float2 grey_scott_cell(
+    __global const float2* current,
+    const float Du,
+    const float Dv,
+    const float F,
+    const float k,
+    const float dt,
     const int width,
-    const int height)
+    const int height,
+    const int x,
+    const int y)
 {
-    int x = get_global_id(0);
-    int y = get_global_id(1);
-
-    if (x >= width || y >= height) return;
-
     int idx = y * width + x;
     float2 uv = current[idx];
     float u = uv.x;
@@ -52,11 +49,100 @@ __kernel void grey_scott_step(
     float du = Du * laplacian_u - uvv + F * (1.0f - u);
     float dv = Dv * laplacian_v + uvv - (F + k) * v;
 
-    // Forward Euler integration
-    next[idx].x = u + du * dt;
-    next[idx].y = v + dv * dt;
+    // Forward Euler integration, clamped to [0, 1] for stability
+    return clamp((float2)(u + du * dt, v + dv * dt), 0.0f, 1.0f);
+}
+
+// Same colormap as the renderer's heatMap() GLSL function
+float4 heat_map(float u)
+{
+    const float3 purple = (float3)(0.15f, 0.0f, 0.2f);
+    const float3 green  = (float3)(0.0f, 0.6f, 0.2f);
+    const float3 yellow = (float3)(1.0f, 0.95f, 0.3f);
+
+    float t = 1.0f - u;
+    float3 color = t < 0.5f ? mix(purple, green, t * 2.0f)
+                            : mix(green, yellow, (t - 0.5f) * 2.0f);
+    return (float4)(color, 1.0f);
+}
+
+__kernel void grey_scott_step(
+    __global const float2* current,  // Current state (U, V)
+    __global float2* next,           // Next state (U, V)
+    const float Du,                  // Diffusion rate for U
+    const float Dv,                  // Diffusion rate for V
+    const float F,                   // Feed rate
+    const float k,                   // Kill rate
+    const float dt,                  // Time step
+    const int width,
+    const int height)
+{
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+
+    if (x >= width || y >= height) return;
+
+    next[y * width + x] = grey_scott_cell(current, Du, Dv, F, k, dt, width, height, x, y);
+}
+
+/**
+ * Last step of a frame: steps like grey_scott_step and also writes the
+ * colormapped result into the shared RGBA8 display texture, replacing the
+ * buffer-to-image copy and the per-pixel colormap in the fragment shader
+ */
+__kernel void grey_scott_step_rgba(
+    __global const float2* current,
+    __global float2* next,
+    const float Du,
+    const float Dv,
+    const float F,
+    const float k,
+    const float dt,
+    const int width,
+    const int height,
+    __write_only image2d_t display)  // GL-shared RGBA8 texture
+{
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+
+    if (x >= width || y >= height) return;
+
+    float2 uv = grey_scott_cell(current, Du, Dv, F, k, dt, width, height, x, y);
+    next[y * width + x] = uv;
+    write_imagef(display, (int2)(x, y), heat_map(uv.x));
+}
+
+// Layout of the host's SimulationParams (five floats, no padding)
+typedef struct {
+    float Du;
+    float Dv;
+    float F;
+    float k;
+    float dt;
+} SimulationParams;
+
+/**
+ * One step of a stack of independent grids of the same size, one per
+ * work-item layer of a 3D NDRange (x, y, member). Member m's cells start at
+ * m * width * height in both buffers and step with params[m], so a whole
+ * ensemble of small grids advances in one launch.
+ */
+__kernel void grey_scott_ensemble_step(
+    __global const float2* current,
+    __global float2* next,
+    __global const SimulationParams* params,  // One entry per member
+    const int width,
+    const int height,
+    const int members)
+{
+    int x = get_global_id(0);
+    int y = get_global_id(1);
+    int m = get_global_id(2);
+
+    if (x >= width || y >= height || m >= members) return;
 
-    // Clamp to [0, 1] for stability
-    next[idx].x = clamp(next[idx].x, 0.0f, 1.0f);
-    next[idx].y = clamp(next[idx].y, 0.0f, 1.0f);
+    size_t offset = (size_t)m * width * height;
+    SimulationParams p = params[m];
+    next[offset + y * width + x] =
+        grey_scott_cell(current + offset, p.Du, p.Dv, p.F, p.k, p.dt, width, height, x, y);
 }
@@ -0,0 +1,166 @@
+#ifdef USE_OPENCL
+
+#include "CommandProfiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace GreyScott {
+    const char* commandKindName(CommandKind kind) {
+        switch (kind) {
+        case CommandKind::Kernel: return "Kernel";
+        case CommandKind::DisplayKernel: return "DisplayKernel";
+        case CommandKind::CopyToImage: return "CopyBufferToImage";
+        case CommandKind::AcquireGL: return "AcquireGLObjects";
+        case CommandKind::ReleaseGL: return "ReleaseGLObjects";
+        case CommandKind::ReadBuffer: return "ReadBuffer";
+        case CommandKind::WriteBuffer: return "WriteBuffer";
+        case CommandKind::MapBuffer: return "MapBuffer";
+        case CommandKind::UnmapBuffer: return "UnmapMemObject";
+        default: return "Unknown";
+        }
+    }
+
+    void LatencyHistogram::add(double us) {
+        int bucket{ us < 1.0 ? 0 : 1 + static_cast<int>(std::log2(us)) };
+        bucket = std::min(bucket, kBuckets - 1);
+
+        ++counts[bucket];
+        ++samples;
+        totalUs += us;
+        maxUs = std::max(maxUs, us);
+    }
+
+    double LatencyHistogram::percentile(double p) const {
+        if (samples == 0) { return 0.0; }
+
+        uint64_t target{ static_cast<uint64_t>(std::ceil(p * samples)) };
+        uint64_t seen{};
+        for (int i{}; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= target) {
+                // Report the bucket's upper bound, capped by the observed max
+                return std::min(std::ldexp(1.0, i), maxUs);
+            }
+        }
+        return maxUs;
+    }
+
+    CommandProfiler::~CommandProfiler() {
+        for (const auto& pending : m_pending) { clReleaseEvent(pending.event); }
+    }
+
+    void CommandProfiler::track(CommandKind kind, cl_event event) {
+        if (!event) { return; }
+        m_pending.push_back({ kind, event });
+    }
+
+    void CommandProfiler::collect() {
+        auto completed{ std::remove_if(
+            m_pending.begin(), m_pending.end(), [this](const PendingEvent& pending) {
+                cl_int status{};
+                cl_int err = clGetEventInfo(pending.event,
+                                            CL_EVENT_COMMAND_EXECUTION_STATUS,
+                                            sizeof(status), &status, nullptr);
+                if (err == CL_SUCCESS && status > CL_COMPLETE) { return false; }
+
+                // Negative status means the command was aborted; just drop it
+                if (err == CL_SUCCESS && status == CL_COMPLETE) {
+                    cl_ulong queued{}, submit{}, start{}, end{};
+                    err = clGetEventProfilingInfo(pending.event, CL_PROFILING_COMMAND_QUEUED,
+                                                  sizeof(queued), &queued, nullptr);
+                    err |= clGetEventProfilingInfo(pending.event, CL_PROFILING_COMMAND_SUBMIT,
+                                                   sizeof(submit), &submit, nullptr);
+                    err |= clGetEventProfilingInfo(pending.event, CL_PROFILING_COMMAND_START,
+                                                   sizeof(start), &start, nullptr);
+                    err |= clGetEventProfilingInfo(pending.event, CL_PROFILING_COMMAND_END,
+                                                   sizeof(end), &end, nullptr);
+
+                    if (err == CL_SUCCESS) {
+                        auto& stats{ m_stats[static_cast<size_t>(pending.kind)] };
+                        stats.queued.add((submit - queued) / 1000.0);
+                        stats.submitted.add((start - submit) / 1000.0);
+                        stats.executed.add((end - start) / 1000.0);
+                    }
+                }
+
+                clReleaseEvent(pending.event);
+                return true;
+            }) };
+        if (completed == m_pending.end()) { return; }
+
+        m_pending.erase(completed, m_pending.end());
+        publishSnapshot();
+    }
+
+    void CommandProfiler::reset() {
+        m_stats = {};
+        publishSnapshot();
+    }
+
+    CommandProfiler::StatsArray CommandProfiler::getSnapshot() const {
+        std::lock_guard<std::mutex> lock{ m_snapshotMutex };
+        return m_snapshot;
+    }
+
+    void CommandProfiler::publishSnapshot() {
+        std::lock_guard<std::mutex> lock{ m_snapshotMutex };
+        m_snapshot = m_stats;
+    }
+
+    bool CommandProfiler::writeReport(const std::string& filename) const {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open report file: " << filename << '\n';
+            return false;
+        }
+
+        file << std::fixed << std::setprecision(2);
+        file << "OpenCL command timeline (microseconds)\n";
+        file << "queue = QUEUED->SUBMIT, submit = SUBMIT->START, exec = START->END\n\n";
+        file << std::left << std::setw(20) << "command" << std::right
+             << std::setw(10) << "count" << std::setw(12) << "queue avg"
+             << std::setw(12) << "submit avg" << std::setw(12) << "exec avg"
+             << std::setw(12) << "exec p50" << std::setw(12) << "exec p95"
+             << std::setw(12) << "exec max" << std::setw(14) << "exec total"
+             << '\n';
+
+        for (int i{}; i < static_cast<int>(CommandKind::Count); ++i) {
+            const auto& stats{ m_stats[i] };
+            if (stats.executed.samples == 0) { continue; }
+
+            file << std::left << std::setw(20)
+                 << commandKindName(static_cast<CommandKind>(i)) << std::right
+                 << std::setw(10) << stats.executed.samples
+                 << std::setw(12) << stats.queued.mean()
+                 << std::setw(12) << stats.submitted.mean()
+                 << std::setw(12) << stats.executed.mean()
+                 << std::setw(12) << stats.executed.percentile(0.50)
+                 << std::setw(12) << stats.executed.percentile(0.95)
+                 << std::setw(12) << stats.executed.maxUs
+                 << std::setw(14) << stats.executed.totalUs << '\n';
+        }
+
+        file << "\nExecution histograms (bucket upper bound in us: count)\n";
+        for (int i{}; i < static_cast<int>(CommandKind::Count); ++i) {
+            const auto& histogram{ m_stats[i].executed };
+            if (histogram.samples == 0) { continue; }
+
+            file << commandKindName(static_cast<CommandKind>(i)) << ':';
+            for (int b{}; b < LatencyHistogram::kBuckets; ++b) {
+                if (histogram.counts[b] == 0) { continue; }
+                file << ' ' << std::setprecision(0) << std::ldexp(1.0, b) << ':'
+                     << histogram.counts[b];
+            }
+            file << std::setprecision(2) << '\n';
+        }
+
+        std::cout << "Wrote OpenCL command report to " << filename << '\n';
+        return file.good();
+    }
+
+} // namespace GreyScott
+
+#endif // USE_OPENCL
@@ -8,6 +8,7 @@
 
 // OpenGL interop headers (non-macOS only)
 #ifndef __APPLE__
+    #include <GL/glew.h>
     #ifdef _WIN32
         #include <windows.h>
         #include <GL/gl.h>
@@ -32,7 +33,7 @@ namespace GreyScott {
         if (m_context) { clReleaseContext(m_context); }
     }
 
-    bool ComputeManager::initialize() {
+    bool ComputeManager::initialize(bool enableGLInterop, int deviceIndex) {
         if (m_initialized) {
             std::cerr << "ComputeManager already initialized!\n";
             return false;
@@ -58,8 +59,35 @@ namespace GreyScott {
 
         std::cout << "Found " << numPlatforms << " OpenCL platform(s)\n";
 
-        // Try to find a GPU device, fall back to any device
         bool foundDevice{};
+        if (deviceIndex >= 0) {
+            // Same numbering as queryDevices()
+            int index{};
+            for (cl_uint i{}; i < numPlatforms && !foundDevice; ++i) {
+                cl_uint numDevices{};
+                err = clGetDeviceIDs(platforms[i], CL_DEVICE_TYPE_ALL, 0,
+                                     nullptr, &numDevices);
+                if (err != CL_SUCCESS || numDevices == 0) { continue; }
+
+                std::vector<cl_device_id> devices(numDevices);
+                err = clGetDeviceIDs(platforms[i], CL_DEVICE_TYPE_ALL,
+                                     numDevices, devices.data(), nullptr);
+                if (err != CL_SUCCESS) { continue; }
+                if (deviceIndex < index + static_cast<int>(numDevices)) {
+                    m_platform = platforms[i];
+                    m_device = devices[deviceIndex - index];
+                    foundDevice = true;
+                }
+                index += static_cast<int>(numDevices);
+            }
+
+            if (!foundDevice) {
+                std::cerr << "Failed to find OpenCL device " << deviceIndex << "!\n";
+                return false;
+            }
+        }
+
+        // Try to find a GPU device, fall back to any device
         for (cl_uint i{}; i < numPlatforms && !foundDevice; ++i) {
             cl_uint numDevices{};
             err = clGetDeviceIDs(platforms[i], CL_DEVICE_TYPE_GPU, 0, nullptr,
@@ -106,7 +134,8 @@ namespace GreyScott {
 
         // Create context
 #ifndef __APPLE__
-        m_hasGLInterop = checkGLInteropSupport();
+        // Headless callers have no current GL context to share with
+        m_hasGLInterop = enableGLInterop && checkGLInteropSupport();
         
         if (m_hasGLInterop) {
             std::cout << "OpenCL-OpenGL interop available, enabling shared context\n";
@@ -135,6 +164,7 @@ namespace GreyScott {
             m_context = clCreateContext(nullptr, 1, &m_device, nullptr, nullptr, &err);
         }
 #else // macOS
+        (void)enableGLInterop;
         std::cout << "macOS detected: using regular context (GL interop deprecated)\n";
         m_hasGLInterop = false;
         m_context = clCreateContext(nullptr, 1, &m_device, nullptr, nullptr, &err);
@@ -163,6 +193,8 @@ namespace GreyScott {
         // Get device info
         m_currentDeviceInfo = getDeviceInfo(m_device);
 
+        if (m_hasGLInterop) { initGLEventSync(); }
+
         std::cout << "OpenCL initialized successfully\n";
         std::cout << "  Device: " << m_currentDeviceInfo.name << '\n';
         std::cout << "  Vendor: " << m_currentDeviceInfo.vendor << '\n';
@@ -177,6 +209,12 @@ namespace GreyScott {
                   << " MB" << '\n';
         std::cout << "  Local Memory: "
                   << (m_currentDeviceInfo.localMemSize / 1024) << " KB" << '\n';
+        std::cout << "  Fine-grained SVM: "
+                  << (m_currentDeviceInfo.fineGrainSVM ? "Yes" : "No") << '\n';
+        if (m_hasGLInterop) {
+            std::cout << "  GL/CL Event Sync: " << (hasGLEventSync() ? "Yes" : "No")
+                      << '\n';
+        }
 
         m_initialized = true;
         return true;
@@ -284,6 +322,17 @@ namespace GreyScott {
                         nullptr);
         info.available = (boolVal == CL_TRUE);
 
+        boolVal = CL_FALSE;
+        clGetDeviceInfo(device, CL_DEVICE_HOST_UNIFIED_MEMORY, sizeof(boolVal),
+                        &boolVal, nullptr);
+        info.hostUnifiedMemory = (boolVal == CL_TRUE);
+
+        // Only reported by OpenCL 2.0+ devices; older ones leave this at zero
+        cl_device_svm_capabilities svmCaps{};
+        clGetDeviceInfo(device, CL_DEVICE_SVM_CAPABILITIES, sizeof(svmCaps),
+                        &svmCaps, nullptr);
+        info.fineGrainSVM = (svmCaps & CL_DEVICE_SVM_FINE_GRAIN_BUFFER) != 0;
+
         return info;
     }
 
@@ -395,6 +444,42 @@ namespace GreyScott {
 #endif
     }
 
+    void ComputeManager::initGLEventSync() {
+#ifndef __APPLE__
+        // Both directions are needed: CL waiting on a GL fence before the
+        // acquire, and GL waiting on the CL release before sampling
+        if (!GLEW_ARB_cl_event) { return; }
+
+        size_t extensionSize{};
+        cl_int err = clGetDeviceInfo(m_device, CL_DEVICE_EXTENSIONS, 0, nullptr,
+                                     &extensionSize);
+        if (err != CL_SUCCESS) { return; }
+
+        std::vector<char> extensions(extensionSize);
+        err = clGetDeviceInfo(m_device, CL_DEVICE_EXTENSIONS, extensionSize,
+                              extensions.data(), nullptr);
+        if (err != CL_SUCCESS) { return; }
+
+        std::string extensionString(extensions.data());
+        if (extensionString.find("cl_khr_gl_event") == std::string::npos) { return; }
+
+        m_createEventFromGLsync = reinterpret_cast<CreateEventFromGLsyncFunction>(
+            clGetExtensionFunctionAddressForPlatform(m_platform,
+                                                     "clCreateEventFromGLsyncKHR"));
+#endif
+    }
+
+    cl_event ComputeManager::createEventFromGLsync(GLsync sync) const {
+        cl_int err{};
+        cl_event event{ m_createEventFromGLsync(m_context, sync, &err) };
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to create event from GL sync! Error: " << err
+                      << '\n';
+            return nullptr;
+        }
+        return event;
+    }
+
 } // namespace GreyScott
 
 #endif // USE_OPENCL
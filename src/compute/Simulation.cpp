@@ -1,6 +1,7 @@
 #ifdef USE_OPENCL
 
 #include "Simulation.hpp"
+#include "DisplayFormatGL.hpp"
 #include <iostream>
 #include <random>
 
@@ -23,13 +24,33 @@ namespace GreyScott {
         m_bufferCurrent{ nullptr },
         m_bufferNext{ nullptr },
         m_kernel{ nullptr },
-        m_initialized{ false }
+        m_initialized{ false },
+        m_seed{ std::random_device{}() }
         {
             m_hostData.resize(width * height * 2);
         }
 
     Simulation::~Simulation() {
+        if (m_hostMapped) {
+            cl_command_queue queue{ m_computeManager->getQueue() };
+            if (!m_svmCurrent) {
+                clEnqueueUnmapMemObject(queue, m_bufferCurrent, m_mappedCurrent,
+                                        0, nullptr, nullptr);
+            }
+            if (!m_svmNext) {
+                clEnqueueUnmapMemObject(queue, m_bufferNext, m_mappedNext, 0,
+                                        nullptr, nullptr);
+            }
+            clFinish(queue);
+        }
+
+        for (cl_event event : m_pendingKernelEvents) { clReleaseEvent(event); }
+        if (m_displaySync) glDeleteSync(m_displaySync);
+
         if (m_kernel) clReleaseKernel(m_kernel);
+        if (m_fusedKernel) clReleaseKernel(m_fusedKernel);
+        if (m_displayKernel) clReleaseKernel(m_displayKernel);
+        if (m_displayBuffer) clReleaseMemObject(m_displayBuffer);
         
         if (m_clImageCurrent) clReleaseMemObject(m_clImageCurrent);
         if (m_clImageNext) clReleaseMemObject(m_clImageNext);
@@ -37,6 +58,30 @@ namespace GreyScott {
         
         if (m_bufferCurrent) clReleaseMemObject(m_bufferCurrent);
         if (m_bufferNext) clReleaseMemObject(m_bufferNext);
+
+        if (m_svmCurrent) clSVMFree(m_computeManager->getContext(), m_svmCurrent);
+        if (m_svmNext) clSVMFree(m_computeManager->getContext(), m_svmNext);
+    }
+
+    void Simulation::setKernel(const std::string& filename,
+                               const std::string& kernelName) {
+        if (m_initialized) {
+            std::cerr << "Cannot change kernel after initialization!\n";
+            return;
+        }
+
+        // Variants must keep grey_scott_step's argument list
+        m_kernelFile = filename;
+        m_kernelName = kernelName;
+    }
+
+    void Simulation::setDisplayFormat(DisplayFormat format) {
+        if (m_initialized) {
+            std::cerr << "Cannot change display format after initialization!\n";
+            return;
+        }
+
+        m_displayFormat = format;
     }
 
     bool Simulation::initialize() {
@@ -45,16 +90,33 @@ namespace GreyScott {
             return false;
         }
 
-        m_kernel = m_computeManager->loadKernel("kernels/grey_scott.cl",
-                                                "grey_scott_step");
+        m_kernel = m_computeManager->loadKernel(m_kernelFile, m_kernelName);
         if (!m_kernel) {
             std::cerr << "Failed to load Grey-Scott kernel!\n";
             return false;
         }
 
+        if (m_displayFormat != DisplayFormat::RG32F) {
+            const char* name{ m_displayFormat == DisplayFormat::R16F  ? "display_r16f"
+                              : m_displayFormat == DisplayFormat::R8 ? "display_r8"
+                                                                     : "display_rgba8" };
+            m_displayKernel = m_computeManager->loadKernel("kernels/display.cl", name);
+            if (!m_displayKernel) {
+                std::cerr << "Failed to load display kernel, displaying RG32F\n";
+                m_displayFormat = DisplayFormat::RG32F;
+            }
+        }
+
         createBuffers();
         initializeState();
 
+        if (m_useGLInterop && m_displayFormat == DisplayFormat::RGBA8) {
+            // Optional: kernel variants without a fused twin use step + copy
+            m_fusedKernel = m_computeManager->loadKernel(m_kernelFile, m_kernelName + "_rgba");
+            std::cout << (m_fusedKernel ? "Using fused step + colormap kernel\n"
+                                        : "No fused colormap kernel, using display conversion\n");
+        }
+
         std::cout << "Simulation initialized\n";
         std::cout << "  Grid: " << m_width << "x" << m_height << '\n';
         std::cout << "  Parameters: F=" << m_params.F << ", k=" << m_params.k
@@ -68,6 +130,7 @@ namespace GreyScott {
         cl_int err{};
         
         m_useGLInterop = m_computeManager->hasGLInterop();
+        m_useSVM = m_computeManager->getCurrentDeviceInfo().fineGrainSVM;
         
 #ifndef __APPLE__
         if (m_useGLInterop) {
@@ -81,8 +144,10 @@ namespace GreyScott {
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, m_width, m_height, 0,
-                        GL_RG, GL_FLOAT, nullptr);
+            // Same layout the Renderer would create for this display format
+            GLTextureFormat format{ glTextureFormat(m_displayFormat) };
+            glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, m_width, m_height,
+                         0, format.format, format.type, nullptr);
             
             GLenum glErr = glGetError();
             if (glErr != GL_NO_ERROR) {
@@ -106,11 +171,7 @@ namespace GreyScott {
             }
             
              if (m_useGLInterop) {
-                size_t bufferSize{ m_width * m_height * 2 * sizeof(float) };
-                
-                m_bufferCurrent = clCreateBuffer(m_computeManager->getContext(), 
-                                                CL_MEM_READ_WRITE, bufferSize, 
-                                                nullptr, &err);
+                m_bufferCurrent = createStateBuffer(m_svmCurrent, &err);
                 if (err != CL_SUCCESS) {
                     std::cerr << "Failed to create current buffer! Error: " << err << '\n';
                     m_useGLInterop = false;
@@ -121,14 +182,16 @@ namespace GreyScott {
                     glDeleteTextures(1, &m_sharedTexture);
                     m_sharedTexture = 0;
                 } else {
-                    m_bufferNext = clCreateBuffer(m_computeManager->getContext(), 
-                                                 CL_MEM_READ_WRITE, bufferSize, 
-                                                 nullptr, &err);
+                    m_bufferNext = createStateBuffer(m_svmNext, &err);
                     if (err != CL_SUCCESS) {
                         std::cerr << "Failed to create next buffer! Error: " << err << '\n';
                         m_useGLInterop = false;
                         clReleaseMemObject(m_bufferCurrent);
                         m_bufferCurrent = nullptr;
+                        if (m_svmCurrent) {
+                            clSVMFree(m_computeManager->getContext(), m_svmCurrent);
+                            m_svmCurrent = nullptr;
+                        }
                         if (m_clImageCurrent) {
                             clReleaseMemObject(m_clImageCurrent);
                             m_clImageCurrent = nullptr;
@@ -145,31 +208,68 @@ namespace GreyScott {
         
         if (!m_useGLInterop) {
             std::cout << "Creating regular OpenCL buffers (with CPU transfers)\n";
-            
-            size_t bufferSize{ m_width * m_height * 2 * sizeof(float) };
 
-            m_bufferCurrent =
-                clCreateBuffer(m_computeManager->getContext(), CL_MEM_READ_WRITE,
-                               bufferSize, nullptr, &err);
+            m_bufferCurrent = createStateBuffer(m_svmCurrent, &err);
             if (err != CL_SUCCESS) {
                 std::cerr << "Failed to create current buffer! Error: " << err
                           << '\n';
                 return;
             }
 
-            m_bufferNext =
-                clCreateBuffer(m_computeManager->getContext(), CL_MEM_READ_WRITE,
-                               bufferSize, nullptr, &err);
+            m_bufferNext = createStateBuffer(m_svmNext, &err);
             if (err != CL_SUCCESS) {
                 std::cerr << "Failed to create next buffer! Error: " << err << '\n';
                 return;
             }
         }
+
+        if (m_displayKernel) {
+            m_displayBuffer = clCreateBuffer(
+                m_computeManager->getContext(), CL_MEM_READ_WRITE,
+                displayBytesPerTexel(m_displayFormat) * m_width * m_height, nullptr, &err);
+            if (err != CL_SUCCESS) {
+                std::cerr << "Failed to create display buffer! Error: " << err << '\n';
+            }
+        }
+
+        std::cout << "State buffers: "
+                  << (usesSVM() ? "fine-grained SVM" : "mapped host-visible")
+                  << '\n';
+    }
+
+    cl_mem Simulation::createStateBuffer(void*& svmPtr, cl_int* err) {
+        size_t bufferSize{ m_width * m_height * 2 * sizeof(float) };
+        cl_context context{ m_computeManager->getContext() };
+
+        // A buffer wrapping SVM memory is shared with the host as-is, so the
+        // CPU engine can step it without any map or copy
+        if (m_useSVM) {
+            svmPtr = clSVMAlloc(context,
+                                CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER,
+                                bufferSize, 0);
+            if (svmPtr) {
+                cl_mem buffer{ clCreateBuffer(
+                    context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR,
+                    bufferSize, svmPtr, err) };
+                if (*err == CL_SUCCESS) { return buffer; }
+
+                clSVMFree(context, svmPtr);
+                svmPtr = nullptr;
+            }
+            std::cerr << "SVM allocation failed, falling back to mapped buffers\n";
+            m_useSVM = false;
+        }
+
+        // On unified-memory devices a host-allocated buffer maps without a copy
+        cl_mem_flags flags{ CL_MEM_READ_WRITE };
+        if (m_computeManager->getCurrentDeviceInfo().hostUnifiedMemory) {
+            flags |= CL_MEM_ALLOC_HOST_PTR;
+        }
+        return clCreateBuffer(context, flags, bufferSize, nullptr, err);
     }
 
     void Simulation::initializeState() {
-        std::random_device rd{};
-        std::mt19937 gen(rd());
+        std::mt19937 gen(m_seed);
         std::uniform_real_distribution<float> dis(0.0f, 0.01f);
 
         for (int i{}; i < m_width * m_height; ++i) {
@@ -193,112 +293,235 @@ namespace GreyScott {
             }
         }
 
+        cl_event event{};
         cl_int err = clEnqueueWriteBuffer(
             m_computeManager->getQueue(), m_bufferCurrent, CL_TRUE, 0,
             m_width * m_height * 2 * sizeof(float), m_hostData.data(), 0,
-            nullptr, nullptr);
+            nullptr, &event);
+        m_commandProfiler.track(CommandKind::WriteBuffer, event);
         if (err != CL_SUCCESS) {
             std::cerr << "Failed to write initial state! Error: " << err
                       << '\n';
         }
     }
 
-    void Simulation::step() {
-        if (!m_initialized) return;
-
+    bool Simulation::setStepArguments(cl_kernel kernel) {
         cl_int err{};
-
-        err = clSetKernelArg(m_kernel, 0, sizeof(cl_mem), &m_bufferCurrent);
-        err |= clSetKernelArg(m_kernel, 1, sizeof(cl_mem), &m_bufferNext);
-        err |= clSetKernelArg(m_kernel, 2, sizeof(float), &m_params.Du);
-        err |= clSetKernelArg(m_kernel, 3, sizeof(float), &m_params.Dv);
-        err |= clSetKernelArg(m_kernel, 4, sizeof(float), &m_params.F);
-        err |= clSetKernelArg(m_kernel, 5, sizeof(float), &m_params.k);
-        err |= clSetKernelArg(m_kernel, 6, sizeof(float), &m_params.dt);
-        err |= clSetKernelArg(m_kernel, 7, sizeof(int), &m_width);
-        err |= clSetKernelArg(m_kernel, 8, sizeof(int), &m_height);
+        err = clSetKernelArg(kernel, 2, sizeof(float), &m_params.Du);
+        err |= clSetKernelArg(kernel, 3, sizeof(float), &m_params.Dv);
+        err |= clSetKernelArg(kernel, 4, sizeof(float), &m_params.F);
+        err |= clSetKernelArg(kernel, 5, sizeof(float), &m_params.k);
+        err |= clSetKernelArg(kernel, 6, sizeof(float), &m_params.dt);
+        err |= clSetKernelArg(kernel, 7, sizeof(int), &m_width);
+        err |= clSetKernelArg(kernel, 8, sizeof(int), &m_height);
 
         if (err != CL_SUCCESS) {
             std::cerr << "Failed to set kernel arguments! Error: " << err
                       << '\n';
-            return;
+            return false;
         }
+        return true;
+    }
+
+    void Simulation::step(int iterations) {
+        if (!m_initialized || iterations < 1) return;
 
+        if (!setStepArguments(m_kernel)) { return; }
+
+        // The fused kernel colormaps the last step straight into the texture
+        bool fused{ m_fusedKernel != nullptr };
+        if (fused) {
+            fused = setStepArguments(m_fusedKernel) &&
+                    clSetKernelArg(m_fusedKernel, 9, sizeof(cl_mem), &m_clImageCurrent) == CL_SUCCESS &&
+                    acquireSharedTexture();
+        }
+
+        // Enqueue the whole batch back to back and synchronize once at the end
         size_t globalSize[2]{ static_cast<size_t>(m_width), static_cast<size_t>(m_height) };
+        std::vector<cl_event> events{};
+        events.reserve(iterations);
+        for (int i{}; i < iterations; ++i) {
+            cl_kernel kernel{ fused && i == iterations - 1 ? m_fusedKernel : m_kernel };
+
+            cl_int err{};
+            err = clSetKernelArg(kernel, 0, sizeof(cl_mem), &m_bufferCurrent);
+            err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &m_bufferNext);
+            if (err != CL_SUCCESS) {
+                std::cerr << "Failed to set kernel arguments! Error: " << err
+                          << '\n';
+                break;
+            }
+
+            cl_event event{};
+            err = clEnqueueNDRangeKernel(m_computeManager->getQueue(), kernel, 2,
+                                         nullptr, globalSize, nullptr, 0, nullptr,
+                                         &event);
+            if (err != CL_SUCCESS) {
+                std::cerr << "Failed to enqueue kernel! Error: " << err << '\n';
+                break;
+            }
+            events.push_back(event);
+
+            std::swap(m_bufferCurrent, m_bufferNext);
+            std::swap(m_svmCurrent, m_svmNext);
+        }
+
+        if (fused) { releaseSharedTexture(); }
+
+        if (m_useGLInterop && !fused && !events.empty()) {
+            copyToSharedTexture(m_bufferCurrent);
+        }
+
+        if (m_useGLInterop && m_computeManager->hasGLEventSync()) {
+            // GL waits on the release itself, so keep this batch queued and
+            // time the previous one, which it is already running behind
+            std::swap(events, m_pendingKernelEvents);
+            if (!events.empty()) {
+                clWaitForEvents(static_cast<cl_uint>(events.size()), events.data());
+            }
+        } else {
+            clFinish(m_computeManager->getQueue());
+        }
+
+        if (events.empty()) { return; }
+
+        // Report the mean kernel time per step of this batch
+        cl_ulong totalTime{};
+        for (cl_event event : events) {
+            cl_ulong time_start, time_end;
+            clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(time_start), &time_start, nullptr);
+            clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(time_end), &time_end, nullptr);
+            totalTime += time_end - time_start;
+            m_commandProfiler.track(CommandKind::Kernel, event);
+        }
+        m_lastComputeTime = totalTime / 1000000.0f / events.size();
+        m_commandProfiler.collect();
+    }
+
+    bool Simulation::acquireSharedTexture() {
+#ifndef __APPLE__
+        // Wait for GL's pending reads of the texture on the device
+        cl_event glDone{};
+        if (m_computeManager->hasGLEventSync()) {
+            GLsync fence{ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) };
+            glFlush();
+            glDone = m_computeManager->createEventFromGLsync(fence);
+            glDeleteSync(fence); // the event keeps its own reference
+        }
+
         cl_event event{};
-        err = clEnqueueNDRangeKernel(m_computeManager->getQueue(), m_kernel, 2,
-                                     nullptr, globalSize, nullptr, 0, nullptr,
-                                     &event);
+        cl_int err = clEnqueueAcquireGLObjects(m_computeManager->getQueue(), 1,
+                                               &m_clImageCurrent, glDone ? 1 : 0,
+                                               glDone ? &glDone : nullptr, &event);
+        if (glDone) { clReleaseEvent(glDone); }
+        m_commandProfiler.track(CommandKind::AcquireGL, event);
         if (err != CL_SUCCESS) {
-            std::cerr << "Failed to enqueue kernel! Error: " << err << '\n';
+            std::cerr << "Failed to acquire GL objects! Error: " << err << '\n';
+            return false;
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void Simulation::releaseSharedTexture() {
+#ifndef __APPLE__
+        cl_event event{};
+        cl_int err = clEnqueueReleaseGLObjects(m_computeManager->getQueue(), 1,
+                                               &m_clImageCurrent, 0, nullptr, &event);
+        m_commandProfiler.track(CommandKind::ReleaseGL, event);
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to release GL objects! Error: " << err << '\n';
             return;
         }
 
-        clFinish(m_computeManager->getQueue());
+        if (m_computeManager->hasGLEventSync()) {
+            // Replaces clFinish: GL waits on exactly this release
+            if (m_displaySync) { glDeleteSync(m_displaySync); }
+            m_displaySync = glCreateSyncFromCLeventARB(m_computeManager->getContext(),
+                                                       event, 0);
+            clFlush(m_computeManager->getQueue());
+        }
+#endif
+    }
 
+    void Simulation::waitForDisplay() {
 #ifndef __APPLE__
-        if (m_useGLInterop) {
-            err = clEnqueueAcquireGLObjects(m_computeManager->getQueue(), 1,
-                                           &m_clImageCurrent, 0, nullptr, nullptr);
-            if (err != CL_SUCCESS) {
-                std::cerr << "Failed to acquire GL objects! Error: " << err << '\n';
-            } else {
-                size_t origin[3] = {0, 0, 0};
-                size_t region[3] = {static_cast<size_t>(m_width), 
-                                   static_cast<size_t>(m_height), 1};
-                
-                err = clEnqueueCopyBufferToImage(m_computeManager->getQueue(),
-                                                m_bufferNext, m_clImageCurrent,
-                                                0, origin, region, 0, nullptr, nullptr);
-                if (err != CL_SUCCESS) {
-                    std::cerr << "Failed to copy buffer to GL texture! Error: " << err << '\n';
-                }
-                
-                err = clEnqueueReleaseGLObjects(m_computeManager->getQueue(), 1,
-                                               &m_clImageCurrent, 0, nullptr, nullptr);
-                if (err != CL_SUCCESS) {
-                    std::cerr << "Failed to release GL objects! Error: " << err << '\n';
-                }
-                
-                clFinish(m_computeManager->getQueue());
-            }
-        }
+        if (!m_displaySync) { return; }
+
+        glWaitSync(m_displaySync, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(m_displaySync);
+        m_displaySync = nullptr;
 #endif
+    }
 
-        cl_ulong time_start, time_end;
-        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(time_start), &time_start, nullptr);
-        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(time_end), &time_end, nullptr);
-        m_lastComputeTime = (time_end - time_start) / 1000000.0f;
+    void Simulation::copyToSharedTexture(cl_mem source) {
+#ifndef __APPLE__
+        if (m_displayFormat != DisplayFormat::RG32F) {
+            if (!convertDisplay(source)) { return; }
+            source = m_displayBuffer;
+        }
 
-        clReleaseEvent(event);
+        if (!acquireSharedTexture()) { return; }
 
-        std::swap(m_bufferCurrent, m_bufferNext);
+        size_t origin[3] = {0, 0, 0};
+        size_t region[3] = {static_cast<size_t>(m_width),
+                           static_cast<size_t>(m_height), 1};
 
-        if (!m_useGLInterop) {
-            readBackData();
+        cl_event event{};
+        cl_int err = clEnqueueCopyBufferToImage(m_computeManager->getQueue(),
+                                                source, m_clImageCurrent,
+                                                0, origin, region, 0, nullptr, &event);
+        m_commandProfiler.track(CommandKind::CopyToImage, event);
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to copy buffer to GL texture! Error: " << err << '\n';
         }
+
+        releaseSharedTexture();
+
+        if (!m_computeManager->hasGLEventSync()) { clFinish(m_computeManager->getQueue()); }
+        m_commandProfiler.collect();
+#else
+        (void)source;
+#endif
+    }
+
+    const float* Simulation::getData() const {
+        if (m_svmCurrent) { return static_cast<const float*>(m_svmCurrent); }
+        return m_hostData.data();
     }
 
     void Simulation::readBackData() {
-        if (m_useGLInterop) return;
+        if (m_useGLInterop || m_svmCurrent) return;
         
+        cl_event event{};
         cl_int err = clEnqueueReadBuffer(
             m_computeManager->getQueue(), m_bufferCurrent, CL_TRUE, 0,
             m_width * m_height * 2 * sizeof(float), m_hostData.data(), 0,
-            nullptr, nullptr);
+            nullptr, &event);
+        m_commandProfiler.track(CommandKind::ReadBuffer, event);
         if (err != CL_SUCCESS) {
             std::cerr << "Failed to read back data! Error: " << err << '\n';
         }
     }
 
-    void Simulation::reset() { initializeState(); }
+    void Simulation::reset() {
+        // Every reset draws a new pattern; the seed is kept for reproduction
+        m_seed = std::random_device{}();
+        initializeState();
+    }
 
     void Simulation::forceReadBack() {
-        if (m_useGLInterop) {
+        if (m_svmCurrent) {
+            clFinish(m_computeManager->getQueue());
+        } else if (m_useGLInterop) {
+            cl_event event{};
             cl_int err = clEnqueueReadBuffer(
                 m_computeManager->getQueue(), m_bufferCurrent, CL_TRUE, 0,
                 m_width * m_height * 2 * sizeof(float), m_hostData.data(), 0,
-                nullptr, nullptr);
+                nullptr, &event);
+            m_commandProfiler.track(CommandKind::ReadBuffer, event);
             if (err != CL_SUCCESS) {
                 std::cerr << "Failed to force read back data! Error: " << err << '\n';
             }
@@ -307,37 +530,161 @@ namespace GreyScott {
         }
     }
 
+    bool Simulation::readStateAsync(float* out, cl_event* done) {
+        // The queue is in order, so the copy sees every step enqueued so far
+        // and later steps don't touch it; the buffer exists in every mode
+        cl_int err = clEnqueueReadBuffer(
+            m_computeManager->getQueue(), m_bufferCurrent, CL_FALSE, 0,
+            m_width * m_height * 2 * sizeof(float), out, 0, nullptr, done);
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to enqueue state readback! Error: " << err << '\n';
+            return false;
+        }
+        clFlush(m_computeManager->getQueue());
+        return true;
+    }
+
+    bool Simulation::readDisplay(void* out) {
+        cl_mem source{ m_bufferCurrent };
+        if (m_displayFormat != DisplayFormat::RG32F) {
+            if (!convertDisplay(m_bufferCurrent)) { return false; }
+            source = m_displayBuffer;
+        }
+
+        cl_event event{};
+        cl_int err = clEnqueueReadBuffer(
+            m_computeManager->getQueue(), source, CL_TRUE, 0,
+            displayBytesPerTexel(m_displayFormat) * m_width * m_height, out, 0,
+            nullptr, &event);
+        m_commandProfiler.track(CommandKind::ReadBuffer, event);
+        m_commandProfiler.collect();
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to read display data! Error: " << err << '\n';
+            return false;
+        }
+        return true;
+    }
+
+    bool Simulation::convertDisplay(cl_mem source) {
+        int count{ m_width * m_height };
+        cl_int err{};
+        err = clSetKernelArg(m_displayKernel, 0, sizeof(cl_mem), &source);
+        err |= clSetKernelArg(m_displayKernel, 1, sizeof(cl_mem), &m_displayBuffer);
+        err |= clSetKernelArg(m_displayKernel, 2, sizeof(int), &count);
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to set display kernel arguments! Error: " << err << '\n';
+            return false;
+        }
+
+        size_t globalSize{ static_cast<size_t>(count) };
+        cl_event event{};
+        err = clEnqueueNDRangeKernel(m_computeManager->getQueue(), m_displayKernel, 1,
+                                     nullptr, &globalSize, nullptr, 0, nullptr, &event);
+        m_commandProfiler.track(CommandKind::DisplayKernel, event);
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to enqueue display kernel! Error: " << err << '\n';
+            return false;
+        }
+        return true;
+    }
+
     void Simulation::syncFrom(const float* data) {
         std::copy(data, data + m_width * m_height * 2, m_hostData.begin());
 
+        cl_event event{};
         cl_int err = clEnqueueWriteBuffer(
             m_computeManager->getQueue(), m_bufferCurrent, CL_TRUE, 0,
             m_width * m_height * 2 * sizeof(float), m_hostData.data(), 0,
-            nullptr, nullptr);
+            nullptr, &event);
+        m_commandProfiler.track(CommandKind::WriteBuffer, event);
         if (err != CL_SUCCESS) {
             std::cerr << "Failed to sync data to GPU! Error: " << err << '\n';
             return;
         }
 
-#ifndef __APPLE__
         if (m_useGLInterop) {
-            err = clEnqueueAcquireGLObjects(m_computeManager->getQueue(), 1,
-                                           &m_clImageCurrent, 0, nullptr, nullptr);
-            if (err == CL_SUCCESS) {
-                size_t origin[3] = {0, 0, 0};
-                size_t region[3] = {static_cast<size_t>(m_width),
-                                   static_cast<size_t>(m_height), 1};
-                
-                err = clEnqueueCopyBufferToImage(m_computeManager->getQueue(),
-                                                m_bufferCurrent, m_clImageCurrent,
-                                                0, origin, region, 0, nullptr, nullptr);
-                
-                clEnqueueReleaseGLObjects(m_computeManager->getQueue(), 1,
-                                         &m_clImageCurrent, 0, nullptr, nullptr);
-                clFinish(m_computeManager->getQueue());
+            copyToSharedTexture(m_bufferCurrent);
+        }
+    }
+
+    bool Simulation::mapHostState(float*& current, float*& next) {
+        if (!m_initialized || m_hostMapped) return false;
+
+        cl_command_queue queue{ m_computeManager->getQueue() };
+        clFinish(queue);
+
+        size_t bufferSize{ m_width * m_height * 2 * sizeof(float) };
+        cl_mem buffers[2]{ m_bufferCurrent, m_bufferNext };
+        void* svm[2]{ m_svmCurrent, m_svmNext };
+        float* mapped[2]{};
+
+        for (int i{}; i < 2; ++i) {
+            if (svm[i]) {
+                mapped[i] = static_cast<float*>(svm[i]);
+                continue;
+            }
+
+            cl_int err{};
+            cl_event event{};
+            mapped[i] = static_cast<float*>(clEnqueueMapBuffer(
+                queue, buffers[i], CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0,
+                bufferSize, 0, nullptr, &event, &err));
+            m_commandProfiler.track(CommandKind::MapBuffer, event);
+            if (err != CL_SUCCESS) {
+                std::cerr << "Failed to map state buffer! Error: " << err << '\n';
+                if (i == 1 && !svm[0]) {
+                    clEnqueueUnmapMemObject(queue, buffers[0], mapped[0], 0,
+                                            nullptr, nullptr);
+                    clFinish(queue);
+                }
+                return false;
             }
         }
-#endif
+
+        m_mappedCurrent = mapped[0];
+        m_mappedNext = mapped[1];
+        m_hostMapped = true;
+
+        current = m_mappedCurrent;
+        next = m_mappedNext;
+        return true;
+    }
+
+    void Simulation::unmapHostState(const float* current) {
+        if (!m_hostMapped) return;
+
+        cl_command_queue queue{ m_computeManager->getQueue() };
+        if (!m_svmCurrent) {
+            cl_event event{};
+            clEnqueueUnmapMemObject(queue, m_bufferCurrent, m_mappedCurrent, 0,
+                                    nullptr, &event);
+            m_commandProfiler.track(CommandKind::UnmapBuffer, event);
+        }
+        if (!m_svmNext) {
+            cl_event event{};
+            clEnqueueUnmapMemObject(queue, m_bufferNext, m_mappedNext, 0,
+                                    nullptr, &event);
+            m_commandProfiler.track(CommandKind::UnmapBuffer, event);
+        }
+
+        // The CPU engine ping-pongs between the same two allocations, so the
+        // latest state may now live in what was our "next" buffer
+        if (current == m_mappedNext) {
+            std::swap(m_bufferCurrent, m_bufferNext);
+            std::swap(m_svmCurrent, m_svmNext);
+        }
+
+        m_hostMapped = false;
+        m_mappedCurrent = nullptr;
+        m_mappedNext = nullptr;
+
+        if (m_useGLInterop) {
+            copyToSharedTexture(m_bufferCurrent);
+        } else {
+            readBackData();
+            clFinish(queue);
+        }
+        m_commandProfiler.collect();
     }
 
     void Simulation::loadPreset(int presetIndex) {
@@ -0,0 +1,240 @@
+#ifdef USE_OPENCL
+
+#include "SimulationEnsemble.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+namespace GreyScott {
+    // The kernel reads the parameter buffer as a packed struct of five floats
+    static_assert(sizeof(SimulationParams) == 5 * sizeof(float),
+                  "SimulationParams must match the OpenCL struct layout");
+
+    SimulationEnsemble::SimulationEnsemble(int width, int height, int members,
+                                           ComputeManager* computeManager) :
+        m_width{ width },
+        m_height{ height },
+        m_members{ std::max(1, members) },
+        m_computeManager{ computeManager },
+        m_params(std::max(1, members)),
+        m_seed{ std::random_device{}() }
+    {}
+
+    SimulationEnsemble::~SimulationEnsemble() {
+        if (m_kernel) clReleaseKernel(m_kernel);
+        if (m_paramsBuffer) clReleaseMemObject(m_paramsBuffer);
+        if (m_bufferCurrent) clReleaseMemObject(m_bufferCurrent);
+        if (m_bufferNext) clReleaseMemObject(m_bufferNext);
+    }
+
+    void SimulationEnsemble::setKernel(const std::string& filename,
+                                       const std::string& kernelName) {
+        if (m_initialized) {
+            std::cerr << "Cannot change kernel after initialization!\n";
+            return;
+        }
+
+        m_kernelFile = filename;
+        m_kernelName = kernelName;
+    }
+
+    size_t SimulationEnsemble::memberBytes() const {
+        return static_cast<size_t>(m_width) * m_height * 2 * sizeof(float);
+    }
+
+    bool SimulationEnsemble::initialize() {
+        if (!m_computeManager || !m_computeManager->isInitialized()) {
+            std::cerr << "ComputeManager not initialized!\n";
+            return false;
+        }
+        if (m_initialized) {
+            std::cerr << "Ensemble already initialized!\n";
+            return false;
+        }
+
+        m_kernel = m_computeManager->loadKernel(m_kernelFile, m_kernelName);
+        if (!m_kernel) {
+            std::cerr << "Failed to load ensemble kernel!\n";
+            return false;
+        }
+
+        cl_context context{ m_computeManager->getContext() };
+        size_t stateBytes{ memberBytes() * m_members };
+        cl_int err{};
+        m_bufferCurrent = clCreateBuffer(context, CL_MEM_READ_WRITE, stateBytes, nullptr, &err);
+        if (err == CL_SUCCESS) {
+            m_bufferNext = clCreateBuffer(context, CL_MEM_READ_WRITE, stateBytes, nullptr, &err);
+        }
+        if (err == CL_SUCCESS) {
+            m_paramsBuffer = clCreateBuffer(context, CL_MEM_READ_ONLY,
+                                            sizeof(SimulationParams) * m_members, nullptr, &err);
+        }
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to create ensemble buffers (" << stateBytes / (1024 * 1024)
+                      << " MB per state)! Error: " << err << '\n';
+            return false;
+        }
+
+        // Same initial pattern as Simulation, tiled into every member
+        std::vector<float> state(static_cast<size_t>(m_width) * m_height * 2);
+        std::mt19937 gen(m_seed);
+        std::uniform_real_distribution<float> dis(0.0f, 0.01f);
+        for (size_t i{}; i < state.size(); i += 2) {
+            state[i + 0] = 1.0f;
+            state[i + 1] = 0.0f;
+        }
+        int centerX{ m_width / 2 };
+        int centerY{ m_height / 2 };
+        int radius{ m_width / 10 };
+        for (int y{ centerY - radius }; y < centerY + radius; ++y) {
+            for (int x{ centerX - radius }; x < centerX + radius; ++x) {
+                int dx{ x - centerX };
+                int dy{ y - centerY };
+                if (dx * dx + dy * dy < radius * radius) {
+                    int idx{ (y * m_width + x) * 2 };
+                    state[idx + 0] = 0.5f + dis(gen);
+                    state[idx + 1] = 0.25f + dis(gen);
+                }
+            }
+        }
+
+        m_initialized = true;
+        for (int member{}; member < m_members; ++member) {
+            if (!loadMember(member, state.data())) {
+                m_initialized = false;
+                return false;
+            }
+        }
+
+        std::cout << "Ensemble initialized\n";
+        std::cout << "  Members: " << m_members << " x " << m_width << "x" << m_height << '\n';
+        std::cout << "  State: " << stateBytes * 2 / (1024 * 1024) << " MB\n";
+        return true;
+    }
+
+    void SimulationEnsemble::setParams(int member, const SimulationParams& params) {
+        if (member < 0 || member >= m_members) { return; }
+        m_params[member] = params;
+        m_paramsDirty = true;
+    }
+
+    bool SimulationEnsemble::uploadParams() {
+        if (!m_paramsDirty) { return true; }
+
+        // Non-blocking: the in-order queue runs it before the next step, and
+        // m_params isn't touched again until the batch is finished
+        cl_int err = clEnqueueWriteBuffer(
+            m_computeManager->getQueue(), m_paramsBuffer, CL_FALSE, 0,
+            sizeof(SimulationParams) * m_members, m_params.data(), 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to upload ensemble parameters! Error: " << err << '\n';
+            return false;
+        }
+        m_paramsDirty = false;
+        return true;
+    }
+
+    bool SimulationEnsemble::step(int iterations) {
+        if (!m_initialized) { return false; }
+        if (iterations < 1) { return true; }
+        if (!uploadParams()) { return false; }
+
+        cl_int err{};
+        err = clSetKernelArg(m_kernel, 2, sizeof(cl_mem), &m_paramsBuffer);
+        err |= clSetKernelArg(m_kernel, 3, sizeof(int), &m_width);
+        err |= clSetKernelArg(m_kernel, 4, sizeof(int), &m_height);
+        err |= clSetKernelArg(m_kernel, 5, sizeof(int), &m_members);
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to set ensemble kernel arguments! Error: " << err << '\n';
+            return false;
+        }
+
+        size_t globalSize[3]{ static_cast<size_t>(m_width), static_cast<size_t>(m_height),
+                              static_cast<size_t>(m_members) };
+        std::vector<cl_event> events{};
+        events.reserve(iterations);
+        bool ok{ true };
+        for (int i{}; i < iterations; ++i) {
+            err = clSetKernelArg(m_kernel, 0, sizeof(cl_mem), &m_bufferCurrent);
+            err |= clSetKernelArg(m_kernel, 1, sizeof(cl_mem), &m_bufferNext);
+            if (err != CL_SUCCESS) {
+                std::cerr << "Failed to set ensemble kernel arguments! Error: " << err << '\n';
+                ok = false;
+                break;
+            }
+
+            cl_event event{};
+            err = clEnqueueNDRangeKernel(m_computeManager->getQueue(), m_kernel, 3, nullptr,
+                                         globalSize, nullptr, 0, nullptr, &event);
+            if (err != CL_SUCCESS) {
+                std::cerr << "Failed to enqueue ensemble kernel! Error: " << err << '\n';
+                ok = false;
+                break;
+            }
+            events.push_back(event);
+            std::swap(m_bufferCurrent, m_bufferNext);
+        }
+
+        // Also where errors of the launches themselves (e.g. a lost device) surface
+        err = clFinish(m_computeManager->getQueue());
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to run ensemble steps! Error: " << err << '\n';
+            ok = false;
+        }
+        if (events.empty()) { return ok; }
+
+        cl_ulong totalTime{};
+        for (cl_event event : events) {
+            cl_ulong timeStart{};
+            cl_ulong timeEnd{};
+            clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(timeStart), &timeStart, nullptr);
+            clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(timeEnd), &timeEnd, nullptr);
+            totalTime += timeEnd - timeStart;
+            clReleaseEvent(event);
+        }
+        m_lastComputeTime = totalTime / 1000000.0f / events.size();
+        return ok;
+    }
+
+    bool SimulationEnsemble::loadMember(int member, const float* data) {
+        if (!m_initialized || member < 0 || member >= m_members) { return false; }
+
+        cl_int err = clEnqueueWriteBuffer(
+            m_computeManager->getQueue(), m_bufferCurrent, CL_TRUE, memberBytes() * member,
+            memberBytes(), data, 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to load ensemble member " << member << "! Error: " << err << '\n';
+            return false;
+        }
+        return true;
+    }
+
+    bool SimulationEnsemble::readMember(int member, float* out) const {
+        if (!m_initialized || member < 0 || member >= m_members) { return false; }
+
+        cl_int err = clEnqueueReadBuffer(
+            m_computeManager->getQueue(), m_bufferCurrent, CL_TRUE, memberBytes() * member,
+            memberBytes(), out, 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to read ensemble member " << member << "! Error: " << err << '\n';
+            return false;
+        }
+        return true;
+    }
+
+    bool SimulationEnsemble::readAll(float* out) const {
+        if (!m_initialized) { return false; }
+
+        cl_int err = clEnqueueReadBuffer(
+            m_computeManager->getQueue(), m_bufferCurrent, CL_TRUE, 0,
+            memberBytes() * m_members, out, 0, nullptr, nullptr);
+        if (err != CL_SUCCESS) {
+            std::cerr << "Failed to read ensemble! Error: " << err << '\n';
+            return false;
+        }
+        return true;
+    }
+
+} // namespace GreyScott
+
+#endif // USE_OPENCL
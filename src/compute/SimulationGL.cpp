@@ -0,0 +1,367 @@
+#ifndef __APPLE__
+
+#include "SimulationGL.hpp"
+#include "DisplayFormatGL.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+
+namespace GreyScott {
+    namespace {
+        constexpr int kLocalSize{ 16 };
+
+        // DISPLAY_FORMAT and COLORMAP are defined in front of this source
+        const char* computeShaderSource = R"(
+layout(local_size_x = 16, local_size_y = 16) in;
+
+layout(std430, binding = 0) readonly buffer Current { vec2 current[]; };
+layout(std430, binding = 1) writeonly buffer Next { vec2 next[]; };
+layout(DISPLAY_FORMAT, binding = 0) uniform writeonly image2D uDisplay;
+
+uniform float uDu;
+uniform float uDv;
+uniform float uF;
+uniform float uK;
+uniform float uDt;
+uniform ivec2 uSize;
+uniform bool uWriteDisplay;
+// False only displays the current state, e.g. after it was uploaded
+uniform bool uUpdateState;
+
+// Same colormap as the renderer's heatMap() function
+vec3 heatMap(float t) {
+    vec3 purple = vec3(0.15, 0.0, 0.2);
+    vec3 green = vec3(0.0, 0.6, 0.2);
+    vec3 yellow = vec3(1.0, 0.95, 0.3);
+
+    t = 1.0 - t;
+
+    if (t < 0.5) {
+        return mix(purple, green, t * 2.0);
+    } else {
+        return mix(green, yellow, (t - 0.5) * 2.0);
+    }
+}
+
+void storeDisplay(ivec2 p, vec2 value) {
+#if COLORMAP
+    imageStore(uDisplay, p, vec4(heatMap(value.x), 1.0));
+#else
+    imageStore(uDisplay, p, vec4(value, 0.0, 1.0));
+#endif
+}
+
+void main() {
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (p.x >= uSize.x || p.y >= uSize.y) return;
+
+    int width = uSize.x;
+    int height = uSize.y;
+    int idx = p.y * width + p.x;
+
+    // Periodic boundary conditions (toroidal topology)
+    int xm1 = (p.x - 1 + width) % width;
+    int xp1 = (p.x + 1) % width;
+    int ym1 = (p.y - 1 + height) % height;
+    int yp1 = (p.y + 1) % height;
+
+    vec2 center = current[idx];
+    if (!uUpdateState) {
+        storeDisplay(p, center);
+        return;
+    }
+
+    vec2 laplacian = current[p.y * width + xm1] + current[p.y * width + xp1] +
+                     current[ym1 * width + p.x] + current[yp1 * width + p.x] -
+                     4.0 * center;
+
+    float u = center.x;
+    float v = center.y;
+    float uvv = u * v * v;
+    float du = uDu * laplacian.x - uvv + uF * (1.0 - u);
+    float dv = uDv * laplacian.y + uvv - (uF + uK) * v;
+
+    vec2 result = clamp(vec2(u + du * uDt, v + dv * uDt), 0.0, 1.0);
+    next[idx] = result;
+
+    if (uWriteDisplay) storeDisplay(p, result);
+}
+)";
+    } // namespace
+
+    SimulationGL::SimulationGL(int width, int height) :
+        m_width{ width },
+        m_height{ height },
+        m_seed{ std::random_device{}() }
+        {
+            m_hostData.resize(width * height * 2);
+        }
+
+    SimulationGL::~SimulationGL() {
+        if (m_program) { glDeleteProgram(m_program); }
+        if (m_bufferCurrent) { glDeleteBuffers(1, &m_bufferCurrent); }
+        if (m_bufferNext) { glDeleteBuffers(1, &m_bufferNext); }
+        if (m_displayTexture) { glDeleteTextures(1, &m_displayTexture); }
+        if (m_timerQueries[0]) { glDeleteQueries(2, m_timerQueries); }
+    }
+
+    void SimulationGL::setDisplayFormat(DisplayFormat format) {
+        if (m_initialized) {
+            std::cerr << "Cannot change display format after initialization!\n";
+            return;
+        }
+
+        m_displayFormat = format;
+    }
+
+    bool SimulationGL::initialize() {
+        if (!GLEW_VERSION_4_3 && !GLEW_ARB_compute_shader) {
+            std::cerr << "Compute shaders not supported (needs OpenGL 4.3)!\n";
+            return false;
+        }
+
+        if (!createProgram()) { return false; }
+
+        GLsizeiptr size{ static_cast<GLsizeiptr>(sizeof(float)) * m_width * m_height * 2 };
+        glGenBuffers(1, &m_bufferCurrent);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferCurrent);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_COPY);
+        glGenBuffers(1, &m_bufferNext);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferNext);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        // Immutable storage is required for image load/store
+        GLTextureFormat format{ glTextureFormat(m_displayFormat) };
+        glGenTextures(1, &m_displayTexture);
+        glBindTexture(GL_TEXTURE_2D, m_displayTexture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, format.internalFormat, m_width, m_height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        glGenQueries(2, m_timerQueries);
+
+        GLenum error{ glGetError() };
+        if (error != GL_NO_ERROR) {
+            std::cerr << "Failed to create compute resources! OpenGL error: "
+                      << error << '\n';
+            return false;
+        }
+
+        initializeState();
+
+        std::cout << "GL compute simulation initialized\n";
+        std::cout << "  Grid: " << m_width << "x" << m_height << '\n';
+        std::cout << "  Display format: " << displayFormatName(m_displayFormat) << '\n';
+
+        m_initialized = true;
+        return true;
+    }
+
+    bool SimulationGL::createProgram() {
+        GLTextureFormat format{ glTextureFormat(m_displayFormat) };
+        std::string source{ "#version 430 core\n" };
+        source += std::string{ "#define DISPLAY_FORMAT " } + format.imageFormat + '\n';
+        source += m_displayFormat == DisplayFormat::RGBA8 ? "#define COLORMAP 1\n"
+                                                          : "#define COLORMAP 0\n";
+        source += computeShaderSource;
+
+        GLint success{};
+        GLchar infoLog[512]{};
+        const char* sourcePtr{ source.c_str() };
+
+        GLuint shader{ glCreateShader(GL_COMPUTE_SHADER) };
+        glShaderSource(shader, 1, &sourcePtr, nullptr);
+        glCompileShader(shader);
+
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+            std::cerr << "Compute shader compilation failed:\n" << infoLog << '\n';
+            glDeleteShader(shader);
+            return false;
+        }
+
+        m_program = glCreateProgram();
+        glAttachShader(m_program, shader);
+        glLinkProgram(m_program);
+        glDeleteShader(shader);
+
+        glGetProgramiv(m_program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glGetProgramInfoLog(m_program, 512, nullptr, infoLog);
+            std::cerr << "Compute program linking failed:\n" << infoLog << '\n';
+            return false;
+        }
+
+        return true;
+    }
+
+    void SimulationGL::initializeState() {
+        std::mt19937 gen(m_seed);
+        std::uniform_real_distribution<float> dis(-0.05f, 0.05f);
+
+        for (int i{}; i < m_width * m_height * 2; i += 2) {
+            m_hostData[i + 0] = 1.0f;
+            m_hostData[i + 1] = 0.0f;
+        }
+
+        int centerX{ m_width / 2 };
+        int centerY{ m_height / 2 };
+        int radius{ m_width / 10 };
+
+        for (int y{ centerY - radius }; y < centerY + radius; ++y) {
+            for (int x{ centerX - radius }; x < centerX + radius; ++x) {
+                int dx{ x - centerX };
+                int dy{ y - centerY };
+                if (dx * dx + dy * dy < radius * radius) {
+                    int idx{ (y * m_width + x) * 2 };
+                    m_hostData[idx + 0] = 0.5f + dis(gen);
+                    m_hostData[idx + 1] = 0.25f + dis(gen);
+                }
+            }
+        }
+
+        syncFrom(m_hostData.data());
+    }
+
+    void SimulationGL::step(int iterations) {
+        if (!m_initialized || iterations < 1) { return; }
+
+        collectTiming();
+
+        glUseProgram(m_program);
+        glUniform1f(glGetUniformLocation(m_program, "uDu"), m_params.Du);
+        glUniform1f(glGetUniformLocation(m_program, "uDv"), m_params.Dv);
+        glUniform1f(glGetUniformLocation(m_program, "uF"), m_params.F);
+        glUniform1f(glGetUniformLocation(m_program, "uK"), m_params.k);
+        glUniform1f(glGetUniformLocation(m_program, "uDt"), m_params.dt);
+        glUniform2i(glGetUniformLocation(m_program, "uSize"), m_width, m_height);
+        glUniform1i(glGetUniformLocation(m_program, "uUpdateState"), GL_TRUE);
+        GLint writeDisplay{ glGetUniformLocation(m_program, "uWriteDisplay") };
+
+        GLTextureFormat format{ glTextureFormat(m_displayFormat) };
+        glBindImageTexture(0, m_displayTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY,
+                           format.internalFormat);
+
+        GLuint groupsX{ static_cast<GLuint>((m_width + kLocalSize - 1) / kLocalSize) };
+        GLuint groupsY{ static_cast<GLuint>((m_height + kLocalSize - 1) / kLocalSize) };
+
+        glBeginQuery(GL_TIME_ELAPSED, m_timerQueries[m_timerIndex]);
+        for (int i{}; i < iterations; ++i) {
+            // Only the last step of the batch is displayed
+            glUniform1i(writeDisplay, i == iterations - 1);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_bufferCurrent);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_bufferNext);
+            glDispatchCompute(groupsX, groupsY, 1);
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+            std::swap(m_bufferCurrent, m_bufferNext);
+        }
+        glEndQuery(GL_TIME_ELAPSED);
+        m_timerSteps[m_timerIndex] = iterations;
+        m_timerIndex = 1 - m_timerIndex;
+
+        // The renderer samples the display texture next
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+        glUseProgram(0);
+    }
+
+    void SimulationGL::collectTiming() {
+        // Read the batch before last; it has normally finished by now
+        GLuint query{ m_timerQueries[m_timerIndex] };
+        if (m_timerSteps[m_timerIndex] == 0) { return; }
+
+        GLint available{};
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) { return; }
+
+        GLuint64 elapsedNs{};
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+        m_lastComputeTime = elapsedNs / 1000000.0f / m_timerSteps[m_timerIndex];
+        m_timerSteps[m_timerIndex] = 0;
+    }
+
+    void SimulationGL::reset() {
+        // Every reset draws a new pattern; the seed is kept for reproduction
+        m_seed = std::random_device{}();
+        initializeState();
+    }
+
+    void SimulationGL::syncFrom(const float* data) {
+        if (data != m_hostData.data()) {
+            std::copy(data, data + m_width * m_height * 2, m_hostData.begin());
+        }
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferCurrent);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0,
+                        static_cast<GLsizeiptr>(sizeof(float)) * m_width * m_height * 2,
+                        m_hostData.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        // Otherwise a paused simulation shows the state from before the upload
+        writeDisplay();
+    }
+
+    void SimulationGL::writeDisplay() {
+        if (!m_program || !m_displayTexture) { return; }
+
+        glUseProgram(m_program);
+        glUniform2i(glGetUniformLocation(m_program, "uSize"), m_width, m_height);
+        glUniform1i(glGetUniformLocation(m_program, "uUpdateState"), GL_FALSE);
+        glUniform1i(glGetUniformLocation(m_program, "uWriteDisplay"), GL_TRUE);
+
+        GLTextureFormat format{ glTextureFormat(m_displayFormat) };
+        glBindImageTexture(0, m_displayTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY,
+                           format.internalFormat);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_bufferCurrent);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_bufferNext);
+        glDispatchCompute(static_cast<GLuint>((m_width + kLocalSize - 1) / kLocalSize),
+                          static_cast<GLuint>((m_height + kLocalSize - 1) / kLocalSize), 1);
+
+        glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+        glUseProgram(0);
+    }
+
+    void SimulationGL::forceReadBack() {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferCurrent);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0,
+                           static_cast<GLsizeiptr>(sizeof(float)) * m_width * m_height * 2,
+                           m_hostData.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    void SimulationGL::loadPreset(int presetIndex) {
+        switch (presetIndex) {
+        case 1:
+            m_params.F = 0.055f;
+            m_params.k = 0.062f;
+            break;
+        case 2:
+            m_params.F = 0.039f;
+            m_params.k = 0.058f;
+            break;
+        case 3:
+            m_params.F = 0.026f;
+            m_params.k = 0.051f;
+            break;
+        case 4:
+            m_params.F = 0.018f;
+            m_params.k = 0.051f;
+            break;
+        case 5:
+            m_params.F = 0.014f;
+            m_params.k = 0.047f;
+            break;
+        default:
+            break;
+        }
+    }
+
+} // namespace GreyScott
+
+#endif // __APPLE__
@@ -2,18 +2,34 @@
 #include <GL/glew.h>
 // Note: GL/gl.h is included by glew.h
 #include "Application.hpp"
+#include "Checkpoint.hpp"
+#include "ControlServer.hpp"
+#include "FrameProfiler.hpp"
+#include "GpuTimer.hpp"
 #ifdef USE_OPENCL
 #include "ComputeManager.hpp"
 #include "Simulation.hpp"
 #endif
 #include "Renderer.hpp"
 #include "SimulationCPU.hpp"
+#ifndef __APPLE__
+#include "SimulationGL.hpp"
+#endif
 #include "SimulationParams.hpp"
+#include "SimulationThread.hpp"
+#include "FrameExporter.hpp"
+#include "SharedFrameRing.hpp"
+#include "SnapshotWriter.hpp"
+#include "TimeSeries.hpp"
 #include <imgui.h>
 #include <imgui_impl_sdl2.h>
 #include <imgui_impl_opengl3.h>
 #include <iostream>
 #include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <future>
+#include <sstream>
 // clang-format on
 
 // Platform-specific OpenGL version
@@ -37,13 +53,31 @@ namespace GreyScott {
         m_lastFrameTime{ 0 },
         m_frameCount{ 0 },
         m_fpsTimer{ 0.0f }
-        {}
+        {
+            m_autoStepsPerFrame = config.stepsPerFrame <= 0;
+            m_stepsPerFrame = std::clamp(config.stepsPerFrame, 1, Config::maxStepsPerFrame);
+        }
 
     Application::~Application() {
+        // Requests in flight still reach the simulation thread
+        m_controlServer.reset();
+        // The simulation thread uses the engines, stop it before they go away
+        m_simThread.reset();
+        // Pending readbacks are waited for on the engines' queues
+        m_snapshotWriter.reset();
+        m_timeSeries.reset();
+        m_frameExporter.reset();
+        m_sharedFrames.reset();
+
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplSDL2_Shutdown();
         ImGui::DestroyContext();
 
+        // Own GL objects, release them while the context is still current
+        m_gpuTimer.reset();
+#ifndef __APPLE__
+        m_simulationGL.reset();
+#endif
         if (m_glContext) { SDL_GL_DeleteContext(m_glContext); }
         if (m_window) { SDL_DestroyWindow(m_window); }
         SDL_Quit();
@@ -55,18 +89,39 @@ namespace GreyScott {
             return false;
         }
 
+        // A resumed run takes its grid size from the checkpoint
+        if (!m_config.restorePath.empty()) {
+            MappedCheckpoint checkpoint{};
+            if (!checkpoint.open(m_config.restorePath)) { return false; }
+            m_config.gridWidth = checkpoint.getInfo().width;
+            m_config.gridHeight = checkpoint.getInfo().height;
+        }
+
         if (!initSDL()) { return false; }
         if (!initOpenGL()) { return false; }
 
+        m_profiler = std::make_unique<FrameProfiler>();
+        m_gpuTimer = std::make_unique<GpuTimer>(m_profiler.get());
+        m_gpuTimer->initialize();
+
+        // Grids beyond the texture size limit can only be streamed as tiles,
+        // which rules out rendering from a texture owned by an engine
+        GLint maxTextureSize{};
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+        bool tiledView{ m_config.tiledView || m_config.gridWidth > maxTextureSize ||
+                        m_config.gridHeight > maxTextureSize };
+
 #ifdef USE_OPENCL
         m_computeManager = std::make_unique<ComputeManager>();
-        if (!m_computeManager->initialize()) {
+        // The simulation thread has no GL context, so it can't use interop
+        if (!m_computeManager->initialize(!m_config.simulationThread && !tiledView)) {
             std::cerr << "Failed to initialize compute manager!\n";
             return false;
         }
         
         m_simulation = std::make_unique<Simulation>(
             m_config.gridWidth, m_config.gridHeight, m_computeManager.get());
+        m_simulation->setDisplayFormat(m_config.displayFormat);
         if (!m_simulation->initialize()) {
             std::cerr << "Failed to initialize simulation!\n";
             return false;
@@ -75,6 +130,15 @@ namespace GreyScott {
 
         m_renderer =
             std::make_unique<Renderer>(m_config.gridWidth, m_config.gridHeight);
+#ifdef USE_OPENCL
+        // The device may have fallen back to RG32F; CPU conversion follows suit
+        m_renderer->setDisplayFormat(m_simulation->getDisplayFormat());
+#else
+        m_renderer->setDisplayFormat(m_config.displayFormat);
+#endif
+        m_renderer->setTiledView(tiledView);
+        m_displayData.resize(displayBytesPerTexel(m_renderer->getDisplayFormat()) *
+                             static_cast<size_t>(m_config.gridWidth) * m_config.gridHeight);
             
 #ifdef USE_OPENCL
         if (m_simulation->usesGLInterop()) {
@@ -95,12 +159,91 @@ namespace GreyScott {
             m_config.gridWidth, m_config.gridHeight);
         m_simulationCPU->initialize();
 
-#ifndef USE_OPENCL
-        // Force CPU mode when OpenCL is not available
-        m_useCPU = true;
-        std::cout << "OpenCL not available - using CPU-only mode\n";
+#ifndef __APPLE__
+        // Needs the GL context, so it can only step on this thread, and
+        // renders from its own full-size texture
+        if (!m_config.simulationThread && !tiledView) {
+            m_simulationGL = std::make_unique<SimulationGL>(
+                m_config.gridWidth, m_config.gridHeight);
+            m_simulationGL->setDisplayFormat(m_renderer->getDisplayFormat());
+            if (!m_simulationGL->initialize()) {
+                std::cerr << "GL compute backend not available\n";
+                m_simulationGL.reset();
+            }
+        }
 #endif
 
+        m_backend = m_config.backend;
+        if (!isBackendAvailable(m_backend)) {
+            Backend fallback{ isBackendAvailable(Backend::OpenCL) ? Backend::OpenCL
+                                                                  : Backend::CPU };
+            std::cout << backendName(m_backend) << " not available - using "
+                      << backendName(fallback) << '\n';
+            m_backend = fallback;
+        }
+
+        FileWriterOptions fileOptions{};
+        fileOptions.mode = m_config.ioMode;
+        fileOptions.queueDepth = m_config.ioQueueDepth;
+        m_checkpointWriter = std::make_unique<CheckpointWriter>(fileOptions);
+        if (m_config.snapshotInterval > 0) {
+            SnapshotOptions options{};
+            options.io = fileOptions;
+            options.prefix = m_config.snapshotPrefix;
+            options.interval = m_config.snapshotInterval;
+            options.buffers = m_config.snapshotBuffers;
+            options.threads = m_config.snapshotThreads;
+            options.backpressure = m_config.snapshotBackpressure;
+
+            SnapshotWriter::WriteFunction write{};
+            if (!m_config.snapshotSeries.empty()) {
+                TimeSeriesOptions seriesOptions{};
+                seriesOptions.errorBound = m_config.snapshotErrorBound;
+                seriesOptions.keyframeInterval = m_config.snapshotKeyframeInterval;
+                seriesOptions.io = fileOptions;
+                m_timeSeries = std::make_unique<TimeSeriesWriter>();
+                if (!m_timeSeries->open(m_config.snapshotSeries, m_config.gridWidth,
+                                        m_config.gridHeight, seriesOptions)) {
+                    return false;
+                }
+
+                // Frames are delta-encoded in order, so one writer appends;
+                // the tiles of a frame are still encoded in parallel
+                options.threads = 1;
+                write = [this](const CheckpointInfo& info, const float* field) {
+                    return m_timeSeries->append(info, field);
+                };
+            }
+            m_snapshotWriter = std::make_unique<SnapshotWriter>(
+                options, static_cast<size_t>(m_config.gridWidth) * m_config.gridHeight * 2,
+                std::move(write));
+        }
+        if (!m_config.recordTarget.empty()) {
+            FrameExportOptions options{};
+            options.io = fileOptions;
+            options.format = m_config.recordFormat;
+            options.target = m_config.recordTarget;
+            options.interval = m_config.recordInterval;
+            options.buffers = m_config.recordBuffers;
+            options.threads = m_config.recordThreads;
+            options.backpressure = m_config.recordBackpressure;
+            m_frameExporter = std::make_unique<FrameExporter>();
+            if (!m_frameExporter->open(options, m_config.gridWidth, m_config.gridHeight)) {
+                return false;
+            }
+            m_recording = true;
+        }
+        if (!m_config.shmName.empty()) {
+            m_sharedFrames = std::make_unique<SharedFramePublisher>();
+            if (!m_sharedFrames->open(m_config.shmName, m_config.gridWidth,
+                                      m_config.gridHeight, m_config.shmSlots)) {
+                return false;
+            }
+        }
+        if (!m_config.restorePath.empty() && !loadCheckpoint(m_config.restorePath)) {
+            return false;
+        }
+
         IMGUI_CHECKVERSION();
         ImGui::CreateContext();
         ImGuiIO& io{ ImGui::GetIO() };
@@ -111,11 +254,33 @@ namespace GreyScott {
         ImGui_ImplSDL2_InitForOpenGL(m_window, m_glContext);
         ImGui_ImplOpenGL3_Init(GLSL_VERSION_STRING);
 
+        if (m_config.simulationThread) {
+            m_simThread = std::make_unique<SimulationThread>(
+                [this](int steps) { return stepActiveEngine(steps); },
+                [this](SimulationFrame& frame) { publishFrame(frame); },
+                [] { wakeRenderThread(); });
+            m_simThread->setTargetRate(m_config.targetStepRate);
+            m_simThread->setStepCount(m_stepCount);
+        }
+
+        // Last, so requests find the simulation thread in place
+        if (!m_config.controlSocket.empty()) {
+            m_controlServer = std::make_unique<ControlServer>();
+            if (!m_controlServer->start(m_config.controlSocket,
+                                        [this](const std::vector<std::string>& words) {
+                                            return handleControl(words);
+                                        })) {
+                return false;
+            }
+        }
+
         std::cout << "Application initialized successfully\n";
         std::cout << "  Window: " << m_config.windowWidth << "x"
                   << m_config.windowHeight << '\n';
         std::cout << "  Grid: " << m_config.gridWidth << "x"
                   << m_config.gridHeight << '\n';
+        std::cout << "  Simulation thread: "
+                  << (m_simThread ? "enabled" : "disabled") << '\n';
 
         m_initialized = true;
         return true;
@@ -151,6 +316,12 @@ namespace GreyScott {
             return false;
         }
 
+        // The governor fits a frame's steps into one refresh interval
+        SDL_DisplayMode mode{};
+        if (SDL_GetWindowDisplayMode(m_window, &mode) == 0 && mode.refresh_rate > 0) {
+            m_framePeriodMs = 1000.0f / mode.refresh_rate;
+        }
+
         std::cout << "SDL initialized successfully\n";
         return true;
     }
@@ -206,122 +377,143 @@ namespace GreyScott {
         m_lastFrameTime = SDL_GetPerformanceCounter();
 
         std::cout << "Starting main loop...\n";
+        if (m_simThread) { m_simThread->start(); }
 
         while (m_running) {
+            if (isIdle()) {
+                // Nothing would change on screen: sleep until input arrives
+                // or the simulation thread publishes a frame
+                SDL_WaitEventTimeout(nullptr, Config::idleWaitMs);
+            }
+
             // Calculate delta time
             uint64_t currentTime{ SDL_GetPerformanceCounter() };
             float deltaTime{ (currentTime - m_lastFrameTime) /
                               (float)SDL_GetPerformanceFrequency() };
             m_lastFrameTime = currentTime;
 
-            handleEvents();
+            {
+                ScopedTimer timer{ m_profiler.get(), FramePhase::Events };
+                handleEvents();
+            }
+
+            // A hidden window draws nothing; only lockstep stepping goes on,
+            // while the simulation thread runs regardless
+            if (!m_windowVisible) {
+                if (!m_simThread) {
+                    update(deltaTime);
+                    // No swap to block on: wait out the rest of the frame,
+                    // still waking up early for input
+                    uint64_t elapsedMs{ (SDL_GetPerformanceCounter() - currentTime) * 1000 /
+                                        SDL_GetPerformanceFrequency() };
+                    if (!isIdle() && elapsedMs < Config::hiddenFrameMs) {
+                        SDL_WaitEventTimeout(
+                            nullptr, Config::hiddenFrameMs - static_cast<int>(elapsedMs));
+                    }
+                }
+                continue;
+            }
+
             update(deltaTime);
             render();
 
             // Swap buffers
-            SDL_GL_SwapWindow(m_window);
+            {
+                ScopedTimer timer{ m_profiler.get(), FramePhase::Swap };
+                SDL_GL_SwapWindow(m_window);
+            }
+            if (m_pendingRedraws > 0) { --m_pendingRedraws; }
         }
 
+        if (m_simThread) { m_simThread->stop(); }
+        m_stepBudget.interrupt();
         std::cout << "Main loop ended\n";
     }
 
+    bool Application::isIdle() const {
+        bool lockstepIdle{ m_paused && !m_stepBudget.active() };
+        if (!m_windowVisible) { return m_simThread || lockstepIdle; }
+        if (m_pendingRedraws > 0) { return false; }
+        // The screen only changes when the simulation thread publishes
+        if (m_simThread) { return !m_simThread->hasNewFrame(); }
+        return lockstepIdle;
+    }
+
     void Application::handleEvents() {
         SDL_Event event{};
         while (SDL_PollEvent(&event)) {
             ImGui_ImplSDL2_ProcessEvent(&event);
+            m_pendingRedraws = 2;
 
             switch (event.type) {
             case SDL_QUIT: quit(); break;
 
+            case SDL_WINDOWEVENT:
+                switch (event.window.event) {
+                case SDL_WINDOWEVENT_HIDDEN:
+                case SDL_WINDOWEVENT_MINIMIZED: m_windowVisible = false; break;
+                case SDL_WINDOWEVENT_SHOWN:
+                case SDL_WINDOWEVENT_EXPOSED:
+                case SDL_WINDOWEVENT_RESTORED:
+                case SDL_WINDOWEVENT_MAXIMIZED: m_windowVisible = true; break;
+                default: break;
+                }
+                break;
+
+            case SDL_MOUSEWHEEL: {
+                if (ImGui::GetIO().WantCaptureMouse || event.wheel.y == 0) { break; }
+
+                // Zoom around the cursor; window y grows downwards
+                int x{}, y{};
+                SDL_GetMouseState(&x, &y);
+                m_renderer->zoomAt(static_cast<float>(x) / m_config.windowWidth,
+                                   1.0f - static_cast<float>(y) / m_config.windowHeight,
+                                   event.wheel.y > 0 ? 0.8f : 1.25f);
+                break;
+            }
+
+            case SDL_MOUSEMOTION:
+                if (ImGui::GetIO().WantCaptureMouse ||
+                    !(event.motion.state & SDL_BUTTON_LMASK)) {
+                    break;
+                }
+                m_renderer->pan(static_cast<float>(event.motion.xrel) / m_config.windowWidth,
+                                -static_cast<float>(event.motion.yrel) / m_config.windowHeight);
+                break;
+
             case SDL_KEYDOWN:
                 switch (event.key.keysym.sym) {
                 case SDLK_ESCAPE: quit(); break;
+                case SDLK_HOME: m_renderer->resetView(); break;
                 case SDLK_r:
-#ifdef USE_OPENCL
-                    if (!m_useCPU && m_simulation) {
-                        m_simulation->reset();
-                    } else
-#endif
-                    if (m_simulationCPU) {
-                        m_simulationCPU->reset();
+                    runOnSimulation([this] {
+                        withActiveEngine([](auto& engine) { engine.reset(); });
+                        std::cout << "Simulation reset\n";
+                    });
+                    break;
+                case SDLK_t: exportTrace(); break;
+                case SDLK_s: runOnSimulation([this] { saveCheckpoint(); }); break;
+                case SDLK_v:
+                    if (m_frameExporter) {
+                        m_recording = !m_recording;
+                        std::cout << (m_recording ? "Recording resumed\n" : "Recording paused\n");
                     }
-                    std::cout << "Simulation reset\n";
                     break;
-                case SDLK_SPACE:
-                    m_paused = !m_paused;
-                    std::cout << (m_paused ? "Paused\n" : "Resumed\n");
+                case SDLK_l:
+                    runOnSimulation([this] { loadCheckpoint(m_config.checkpointPath); });
                     break;
+                case SDLK_SPACE: setPaused(!m_paused); break;
                 case SDLK_UP:
-#ifdef USE_OPENCL
-                    if (!m_useCPU && m_simulation) {
-                        auto params{ m_simulation->getParams() };
-                        params.F += 0.001f;
-                        params.F = std::min(params.F, 0.1f);
-                        m_simulation->setParams(params);
-                        std::cout << "F = " << params.F << '\n';
-                    } else
-#endif
-                    if (m_simulationCPU) {
-                        auto params{ m_simulationCPU->getParams() };
-                        params.F += 0.001f;
-                        params.F = std::min(params.F, 0.1f);
-                        m_simulationCPU->setParams(params);
-                        std::cout << "F = " << params.F << '\n';
-                    }
+                    adjustParams(0.001f, 0.0f);
                     break;
                 case SDLK_DOWN:
-#ifdef USE_OPENCL
-                    if (!m_useCPU && m_simulation) {
-                        auto params{ m_simulation->getParams() };
-                        params.F -= 0.001f;
-                        params.F = std::max(params.F, 0.0f);
-                        m_simulation->setParams(params);
-                        std::cout << "F = " << params.F << '\n';
-                    } else
-#endif
-                    if (m_simulationCPU) {
-                        auto params{ m_simulationCPU->getParams() };
-                        params.F -= 0.001f;
-                        params.F = std::max(params.F, 0.0f);
-                        m_simulationCPU->setParams(params);
-                        std::cout << "F = " << params.F << '\n';
-                    }
+                    adjustParams(-0.001f, 0.0f);
                     break;
                 case SDLK_RIGHT:
-#ifdef USE_OPENCL
-                    if (!m_useCPU && m_simulation) {
-                        auto params{ m_simulation->getParams() };
-                        params.k += 0.001f;
-                        params.k = std::min(params.k, 0.1f);
-                        m_simulation->setParams(params);
-                        std::cout << "k = " << params.k << '\n';
-                    } else
-#endif
-                    if (m_simulationCPU) {
-                        auto params{ m_simulationCPU->getParams() };
-                        params.k += 0.001f;
-                        params.k = std::min(params.k, 0.1f);
-                        m_simulationCPU->setParams(params);
-                        std::cout << "k = " << params.k << '\n';
-                    }
+                    adjustParams(0.0f, 0.001f);
                     break;
                 case SDLK_LEFT:
-#ifdef USE_OPENCL
-                    if (!m_useCPU && m_simulation) {
-                        auto params{ m_simulation->getParams() };
-                        params.k -= 0.001f;
-                        params.k = std::max(params.k, 0.0f);
-                        m_simulation->setParams(params);
-                        std::cout << "k = " << params.k << '\n';
-                    } else
-#endif
-                    if (m_simulationCPU) {
-                        auto params{ m_simulationCPU->getParams() };
-                        params.k -= 0.001f;
-                        params.k = std::max(params.k, 0.0f);
-                        m_simulationCPU->setParams(params);
-                        std::cout << "k = " << params.k << '\n';
-                    }
+                    adjustParams(0.0f, -0.001f);
                     break;
                 case SDLK_F1:
                 case SDLK_F2:
@@ -329,31 +521,28 @@ namespace GreyScott {
                 case SDLK_F4:
                 case SDLK_F5: {
                     int preset = event.key.keysym.sym - SDLK_F1 + 1;
-#ifdef USE_OPENCL
-                    if (!m_useCPU && m_simulation) {
-                        m_simulation->loadPreset(preset);
-                    } else
-#endif
-                    if (m_simulationCPU) {
-                        m_simulationCPU->loadPreset(preset);
-                    }
-                    const char* presetNames[] = { "", "Spots", "Stripes", "Waves", "Chaos", "Holes" };
-                    std::cout << "Loaded preset " << preset << ": " << presetNames[preset] << '\n';
+                    runOnSimulation([this, preset] {
+                        withActiveEngine([preset](auto& engine) { engine.loadPreset(preset); });
+                        const char* presetNames[] = { "", "Spots", "Stripes", "Waves", "Chaos", "Holes" };
+                        std::cout << "Loaded preset " << preset << ": " << presetNames[preset] << '\n';
+                    });
                     break;
                 }
                 case SDLK_c:
-#ifdef USE_OPENCL
-                    if (m_useCPU) {
-                        m_simulation->syncFrom(m_simulationCPU->getData());
-                    } else {
-                        m_simulation->forceReadBack();
-                        m_simulationCPU->syncFrom(m_simulation->getData());
-                    }
-                    m_useCPU = !m_useCPU;
-                    std::cout << "Switched to " << (m_useCPU ? "CPU" : "GPU") << " mode\n";
-#else
-                    std::cout << "OpenCL not available - CPU-only mode\n";
-#endif
+                    runOnSimulation([this] {
+                        // Cycle through the backends this build and mode can run
+                        Backend next{ m_backend.load() };
+                        do {
+                            next = static_cast<Backend>((static_cast<int>(next) + 1) %
+                                                        static_cast<int>(Backend::Count));
+                        } while (!isBackendAvailable(next));
+
+                        if (next == m_backend) {
+                            std::cout << "No other backend available\n";
+                        } else {
+                            switchBackend(next);
+                        }
+                    });
                     break;
                 default: break;
                 }
@@ -364,24 +553,506 @@ namespace GreyScott {
         }
     }
 
-    void Application::update(float deltaTime) {
-        if (!m_paused) {
+    void Application::runOnSimulation(std::function<void()> command) {
+        // Engines belong to the simulation thread while it is running
+        if (m_simThread) {
+            m_simThread->post(std::move(command));
+        } else {
+            command();
+        }
+    }
+
+    void Application::wakeRenderThread() {
+        // Ends SDL_WaitEvent early; the event itself is ignored
+        SDL_Event event{};
+        event.type = SDL_USEREVENT;
+        SDL_PushEvent(&event);
+    }
+
+    void Application::setPaused(bool paused) {
+        m_paused = paused;
+        m_pauseGeneration.fetch_add(1);
+        if (m_simThread) { m_simThread->setPaused(paused); }
+        wakeRenderThread();
+        std::cout << (paused ? "Paused\n" : "Resumed\n");
+    }
+
+    bool Application::runPendingCommands() {
+        bool ran{};
+        std::function<void()> command{};
+        while (m_pendingCommands.pop(command)) {
+            command();
+            ran = true;
+        }
+        return ran;
+    }
+
+    ControlServer::Reply Application::runControl(std::function<std::string()> command) {
+        auto task{ std::make_shared<std::packaged_task<std::string()>>(std::move(command)) };
+        ControlServer::Reply reply{ task->get_future() };
+        if (m_simThread) {
+            m_simThread->post([task] { (*task)(); });
+        } else {
+            // Lockstep engines belong to the render thread
+            m_pendingCommands.push([task] { (*task)(); });
+            wakeRenderThread();
+        }
+        return reply;
+    }
+
+    ControlServer::Reply Application::handleControl(const std::vector<std::string>& words) {
+        const std::string& name{ words[0] };
+        size_t arguments{ words.size() - 1 };
+
+        if (name == "help") {
+            return ControlServer::ready(
+                "ok commands: set F|k|Du|Dv|dt VALUE..., preset 1-5, step N, pause, resume, "
+                "reset, snapshot [PATH], stats");
+        }
+        if (name == "pause" || name == "resume") {
+            setPaused(name == "pause");
+            return ControlServer::ready(m_paused ? "ok paused" : "ok running");
+        }
+        if (name == "stats") {
+            return runControl([this] {
+                std::ostringstream reply{};
+                reply << "ok step=" << m_stepCount.load() << " backend=" << backendName(m_backend)
+                      << " paused=" << (m_paused ? 1 : 0) << " fps=" << m_currentFps.load();
+                if (m_simThread) { reply << " steps_per_s=" << m_simThread->getStepsPerSecond(); }
+                withActiveEngine([&reply](auto& engine) {
+                    SimulationParams params{ engine.getParams() };
+                    reply << " F=" << params.F << " k=" << params.k << " Du=" << params.Du
+                          << " Dv=" << params.Dv << " dt=" << params.dt;
+                });
+                return reply.str();
+            });
+        }
+        if (name == "reset" && arguments == 0) {
+            return runControl([this] {
+                withActiveEngine([](auto& engine) { engine.reset(); });
+                return std::string{ "ok reset" };
+            });
+        }
+        if (name == "snapshot" && arguments <= 1) {
+            std::string path{ arguments == 1 ? words[1] : m_config.checkpointPath };
+            return runControl([this, path] {
+                CheckpointInfo info{ describeState() };
+                m_checkpointWriter->save(path, info, readEngineState(m_backend));
+                return "ok snapshot " + path + " step=" + std::to_string(info.step);
+            });
+        }
+
+        // The rest take numbers
+        std::vector<double> values{};
+        try {
+            for (size_t i{ 1 }; i < words.size(); ++i) {
+                if (name == "set" && i % 2 == 1) { continue; } // Parameter names
+                double value{ std::stod(words[i]) };
+                if (!std::isfinite(value)) { throw std::invalid_argument{ words[i] }; }
+                values.push_back(value);
+            }
+        } catch (const std::exception&) {
+            return ControlServer::ready("error invalid number in '" + name + "'");
+        }
+
+        if (name == "preset" && arguments == 1) {
+            int preset{ static_cast<int>(values[0]) };
+            if (preset < 1 || preset > 5) {
+                return ControlServer::ready("error preset must be 1-5");
+            }
+            return runControl([this, preset] {
+                withActiveEngine([preset](auto& engine) { engine.loadPreset(preset); });
+                return "ok preset " + std::to_string(preset);
+            });
+        }
+        if (name == "step" && arguments == 1) {
+            if (values[0] < 1.0 || values[0] > 1e12) {
+                return ControlServer::ready("error step count must be between 1 and 1e12");
+            }
+            auto steps{ static_cast<uint64_t>(values[0]) };
+            // Taken in batches between other commands and frames; replies
+            // once they are done, or interrupted by pause/resume or a newer
+            // step request
+            auto reply{ std::make_shared<std::promise<std::string>>() };
+            ControlServer::Reply future{ reply->get_future() };
+            StepBudget::Done done{ [this, reply](bool completed) {
+                reply->set_value((completed ? "ok step=" : "error step interrupted at step=") +
+                                 std::to_string(m_stepCount.load()));
+            } };
+            if (m_simThread) {
+                m_simThread->stepBy(steps, Config::maxStepsPerFrame, std::move(done));
+            } else {
+                uint64_t generation{ m_pauseGeneration.load() };
+                m_pendingCommands.push([this, steps, generation, done]() mutable {
+                    m_stepBudget.start(steps, Config::maxStepsPerFrame, generation,
+                                       std::move(done));
+                });
+                wakeRenderThread();
+            }
+            return future;
+        }
+        if (name == "set" && arguments > 0 && arguments % 2 == 0) {
+            std::vector<std::string> names{};
+            for (size_t i{ 1 }; i < words.size(); i += 2) {
+                const std::string& parameter{ words[i] };
+                if (parameter != "F" && parameter != "k" && parameter != "Du" &&
+                    parameter != "Dv" && parameter != "dt") {
+                    return ControlServer::ready("error unknown parameter '" + parameter + "'");
+                }
+                names.push_back(parameter);
+            }
+            return runControl([this, names, values] {
+                SimulationParams params{};
+                withActiveEngine([&](auto& engine) {
+                    params = engine.getParams();
+                    for (size_t i{}; i < names.size(); ++i) {
+                        auto value{ static_cast<float>(values[i]) };
+                        if (names[i] == "F") { params.F = value; }
+                        else if (names[i] == "k") { params.k = value; }
+                        else if (names[i] == "Du") { params.Du = value; }
+                        else if (names[i] == "Dv") { params.Dv = value; }
+                        else { params.dt = value; }
+                    }
+                    engine.setParams(params);
+                });
+                std::ostringstream reply{};
+                reply << "ok F=" << params.F << " k=" << params.k << " Du=" << params.Du
+                      << " Dv=" << params.Dv << " dt=" << params.dt;
+                return reply.str();
+            });
+        }
+        return ControlServer::ready("error unknown or malformed command '" + name +
+                                    "' (try help)");
+    }
+
+    void Application::adjustParams(float deltaF, float deltaK) {
+        runOnSimulation([this, deltaF, deltaK] {
+            withActiveEngine([deltaF, deltaK](auto& engine) {
+                SimulationParams params{ engine.getParams() };
+                params.F = std::clamp(params.F + deltaF, 0.0f, 0.1f);
+                params.k = std::clamp(params.k + deltaK, 0.0f, 0.1f);
+                engine.setParams(params);
+
+                if (deltaF != 0.0f) { std::cout << "F = " << params.F << '\n'; }
+                if (deltaK != 0.0f) { std::cout << "k = " << params.k << '\n'; }
+            });
+        });
+    }
+
+    template <typename Function>
+    void Application::withActiveEngine(Function&& function) {
+        switch (m_backend.load()) {
+#ifdef USE_OPENCL
+        case Backend::OpenCL:
+            if (m_simulation) { function(*m_simulation); return; }
+            break;
+#endif
+#ifndef __APPLE__
+        case Backend::GLCompute:
+            if (m_simulationGL) { function(*m_simulationGL); return; }
+            break;
+#endif
+        default: break;
+        }
+
+        if (m_simulationCPU) { function(*m_simulationCPU); }
+    }
+
+    bool Application::isBackendAvailable(Backend backend) const {
+        switch (backend) {
+        case Backend::CPU: return m_simulationCPU != nullptr;
+#ifdef USE_OPENCL
+        case Backend::OpenCL: return m_simulation != nullptr;
+#endif
+#ifndef __APPLE__
+        case Backend::GLCompute: return m_simulationGL != nullptr;
+#endif
+        default: return false;
+        }
+    }
+
+    const float* Application::readEngineState(Backend backend) {
+        switch (backend) {
 #ifdef USE_OPENCL
-            if (!m_useCPU && m_simulation) {
-                m_simulation->step();
-                m_computeTimeMs = m_simulation->getLastComputeTime();
-            } else
+        case Backend::OpenCL:
+            m_simulation->forceReadBack();
+            return m_simulation->getData();
 #endif
-            if (m_simulationCPU) {
-                m_simulationCPU->step(m_simulationCPU->getParams());
-                m_computeTimeMs = m_simulationCPU->getLastComputeTime();
+#ifndef __APPLE__
+        case Backend::GLCompute:
+            m_simulationGL->forceReadBack();
+            return m_simulationGL->getData();
+#endif
+        default:
+            return m_simulationCPU->getData();
+        }
+    }
+
+    void Application::writeEngineState(Backend backend, const float* state) {
+        switch (backend) {
+#ifdef USE_OPENCL
+        case Backend::OpenCL: m_simulation->syncFrom(state); break;
+#endif
+#ifndef __APPLE__
+        case Backend::GLCompute: m_simulationGL->syncFrom(state); break;
+#endif
+        default: m_simulationCPU->syncFrom(state); break;
+        }
+    }
+
+    void Application::switchBackend(Backend target) {
+        Backend source{ m_backend.load() };
+
+#ifdef USE_OPENCL
+        if (source == Backend::CPU && m_simulationCPU->hasExternalStorage()) {
+            // CPU stepped the device allocation in place; hand it back first
+            m_simulation->unmapHostState(m_simulationCPU->getData());
+            m_simulationCPU->detachStorage();
+            source = Backend::OpenCL;
+        }
+
+        float* current{};
+        float* next{};
+        if (source == Backend::OpenCL && target == Backend::CPU &&
+            m_simulation->mapHostState(current, next)) {
+            m_simulationCPU->attachStorage(current, next);
+            source = Backend::CPU;
+        }
+#endif
+
+        if (source != target) {
+            writeEngineState(target, readEngineState(source));
+        }
+
+        m_backend = target;
+        std::cout << "Switched to " << backendName(target) << '\n';
+    }
+
+    int Application::chooseStepCount() {
+        if (!m_autoStepsPerFrame) { return m_stepsPerFrame; }
+        if (m_stepCostMs <= 0.0f) { return 1; }
+
+        // Keep some headroom so jitter doesn't push frames past the refresh
+        float budgetMs{ m_framePeriodMs * 0.9f };
+        if (!m_simThread) {
+            // In lockstep the rest of the frame shares the budget; Swap is
+            // excluded as it mostly waits for VSync, GPU phases as they
+            // overlap the CPU ones
+            for (int i{}; i < static_cast<int>(FramePhase::Count); ++i) {
+                auto phase{ static_cast<FramePhase>(i) };
+                if (phase == FramePhase::Step || phase == FramePhase::Swap ||
+                    isGpuPhase(phase)) {
+                    continue;
+                }
+                budgetMs -= m_profiler->getAverageMs(phase);
             }
+        }
+
+        int steps{ static_cast<int>(budgetMs / m_stepCostMs) };
+        return std::clamp(steps, 1, Config::maxStepsPerFrame);
+    }
 
-            m_avgComputeTimeMs = (m_avgComputeTimeMs * m_computeSamples + m_computeTimeMs) / (m_computeSamples + 1);
-            ++m_computeSamples;
-            if (m_computeSamples > 100) {
-                m_computeSamples = 50;
-                m_avgComputeTimeMs = m_computeTimeMs;
+    int Application::stepActiveEngine(int steps) {
+        if (steps <= 0) { steps = chooseStepCount(); }
+        uint64_t start{ FrameProfiler::now() };
+        {
+            ScopedTimer timer{ m_profiler.get(), FramePhase::Step };
+            withActiveEngine([steps](auto& engine) { engine.step(steps); });
+        }
+
+        // Wall-clock cost per step, smoothed, including launch and sync overhead
+        float costMs{ (FrameProfiler::now() - start) / 1e6f / steps };
+        m_stepCostMs = m_stepCostMs > 0.0f ? m_stepCostMs * 0.9f + costMs * 0.1f : costMs;
+        m_lastStepCount = steps;
+
+        uint64_t previous{ m_stepCount.fetch_add(steps) };
+        uint64_t interval{ m_config.checkpointInterval };
+        if (interval > 0 && (previous + steps) / interval != previous / interval) {
+            saveCheckpoint();
+        }
+        if (m_snapshotWriter && m_snapshotWriter->isDue(previous, previous + steps)) {
+            captureSnapshot();
+        }
+        if (m_frameExporter && m_recording &&
+            m_frameExporter->isDue(previous, previous + steps)) {
+            captureFrame();
+        }
+        uint64_t shmInterval{ m_config.shmInterval };
+        if (m_sharedFrames && (previous + steps) / shmInterval != previous / shmInterval) {
+            publishSharedFrame();
+        }
+        return steps;
+    }
+
+    CheckpointInfo Application::describeState() {
+        CheckpointInfo info{};
+        info.width = m_config.gridWidth;
+        info.height = m_config.gridHeight;
+        info.step = m_stepCount;
+        withActiveEngine([&info](auto& engine) {
+            info.params = engine.getParams();
+            info.seed = engine.getSeed();
+        });
+        return info;
+    }
+
+    void Application::saveCheckpoint() {
+        // Copies the state and writes it in the background
+        m_checkpointWriter->save(m_config.checkpointPath, describeState(),
+                                 readEngineState(m_backend));
+    }
+
+    SnapshotWriter::FillFunction Application::stateFill() {
+        Backend backend{ m_backend.load() };
+        size_t count{ static_cast<size_t>(m_config.gridWidth) * m_config.gridHeight * 2 };
+
+        return [this, backend, count](float* field) {
+#ifdef USE_OPENCL
+            // Lands in the pool buffer while the next batch runs; the writer
+            // thread waits for it instead of this one
+            cl_event done{};
+            if (backend == Backend::OpenCL && m_simulation->readStateAsync(field, &done)) {
+                return SnapshotWriter::Completion{ [done] {
+                    clWaitForEvents(1, &done);
+                    clReleaseEvent(done);
+                } };
+            }
+#endif
+            const float* state{ readEngineState(backend) };
+            std::copy(state, state + count, field);
+            return SnapshotWriter::Completion{};
+        };
+    }
+
+    void Application::captureSnapshot() {
+        m_snapshotWriter->capture(describeState(), stateFill());
+    }
+
+    void Application::captureFrame() {
+        m_frameExporter->capture(describeState(), stateFill());
+    }
+
+    void Application::publishSharedFrame() {
+        Backend backend{ m_backend.load() };
+        size_t count{ static_cast<size_t>(m_config.gridWidth) * m_config.gridHeight * 2 };
+
+        m_sharedFrames->publish(describeState(), [this, backend, count](float* field) {
+#ifdef USE_OPENCL
+            // Straight from the device into the shared slot, no host copy
+            cl_event done{};
+            if (backend == Backend::OpenCL && m_simulation->readStateAsync(field, &done)) {
+                clWaitForEvents(1, &done);
+                clReleaseEvent(done);
+                return;
+            }
+#endif
+            const float* state{ readEngineState(backend) };
+            std::copy(state, state + count, field);
+        });
+    }
+
+    bool Application::loadCheckpoint(const std::string& path) {
+        MappedCheckpoint checkpoint{};
+        if (!checkpoint.open(path)) { return false; }
+
+        const CheckpointInfo& info{ checkpoint.getInfo() };
+        if (info.width != m_config.gridWidth || info.height != m_config.gridHeight) {
+            std::cerr << "Checkpoint grid " << info.width << "x" << info.height
+                      << " doesn't match the simulation (" << m_config.gridWidth << "x"
+                      << m_config.gridHeight << ")\n";
+            return false;
+        }
+
+        withActiveEngine([&info, &checkpoint](auto& engine) {
+            engine.setParams(info.params);
+            engine.setSeed(info.seed);
+            engine.syncFrom(checkpoint.getField());
+        });
+        m_stepCount = info.step;
+        if (m_simThread) { m_simThread->setStepCount(info.step); }
+
+        std::cout << "Restored checkpoint at step " << info.step << " from " << path << '\n';
+        return true;
+    }
+
+    void Application::publishFrame(SimulationFrame& frame) {
+        frame.display.resize(m_displayData.size());
+
+        // Only CPU and OpenCL run on the simulation thread
+#ifdef USE_OPENCL
+        if (m_backend == Backend::OpenCL) {
+            {
+                ScopedTimer timer{ m_profiler.get(), FramePhase::Readback };
+                m_simulation->readDisplay(frame.display.data());
+            }
+            frame.params = m_simulation->getParams();
+            frame.computeTimeMs = m_simulation->getLastComputeTime();
+        } else
+#endif
+        {
+            convertDisplayChannel(m_simulationCPU->getData(),
+                                  static_cast<size_t>(m_config.gridWidth) * m_config.gridHeight,
+                                  m_renderer->getDisplayFormat(), frame.display.data());
+            frame.params = m_simulationCPU->getParams();
+            frame.computeTimeMs = m_simulationCPU->getLastComputeTime();
+        }
+
+        frame.backend = m_backend;
+    }
+
+    void Application::uploadField(const float* field) {
+        size_t cells{ static_cast<size_t>(m_config.gridWidth) * m_config.gridHeight };
+        DisplayFormat format{ m_renderer->getDisplayFormat() };
+
+        // Convert straight into the mapped upload buffer when there is one
+        if (void* slot{ m_renderer->acquireUploadBuffer() }) {
+            convertDisplayChannel(field, cells, format, slot);
+            m_renderer->commitUpload();
+        } else {
+            convertDisplayChannel(field, cells, format, m_displayData.data());
+            m_renderer->updateTexture(m_displayData.data());
+        }
+    }
+
+    void Application::recordComputeTime(float computeTimeMs) {
+        m_computeTimeMs = computeTimeMs;
+        m_avgComputeTimeMs = (m_avgComputeTimeMs * m_computeSamples + m_computeTimeMs) / (m_computeSamples + 1);
+        ++m_computeSamples;
+        if (m_computeSamples > 100) {
+            m_computeSamples = 50;
+            m_avgComputeTimeMs = m_computeTimeMs;
+        }
+    }
+
+    void Application::update(float deltaTime) {
+        if (m_simThread) {
+            if (m_simThread->acquireLatest()) {
+                m_frameReady = true;
+                recordComputeTime(m_simThread->latest().computeTimeMs);
+            }
+        } else {
+            // Control requests change the state even while paused
+            bool changed{ runPendingCommands() };
+            if (m_stepBudget.active() && m_stepBudget.getGeneration() != m_pauseGeneration) {
+                m_stepBudget.interrupt();
+            }
+            if (m_stepBudget.active()) {
+                m_stepBudget.consume(stepActiveEngine(m_stepBudget.nextBatch()));
+                changed = true;
+            } else if (!m_paused) {
+                stepActiveEngine();
+                changed = true;
+            }
+            if (changed) {
+#ifdef USE_OPENCL
+                if (m_backend == Backend::OpenCL && !m_simulation->usesGLInterop()) {
+                    ScopedTimer timer{ m_profiler.get(), FramePhase::Readback };
+                    m_simulation->readDisplay(m_displayData.data());
+                }
+#endif
+                withActiveEngine([this](auto& engine) {
+                    recordComputeTime(engine.getLastComputeTime());
+                });
             }
         }
 
@@ -390,7 +1061,6 @@ namespace GreyScott {
 
         if (m_fpsTimer >= 1.0f) {
             m_currentFps = m_frameCount;
-            std::cout << "FPS: " << m_frameCount << '\n';
             m_frameCount = 0;
             m_fpsTimer = 0.0f;
         }
@@ -400,21 +1070,43 @@ namespace GreyScott {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         if (m_renderer) {
-#ifdef USE_OPENCL
-            if (!m_useCPU && m_simulation->usesGLInterop()) {
-                m_renderer->render();
+            if (m_simThread) {
+                if (m_frameReady) {
+                    ScopedTimer timer{ m_profiler.get(), FramePhase::Upload };
+                    ScopedGpuTimer gpuTimer{ m_gpuTimer.get(), FramePhase::GpuUpload };
+                    m_renderer->updateTexture(m_simThread->latest().display.data());
+                    m_frameReady = false;
+                }
             } else {
-                const float* data = m_useCPU ? m_simulationCPU->getData() : m_simulation->getData();
-                m_renderer->updateTexture(data);
-                m_renderer->render();
+                ScopedTimer timer{ m_profiler.get(), FramePhase::Upload };
+                ScopedGpuTimer gpuTimer{ m_gpuTimer.get(), FramePhase::GpuUpload };
+                switch (m_backend.load()) {
+                case Backend::CPU: uploadField(m_simulationCPU->getData()); break;
+#ifdef USE_OPENCL
+                case Backend::OpenCL:
+                    // Already converted on the device; with interop GL only
+                    // has to wait for the release of the shared texture
+                    if (m_simulation->usesGLInterop()) {
+                        m_simulation->waitForDisplay();
+                    } else {
+                        m_renderer->updateTexture(m_displayData.data());
+                    }
+                    break;
+#endif
+                default: break; // GL compute writes the display texture itself
+                }
             }
-#else
-            const float* data = m_simulationCPU->getData();
-            m_renderer->updateTexture(data);
-            m_renderer->render();
+
+            GLuint texture{};
+#ifndef __APPLE__
+            if (m_backend == Backend::GLCompute) { texture = m_simulationGL->getDisplayTexture(); }
 #endif
+            ScopedTimer timer{ m_profiler.get(), FramePhase::Render };
+            ScopedGpuTimer gpuTimer{ m_gpuTimer.get(), FramePhase::GpuRender };
+            m_renderer->render(texture);
         }
 
+        ScopedTimer imguiTimer{ m_profiler.get(), FramePhase::ImGui };
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplSDL2_NewFrame();
         ImGui::NewFrame();
@@ -423,17 +1115,17 @@ namespace GreyScott {
         ImGui::SetNextWindowSize(ImVec2(300, 200), ImGuiCond_FirstUseEver);
         ImGui::Begin("Simulation Info", nullptr, ImGuiWindowFlags_NoCollapse);
 
-        ImGui::Text("FPS: %d", m_currentFps);
+        ImGui::Text("FPS: %d", m_currentFps.load());
         ImGui::Separator();
 
         SimulationParams params;
-#ifdef USE_OPENCL
-        if (!m_useCPU && m_simulation) {
-            params = m_simulation->getParams();
-        } else
-#endif
-        if (m_simulationCPU) {
-            params = m_simulationCPU->getParams();
+        Backend backend{ m_backend.load() };
+        if (m_simThread) {
+            // Show what is on screen rather than touching the engines
+            params = m_simThread->latest().params;
+            backend = m_simThread->latest().backend;
+        } else {
+            withActiveEngine([&params](auto& engine) { params = engine.getParams(); });
         }
 
         ImGui::Text("Feed Rate (F): %.4f", params.F);
@@ -442,16 +1134,107 @@ namespace GreyScott {
         ImGui::Text("Diffusion V: %.4f", params.Dv);
         ImGui::Separator();
 
-#ifdef USE_OPENCL
-        ImGui::Text("Implementation: %s", m_useCPU ? "CPU (Serial)" : "GPU (OpenCL)");
-#else
-        ImGui::Text("Implementation: CPU (Serial)");
-#endif
+        ImGui::Text("Implementation: %s", backendName(backend));
+        ImGui::Text("Display Format: %s", displayFormatName(m_renderer->getDisplayFormat()));
         ImGui::Text("Compute Time: %.3f ms", m_avgComputeTimeMs);
         ImGui::Text("Compute FPS: %.1f", 1000.0f / m_avgComputeTimeMs);
+        if (m_gpuTimer->isAvailable()) {
+            ImGui::Text("GPU Upload/Render/ImGui: %.3f / %.3f / %.3f ms",
+                        m_profiler->getAverageMs(FramePhase::GpuUpload),
+                        m_profiler->getAverageMs(FramePhase::GpuRender),
+                        m_profiler->getAverageMs(FramePhase::GpuImGui));
+        }
+        if (m_simThread) {
+            ImGui::Text("Sim Steps/s: %.1f", m_simThread->getStepsPerSecond());
+            ImGui::Text("Sim Step: %llu", static_cast<unsigned long long>(
+                                              m_simThread->latest().step));
+        }
         ImGui::Separator();
 
-        ImGui::Text("Status: %s", m_paused ? "PAUSED" : "Running");
+        ImGui::Text("Status: %s", m_paused.load() ? "PAUSED" : "Running");
+        if (m_checkpointWriter->isBusy()) { ImGui::Text("Writing checkpoint..."); }
+        if (m_snapshotWriter) {
+            ImGui::Text("Snapshots: %llu written, %llu dropped, %zu queued",
+                        static_cast<unsigned long long>(m_snapshotWriter->getWritten()),
+                        static_cast<unsigned long long>(m_snapshotWriter->getDropped()),
+                        m_snapshotWriter->getQueued());
+            ImGui::Text("Snapshot every %llu steps, %.0f MB/s per writer",
+                        static_cast<unsigned long long>(m_snapshotWriter->getInterval()),
+                        m_snapshotWriter->getWriteMBps());
+            if (m_timeSeries) {
+                ImGui::Text("Time series: %.1f:1, %.0f MB/s encoded",
+                            m_timeSeries->getRatio(), m_timeSeries->getMBps());
+            }
+        }
+        if (m_frameExporter) {
+            ImGui::Text("Recording%s: %llu frames, %llu dropped, %zu queued",
+                        m_recording ? "" : " (paused)",
+                        static_cast<unsigned long long>(m_frameExporter->getExported()),
+                        static_cast<unsigned long long>(m_frameExporter->getDropped()),
+                        m_frameExporter->getQueued());
+        }
+        if (m_sharedFrames) {
+            ImGui::Text("Shared memory %s: %llu frames", m_sharedFrames->getName().c_str(),
+                        static_cast<unsigned long long>(m_sharedFrames->getPublished()));
+        }
+        ImGui::Separator();
+
+        if (ImGui::CollapsingHeader("Stepping", ImGuiTreeNodeFlags_DefaultOpen)) {
+            bool autoSteps{ m_autoStepsPerFrame };
+            if (ImGui::Checkbox("Auto (fit frame time)", &autoSteps)) {
+                m_autoStepsPerFrame = autoSteps;
+            }
+            ImGui::BeginDisabled(autoSteps);
+            int steps{ m_stepsPerFrame };
+            if (ImGui::SliderInt("Steps/Frame", &steps, 1, Config::maxStepsPerFrame, "%d",
+                                 ImGuiSliderFlags_Logarithmic)) {
+                m_stepsPerFrame = steps;
+            }
+            ImGui::EndDisabled();
+            ImGui::Text("Last batch: %d steps", m_lastStepCount.load());
+        }
+
+        if (ImGui::CollapsingHeader("View")) {
+            ImGui::Text("Zoom: %.1fx", m_renderer->getZoom());
+            if (m_renderer->usesTiledView()) {
+                ImGui::Text("Level of Detail: %d", m_renderer->getViewLevel());
+                ImGui::Text("Tiles: %d visible, %d uploaded", m_renderer->getVisibleTiles(),
+                            m_renderer->getTileUploads());
+            }
+            if (ImGui::Button("Reset View")) { m_renderer->resetView(); }
+        }
+
+        if (ImGui::CollapsingHeader("Frame Phases")) {
+            for (int i{}; i < static_cast<int>(FramePhase::Count); ++i) {
+                auto phase{ static_cast<FramePhase>(i) };
+                ImGui::Text("%-15s %7.3f ms", framePhaseName(phase),
+                            m_profiler->getAverageMs(phase));
+            }
+            if (ImGui::Button("Export Trace")) { exportTrace(); }
+        }
+#ifdef USE_OPENCL
+        if (m_simulation && ImGui::CollapsingHeader("OpenCL Commands")) {
+            // The simulation thread owns the profiler; read its published copy
+            CommandProfiler::StatsArray snapshot{
+                m_simulation->getCommandProfiler().getSnapshot() };
+            ImGui::Text("%-18s %6s %8s %8s %8s", "us (avg)", "count", "queue",
+                        "submit", "exec");
+            for (int i{}; i < static_cast<int>(CommandKind::Count); ++i) {
+                const auto& stats{ snapshot[i] };
+                if (stats.executed.samples == 0) { continue; }
+                ImGui::Text("%-18s %6llu %8.1f %8.1f %8.1f",
+                            commandKindName(static_cast<CommandKind>(i)),
+                            static_cast<unsigned long long>(stats.executed.samples),
+                            stats.queued.mean(), stats.submitted.mean(),
+                            stats.executed.mean());
+            }
+            if (ImGui::Button("Write Report")) { exportCommandReport(); }
+            ImGui::SameLine();
+            if (ImGui::Button("Reset")) {
+                runOnSimulation([this] { m_simulation->getCommandProfiler().reset(); });
+            }
+        }
+#endif
         ImGui::Separator();
 
         ImGui::Text("Controls:");
@@ -460,15 +1243,39 @@ namespace GreyScott {
         ImGui::BulletText("Up/Down: Adjust F");
         ImGui::BulletText("Left/Right: Adjust k");
         ImGui::BulletText("F1-F5: Load Presets");
-#ifdef USE_OPENCL
-        ImGui::BulletText("C: Toggle CPU/GPU");
-#endif
+        ImGui::BulletText("T: Export Frame Trace");
+        ImGui::BulletText("S/L: Save/Load Checkpoint");
+        ImGui::BulletText("Wheel/Drag: Zoom/Pan, Home: Reset View");
+        ImGui::BulletText("C: Cycle CPU/OpenCL/GL Compute");
         ImGui::BulletText("ESC: Quit");
 
         ImGui::End();
 
         ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            ScopedGpuTimer gpuTimer{ m_gpuTimer.get(), FramePhase::GpuImGui };
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
+        m_gpuTimer->endFrame();
+    }
+
+    void Application::exportTrace() {
+        char filename[64]{};
+        std::time_t now{ std::time(nullptr) };
+        std::strftime(filename, sizeof(filename),
+                      "greyscott_trace_%Y%m%d_%H%M%S.json", std::localtime(&now));
+        m_profiler->exportChromeTrace(filename);
+    }
+
+    void Application::exportCommandReport() {
+#ifdef USE_OPENCL
+        char filename[64]{};
+        std::time_t now{ std::time(nullptr) };
+        std::strftime(filename, sizeof(filename),
+                      "greyscott_cl_report_%Y%m%d_%H%M%S.txt", std::localtime(&now));
+        std::string path{ filename };
+        runOnSimulation([this, path] { m_simulation->getCommandProfiler().writeReport(path); });
+#endif
     }
 
     void Application::quit() { m_running = false; }
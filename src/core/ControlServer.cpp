@@ -0,0 +1,245 @@
+#include "ControlServer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace GreyScott {
+    namespace {
+        // Longest request line; anything longer drops the client
+        constexpr size_t kMaxLine{ 4096 };
+
+#ifdef MSG_NOSIGNAL
+        constexpr int kSendFlags{ MSG_NOSIGNAL };
+#else
+        constexpr int kSendFlags{ 0 };
+#endif
+
+        std::vector<std::string> splitWords(const std::string& line) {
+            std::istringstream stream{ line };
+            std::vector<std::string> words{};
+            std::string word{};
+            while (stream >> word) { words.push_back(word); }
+            return words;
+        }
+    } // namespace
+
+    ControlServer::~ControlServer() {
+        stop();
+    }
+
+    ControlServer::Reply ControlServer::ready(std::string reply) {
+        std::promise<std::string> promise{};
+        promise.set_value(std::move(reply));
+        return promise.get_future();
+    }
+
+#ifdef _WIN32
+    bool ControlServer::start(const std::string&, Handler) {
+        std::cerr << "The control socket needs Unix-domain sockets\n";
+        return false;
+    }
+
+    void ControlServer::stop() {}
+    void ControlServer::run() {}
+    bool ControlServer::readRequests(Client&) { return false; }
+    bool ControlServer::collectReplies(Client&) { return false; }
+    bool ControlServer::flushOutput(Client&) { return false; }
+#else
+    bool ControlServer::start(const std::string& path, Handler handler) {
+        stop();
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Invalid control socket path: " << path << '\n';
+            return false;
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        m_listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_listenFd < 0 || ::pipe(m_wakeFds) != 0) {
+            std::cerr << "Failed to create control socket! Error: " << std::strerror(errno) << '\n';
+            stop();
+            return false;
+        }
+
+        // A socket left behind by a previous run blocks bind(); anything
+        // else at the path isn't ours to delete
+        struct stat existing{};
+        if (::lstat(path.c_str(), &existing) == 0) {
+            if (!S_ISSOCK(existing.st_mode)) {
+                std::cerr << "Control socket path " << path << " exists and is not a socket\n";
+                stop();
+                return false;
+            }
+            ::unlink(path.c_str());
+        }
+
+        // Created owner-only, so it is never reachable with looser
+        // permissions; the umask is process-wide, but this runs at startup
+        mode_t mask{ ::umask(0177) };
+        bool bound{ ::bind(m_listenFd, reinterpret_cast<sockaddr*>(&address),
+                           sizeof(address)) == 0 };
+        ::umask(mask); // Can't fail, leaves errno alone
+        if (!bound || ::listen(m_listenFd, 8) != 0) {
+            std::cerr << "Failed to listen on " << path << "! Error: " << std::strerror(errno)
+                      << '\n';
+            stop();
+            return false;
+        }
+        ::fcntl(m_listenFd, F_SETFL, ::fcntl(m_listenFd, F_GETFL) | O_NONBLOCK);
+
+        m_path = path;
+        m_handler = std::move(handler);
+        m_running = true;
+        m_thread = std::thread(&ControlServer::run, this);
+        std::cout << "Control socket listening on " << path << '\n';
+        return true;
+    }
+
+    void ControlServer::stop() {
+        if (m_thread.joinable()) {
+            m_running = false;
+            char wake{};
+            if (::write(m_wakeFds[1], &wake, 1) < 0) {} // poll() wakes either way
+            m_thread.join();
+        }
+
+        for (Client& client : m_clients) { ::close(client.fd); }
+        m_clients.clear();
+        for (int& fd : m_wakeFds) {
+            if (fd >= 0) { ::close(fd); }
+            fd = -1;
+        }
+        if (m_listenFd >= 0) {
+            ::close(m_listenFd);
+            m_listenFd = -1;
+        }
+        if (!m_path.empty()) {
+            ::unlink(m_path.c_str());
+            m_path.clear();
+        }
+    }
+
+    void ControlServer::run() {
+        std::vector<pollfd> fds{};
+        while (m_running) {
+            fds.clear();
+            fds.push_back({ m_wakeFds[0], POLLIN, 0 });
+            fds.push_back({ m_listenFd, POLLIN, 0 });
+            bool waiting{};
+            for (const Client& client : m_clients) {
+                short events{};
+                if (client.reading) { events |= POLLIN; }
+                if (!client.output.empty()) { events |= POLLOUT; }
+                waiting |= !client.pending.empty();
+                fds.push_back({ client.fd, events, 0 });
+            }
+
+            // Replies still being computed are checked for every few ms
+            if (::poll(fds.data(), fds.size(), waiting ? 5 : -1) < 0 && errno != EINTR) {
+                std::cerr << "Control socket poll failed! Error: " << std::strerror(errno) << '\n';
+                return;
+            }
+            if (!m_running) { return; }
+
+            size_t index{ 2 };
+            for (Client& client : m_clients) {
+                if (fds[index++].revents & (POLLIN | POLLHUP | POLLERR)) {
+                    client.open = readRequests(client);
+                }
+                client.open = client.open && collectReplies(client) && flushOutput(client);
+                // Once the client is done sending, it still gets its replies
+                if (!client.reading && client.pending.empty() && client.output.empty()) {
+                    client.open = false;
+                }
+            }
+            m_clients.remove_if([](const Client& client) {
+                if (client.open) { return false; }
+                ::close(client.fd);
+                return true;
+            });
+
+            if (fds[1].revents & POLLIN) {
+                int fd{};
+                while ((fd = ::accept(m_listenFd, nullptr, nullptr)) >= 0) {
+                    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+                    int on{ 1 };
+                    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+                    m_clients.emplace_back();
+                    m_clients.back().fd = fd;
+                }
+            }
+        }
+    }
+
+    bool ControlServer::readRequests(Client& client) {
+        char buffer[1024];
+        for (;;) {
+            ssize_t received{ ::recv(client.fd, buffer, sizeof(buffer), 0) };
+            if (received == 0) {
+                client.reading = false;
+                return true;
+            }
+            if (received < 0) {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            }
+            client.input.append(buffer, static_cast<size_t>(received));
+
+            size_t end{};
+            while ((end = client.input.find('\n')) != std::string::npos) {
+                std::string line{ client.input.substr(0, end) };
+                client.input.erase(0, end + 1);
+
+                std::vector<std::string> words{ splitWords(line) };
+                if (words.empty()) { continue; }
+                client.pending.push_back(m_handler(words));
+            }
+            if (client.input.size() > kMaxLine) { return false; }
+        }
+    }
+
+    bool ControlServer::collectReplies(Client& client) {
+        // In order: a later reply waits for an earlier, slower one
+        while (!client.pending.empty() &&
+               client.pending.front().wait_for(std::chrono::seconds(0)) ==
+                   std::future_status::ready) {
+            try {
+                client.output += client.pending.front().get();
+            } catch (const std::future_error&) {
+                client.output += "error command dropped"; // e.g. while shutting down
+            }
+            client.output += '\n';
+            client.pending.pop_front();
+        }
+        return true;
+    }
+
+    bool ControlServer::flushOutput(Client& client) {
+        while (!client.output.empty()) {
+            ssize_t sent{ ::send(client.fd, client.output.data(), client.output.size(),
+                                 kSendFlags) };
+            if (sent < 0) {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            }
+            client.output.erase(0, static_cast<size_t>(sent));
+        }
+        return true;
+    }
+#endif
+
+} // namespace GreyScott
@@ -0,0 +1,113 @@
+#include "FrameProfiler.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace GreyScott {
+    const char* framePhaseName(FramePhase phase) {
+        switch (phase) {
+        case FramePhase::Events: return "Events";
+        case FramePhase::Step: return "Step";
+        case FramePhase::Readback: return "Readback";
+        case FramePhase::Upload: return "Texture Upload";
+        case FramePhase::Render: return "Render";
+        case FramePhase::ImGui: return "ImGui";
+        case FramePhase::Swap: return "Swap";
+        case FramePhase::GpuUpload: return "GPU Upload";
+        case FramePhase::GpuRender: return "GPU Render";
+        case FramePhase::GpuImGui: return "GPU ImGui";
+        default: return "Unknown";
+        }
+    }
+
+    FrameProfiler::FrameProfiler() :
+        m_slots{ std::make_unique<Slot[]>(kCapacity) },
+        m_epochNs{ now() }
+        {}
+
+    uint64_t FrameProfiler::now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    uint32_t FrameProfiler::currentThreadId() {
+        static std::atomic<uint32_t> nextId{ 1 };
+        thread_local uint32_t id{ nextId.fetch_add(1) };
+        return id;
+    }
+
+    void FrameProfiler::record(FramePhase phase, uint64_t startNs,
+                               uint64_t endNs) {
+        uint64_t index{ m_head.fetch_add(1, std::memory_order_relaxed) };
+        Slot& slot{ m_slots[index & (kCapacity - 1)] };
+
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.startNs.store(startNs, std::memory_order_relaxed);
+        slot.durationNs.store(endNs - startNs, std::memory_order_relaxed);
+        slot.threadId.store(currentThreadId(), std::memory_order_relaxed);
+        slot.phase.store(static_cast<uint8_t>(phase), std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+
+        // Each phase is only ever timed from one thread, so a plain
+        // load/store exponential average is enough
+        auto& average{ m_averageMs[static_cast<size_t>(phase)] };
+        float sampleMs{ (endNs - startNs) / 1000000.0f };
+        float previous{ average.load(std::memory_order_relaxed) };
+        average.store(previous == 0.0f ? sampleMs
+                                       : previous * 0.95f + sampleMs * 0.05f,
+                      std::memory_order_relaxed);
+    }
+
+    float FrameProfiler::getAverageMs(FramePhase phase) const {
+        return m_averageMs[static_cast<size_t>(phase)].load(
+            std::memory_order_relaxed);
+    }
+
+    bool FrameProfiler::exportChromeTrace(const std::string& filename) const {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open trace file: " << filename << '\n';
+            return false;
+        }
+
+        uint64_t head{ m_head.load(std::memory_order_acquire) };
+        uint64_t first{ head > kCapacity ? head - kCapacity : 0 };
+        size_t written{};
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+                "\"args\":{\"name\":\"GPU\"}}";
+        for (uint64_t index{ first }; index < head; ++index) {
+            const Slot& slot{ m_slots[index & (kCapacity - 1)] };
+
+            // Seqlock read: skip slots that are mid-write or were overwritten
+            uint64_t sequence{ slot.sequence.load(std::memory_order_acquire) };
+            if (sequence != index + 1) { continue; }
+            uint64_t startNs{ slot.startNs.load(std::memory_order_relaxed) };
+            uint64_t durationNs{ slot.durationNs.load(std::memory_order_relaxed) };
+            uint32_t threadId{ slot.threadId.load(std::memory_order_relaxed) };
+            auto phase{ static_cast<FramePhase>(
+                slot.phase.load(std::memory_order_relaxed)) };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+
+            file << ",\n";
+            ++written;
+            file << "{\"name\":\"" << framePhaseName(phase)
+                 << "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                 << (isGpuPhase(phase) ? 0 : threadId) << ",\"ts\":"
+                 << (startNs - m_epochNs) / 1000.0 << ",\"dur\":"
+                 << durationNs / 1000.0 << '}';
+        }
+        file << "\n]}\n";
+
+        std::cout << "Exported " << written << " trace events to " << filename
+                  << '\n';
+        return file.good();
+    }
+
+} // namespace GreyScott
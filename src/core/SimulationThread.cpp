@@ -0,0 +1,145 @@
+#include "SimulationThread.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace GreyScott {
+    using Clock = std::chrono::steady_clock;
+
+    SimulationThread::SimulationThread(StepFunction step, PublishFunction publish,
+                                       NotifyFunction published) :
+        m_step{ std::move(step) },
+        m_publish{ std::move(publish) },
+        m_published{ std::move(published) }
+        {}
+
+    SimulationThread::~SimulationThread() { stop(); }
+
+    void SimulationThread::start() {
+        if (m_thread.joinable()) { return; }
+
+        m_running = true;
+        m_thread = std::thread(&SimulationThread::run, this);
+    }
+
+    void SimulationThread::stop() {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable()) { m_thread.join(); }
+    }
+
+    void SimulationThread::post(Command command) {
+        m_commands.push(std::move(command));
+        {
+            // Taken so the thread can't check for commands and then miss the notify
+            std::lock_guard<std::mutex> lock{ m_mutex };
+        }
+        m_wake.notify_all();
+    }
+
+    void SimulationThread::setPaused(bool paused) {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_paused = paused;
+            m_pauseGeneration.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_wake.notify_all();
+    }
+
+    void SimulationThread::stepBy(uint64_t steps, int batch, StepBudget::Done done) {
+        uint64_t generation{ m_pauseGeneration.load(std::memory_order_relaxed) };
+        post([this, steps, batch, generation, done = std::move(done)]() mutable {
+            m_budget.start(steps, batch, generation, std::move(done));
+        });
+    }
+
+    void SimulationThread::setTargetRate(float stepsPerSecond) {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_targetRate = stepsPerSecond;
+    }
+
+    bool SimulationThread::runCommands() {
+        bool ran{};
+        Command command{};
+        while (m_commands.pop(command)) {
+            command();
+            ran = true;
+        }
+        return ran;
+    }
+
+    void SimulationThread::run() {
+        auto windowStart{ Clock::now() };
+        auto nextStep{ windowStart };
+        uint64_t windowSteps{};
+        bool dirty{ true }; // state changed since the last publish
+
+        for (;;) {
+            bool paused{};
+            float targetRate{};
+            {
+                std::unique_lock<std::mutex> lock{ m_mutex };
+                m_wake.wait(lock, [&] {
+                    return !m_running || !m_paused || !m_commands.empty() || dirty ||
+                           m_budget.active();
+                });
+                if (!m_running) { break; }
+                paused = m_paused;
+                targetRate = m_targetRate;
+            }
+
+            if (runCommands()) { dirty = true; }
+            if (m_budget.active() &&
+                m_budget.getGeneration() != m_pauseGeneration.load(std::memory_order_relaxed)) {
+                m_budget.interrupt();
+            }
+
+            int steps{};
+            if (m_budget.active() || !paused) {
+                steps = m_step(m_budget.active() ? m_budget.nextBatch() : 0);
+                m_stepCount.fetch_add(steps, std::memory_order_relaxed);
+                windowSteps += steps;
+                dirty = true;
+                m_budget.consume(steps);
+            }
+
+            // Copying a frame the reader would never see is wasted work, so
+            // while running only publish once the last one was picked up
+            if (dirty && (paused || m_frames.consumed())) {
+                SimulationFrame& frame{ m_frames.back() };
+                m_publish(frame);
+                frame.step = m_stepCount.load(std::memory_order_relaxed);
+                m_frames.publish();
+                dirty = false;
+                if (m_published) { m_published(); }
+            }
+
+            auto now{ Clock::now() };
+            float windowSeconds{ std::chrono::duration<float>(now - windowStart).count() };
+            if (windowSeconds >= 1.0f) {
+                m_stepsPerSecond.store(windowSteps / windowSeconds,
+                                       std::memory_order_relaxed);
+                windowStart = now;
+                windowSteps = 0;
+            }
+
+            if (steps > 0 && targetRate > 0.0f) {
+                auto period{ std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<float>(steps / targetRate)) };
+                // Don't try to catch up after stalls longer than a second
+                nextStep = std::max(nextStep + period, now - std::chrono::seconds(1));
+
+                std::unique_lock<std::mutex> lock{ m_mutex };
+                m_wake.wait_until(lock, nextStep, [this] {
+                    return !m_running || !m_commands.empty();
+                });
+            }
+        }
+
+        // Whoever waits for the budget must not wait forever
+        m_budget.interrupt();
+    }
+
+} // namespace GreyScott
@@ -0,0 +1,224 @@
+#include "DisplayFormat.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #include <immintrin.h>
+    #define GREYSCOTT_X86_SIMD 1
+#endif
+
+namespace GreyScott {
+    namespace {
+        // IEEE 754 binary16, round to nearest even; inputs are in [0, 1]
+        // but the full range is handled for robustness
+        uint16_t floatToHalf(float value) {
+            uint32_t bits{};
+            std::memcpy(&bits, &value, sizeof(bits));
+
+            uint32_t sign{ (bits >> 16) & 0x8000u };
+            uint32_t magnitude{ bits & 0x7fffffffu };
+
+            if (magnitude >= 0x7f800000u) {
+                // Inf stays Inf, NaN stays (quiet) NaN
+                return static_cast<uint16_t>(sign | 0x7c00u |
+                                             (magnitude > 0x7f800000u ? 0x200u : 0u));
+            }
+            if (magnitude >= 0x477ff000u) {
+                return static_cast<uint16_t>(sign | 0x7c00u); // Overflow to Inf
+            }
+            if (magnitude < 0x38800000u) {
+                // Subnormal half (or zero): shift the implicit-one mantissa
+                if (magnitude < 0x33000000u) { return static_cast<uint16_t>(sign); }
+                uint32_t exponent{ magnitude >> 23 };
+                uint32_t mantissa{ (magnitude & 0x7fffffu) | 0x800000u };
+                uint32_t shift{ 126 - exponent };
+                uint32_t half{ mantissa >> shift };
+                uint32_t remainder{ mantissa & ((1u << shift) - 1) };
+                uint32_t halfway{ 1u << (shift - 1) };
+                if (remainder > halfway || (remainder == halfway && (half & 1u))) { ++half; }
+                return static_cast<uint16_t>(sign | half);
+            }
+
+            uint32_t half{ (magnitude - 0x38000000u) >> 13 };
+            uint32_t remainder{ magnitude & 0x1fffu };
+            if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) { ++half; }
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        uint8_t floatToUnorm8(float value) {
+            return static_cast<uint8_t>(std::lrint(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+        }
+
+        constexpr float kPurple[3]{ 0.15f, 0.0f, 0.2f };
+        constexpr float kGreen[3]{ 0.0f, 0.6f, 0.2f };
+        constexpr float kYellow[3]{ 1.0f, 0.95f, 0.3f };
+
+        // Same colormap as the renderer's heatMap() GLSL function; writes
+        // R, G, B
+        void heatMap(float u, uint8_t* rgb) {
+            float t{ 1.0f - u };
+            const float* from{ t < 0.5f ? kPurple : kGreen };
+            const float* to{ t < 0.5f ? kGreen : kYellow };
+            float a{ t < 0.5f ? t * 2.0f : (t - 0.5f) * 2.0f };
+
+            for (int c{}; c < 3; ++c) {
+                rgb[c] = floatToUnorm8(from[c] + (to[c] - from[c]) * a);
+            }
+        }
+
+#ifdef GREYSCOTT_X86_SIMD
+        // Gathers U of 8 interleaved cells into one register in order
+        __attribute__((target("avx2"))) inline __m256 loadU8(const float* field) {
+            __m256 a{ _mm256_loadu_ps(field) };
+            __m256 b{ _mm256_loadu_ps(field + 8) };
+            __m256 u{ _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)) };
+            return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(u),
+                                                          _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+
+        __attribute__((target("avx2,f16c")))
+        size_t convertHalfAVX2(const float* field, size_t cells, uint16_t* out) {
+            size_t i{};
+            for (; i + 8 <= cells; i += 8) {
+                __m128i half{ _mm256_cvtps_ph(loadU8(field + i * 2), _MM_FROUND_TO_NEAREST_INT) };
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), half);
+            }
+            return i;
+        }
+
+        __attribute__((target("avx2")))
+        size_t convertUnorm8AVX2(const float* field, size_t cells, uint8_t* out) {
+            const __m256 scale{ _mm256_set1_ps(255.0f) };
+            size_t i{};
+            for (; i + 8 <= cells; i += 8) {
+                // Packing saturates, which also clamps to [0, 255]
+                __m256i words{ _mm256_cvtps_epi32(_mm256_mul_ps(loadU8(field + i * 2), scale)) };
+                __m128i packed{ _mm_packus_epi32(_mm256_castsi256_si128(words),
+                                                 _mm256_extracti128_si256(words, 1)) };
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i),
+                                 _mm_packus_epi16(packed, packed));
+            }
+            return i;
+        }
+
+        // heatMap() for 8 cells, as packed RGBA8 in each 32-bit lane; the
+        // arithmetic matches the scalar version operation for operation, so
+        // both produce identical bytes
+        __attribute__((target("avx2"))) inline __m256i heatMapAVX2(__m256 u) {
+            const __m256 half{ _mm256_set1_ps(0.5f) };
+            const __m256 two{ _mm256_set1_ps(2.0f) };
+            const __m256 zero{ _mm256_setzero_ps() };
+            const __m256 one{ _mm256_set1_ps(1.0f) };
+            const __m256 scale{ _mm256_set1_ps(255.0f) };
+
+            __m256 t{ _mm256_sub_ps(one, u) };
+            __m256 low{ _mm256_cmp_ps(t, half, _CMP_LT_OQ) };
+            __m256 a{ _mm256_blendv_ps(_mm256_mul_ps(_mm256_sub_ps(t, half), two),
+                                       _mm256_mul_ps(t, two), low) };
+
+            __m256i rgba{ _mm256_set1_epi32(static_cast<int>(0xff000000u)) };
+            for (int c{}; c < 3; ++c) {
+                __m256 from{ _mm256_blendv_ps(_mm256_set1_ps(kGreen[c]),
+                                              _mm256_set1_ps(kPurple[c]), low) };
+                __m256 to{ _mm256_blendv_ps(_mm256_set1_ps(kYellow[c]),
+                                            _mm256_set1_ps(kGreen[c]), low) };
+                __m256 value{ _mm256_add_ps(from, _mm256_mul_ps(_mm256_sub_ps(to, from), a)) };
+                value = _mm256_min_ps(_mm256_max_ps(value, zero), one);
+                __m256i channel{ _mm256_cvtps_epi32(_mm256_mul_ps(value, scale)) };
+                rgba = _mm256_or_si256(rgba, _mm256_slli_epi32(channel, c * 8));
+            }
+            return rgba;
+        }
+
+        __attribute__((target("avx2")))
+        size_t convertRGBA8AVX2(const float* field, size_t cells, uint8_t* out) {
+            size_t i{};
+            for (; i + 8 <= cells; i += 8) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4),
+                                    heatMapAVX2(loadU8(field + i * 2)));
+            }
+            return i;
+        }
+
+        __attribute__((target("avx2")))
+        size_t convertRGB8AVX2(const float* field, size_t cells, uint8_t* out) {
+            // Drops the alpha bytes within each lane, then moves the two
+            // 12-byte halves together
+            const __m256i dropAlpha{ _mm256_setr_epi8(
+                0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1) };
+            const __m256i join{ _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7) };
+            size_t i{};
+            for (; i + 8 <= cells; i += 8) {
+                __m256i rgb{ _mm256_permutevar8x32_epi32(
+                    _mm256_shuffle_epi8(heatMapAVX2(loadU8(field + i * 2)), dropAlpha), join) };
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 3),
+                                 _mm256_castsi256_si128(rgb));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + i * 3 + 16),
+                                 _mm256_extracti128_si256(rgb, 1));
+            }
+            return i;
+        }
+
+        bool hasAVX2() {
+            static const bool supported{ __builtin_cpu_supports("avx2") != 0 };
+            return supported;
+        }
+
+        bool hasF16C() {
+            static const bool supported{ __builtin_cpu_supports("f16c") != 0 };
+            return supported;
+        }
+#endif
+
+    } // namespace
+
+    void convertDisplayChannel(const float* field, size_t cells,
+                               DisplayFormat format, void* out) {
+        switch (format) {
+        case DisplayFormat::R16F: {
+            auto* half{ static_cast<uint16_t*>(out) };
+            size_t i{};
+#ifdef GREYSCOTT_X86_SIMD
+            if (hasAVX2() && hasF16C()) { i = convertHalfAVX2(field, cells, half); }
+#endif
+            for (; i < cells; ++i) { half[i] = floatToHalf(field[i * 2]); }
+            break;
+        }
+        case DisplayFormat::R8: {
+            auto* bytes{ static_cast<uint8_t*>(out) };
+            size_t i{};
+#ifdef GREYSCOTT_X86_SIMD
+            if (hasAVX2()) { i = convertUnorm8AVX2(field, cells, bytes); }
+#endif
+            for (; i < cells; ++i) { bytes[i] = floatToUnorm8(field[i * 2]); }
+            break;
+        }
+        case DisplayFormat::RGBA8: {
+            auto* rgba{ static_cast<uint8_t*>(out) };
+            size_t i{};
+#ifdef GREYSCOTT_X86_SIMD
+            if (hasAVX2()) { i = convertRGBA8AVX2(field, cells, rgba); }
+#endif
+            for (; i < cells; ++i) {
+                heatMap(field[i * 2], rgba + i * 4);
+                rgba[i * 4 + 3] = 255;
+            }
+            break;
+        }
+        default:
+            std::memcpy(out, field, cells * 2 * sizeof(float));
+            break;
+        }
+    }
+
+    void convertHeatMapRGB(const float* field, size_t cells, uint8_t* rgb) {
+        size_t i{};
+#ifdef GREYSCOTT_X86_SIMD
+        if (hasAVX2()) { i = convertRGB8AVX2(field, cells, rgb); }
+#endif
+        for (; i < cells; ++i) { heatMap(field[i * 2], rgb + i * 3); }
+    }
+
+} // namespace GreyScott
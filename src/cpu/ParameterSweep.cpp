@@ -0,0 +1,468 @@
+#include "ParameterSweep.hpp"
+#include "DisplayFormat.hpp"
+#include "FileWriter.hpp"
+#include "FrameExporter.hpp"
+#include "SimulationCPU.hpp"
+#include "SimulationCPUEnsemble.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#ifdef USE_OPENCL
+    #include "ComputeManager.hpp"
+    #include "SimulationEnsemble.hpp"
+#endif
+
+namespace GreyScott {
+    namespace {
+        void copyU(const float* field, float* u, size_t cells) {
+            for (size_t i{}; i < cells; ++i) { u[i] = field[i * 2]; }
+        }
+
+        // RMS change of U per step since `previous` was taken
+        float rmsChange(const float* field, const float* previous, size_t cells, int steps) {
+            double sum{};
+            for (size_t i{}; i < cells; ++i) {
+                double delta{ field[i * 2] - previous[i] };
+                sum += delta * delta;
+            }
+            return static_cast<float>(std::sqrt(sum / cells) / steps);
+        }
+
+        float secondsSince(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        }
+    } // namespace
+
+    /**
+     * Each worker owns a deque of job indices, seeded with a contiguous block
+     * of the grid. Owners pop from the back; idle workers steal from the front
+     * of the others, so neighbouring (F, k) pairs, which tend to cost the
+     * same, end up spread out once the fast blocks are done. A worker whose
+     * engine fails hands its unfinished jobs back, so the sweep is only done
+     * once every job has been completed, not when the deques run empty.
+     */
+    class ParameterSweep::JobQueue {
+    public:
+        JobQueue(int workers, int jobs) :
+            m_lanes(workers),
+            m_outstanding{ jobs }
+        {
+            for (int w{}; w < workers; ++w) {
+                for (int job{ jobs * w / workers }; job < jobs * (w + 1) / workers; ++job) {
+                    m_lanes[w].jobs.push_back(job);
+                }
+            }
+        }
+
+        // Up to `count` jobs from the worker's own deque, else about half of
+        // the first non-empty one it can steal from. While other workers
+        // still hold jobs that may be handed back, waits for them; false
+        // once every job is complete
+        bool take(int worker, int count, std::vector<int>& batch) {
+            for (;;) {
+                uint64_t seen{};
+                {
+                    std::lock_guard<std::mutex> lock{ m_mutex };
+                    if (m_outstanding == 0) { return false; }
+                    seen = m_returns;
+                }
+                if (tryTake(worker, count, batch)) { return true; }
+
+                std::unique_lock<std::mutex> lock{ m_mutex };
+                m_changed.wait(lock, [&] { return m_outstanding == 0 || m_returns != seen; });
+            }
+        }
+
+        // Jobs this worker took but won't finish go back on its own deque,
+        // where the others steal them
+        void giveBack(int worker, const std::vector<int>& jobs) {
+            if (jobs.empty()) { return; }
+            {
+                Lane& own{ m_lanes[worker] };
+                std::lock_guard<std::mutex> lock{ own.mutex };
+                own.jobs.insert(own.jobs.end(), jobs.begin(), jobs.end());
+            }
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                ++m_returns;
+            }
+            m_changed.notify_all();
+        }
+
+        void complete() {
+            bool done{};
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                done = --m_outstanding == 0;
+            }
+            if (done) { m_changed.notify_all(); }
+        }
+
+        int getStolen() const { return m_stolen.load(std::memory_order_relaxed); }
+
+    private:
+        struct Lane {
+            std::mutex mutex{};
+            std::deque<int> jobs{};
+        };
+
+        bool tryTake(int worker, int count, std::vector<int>& batch) {
+            batch.clear();
+            {
+                Lane& own{ m_lanes[worker] };
+                std::lock_guard<std::mutex> lock{ own.mutex };
+                while (!own.jobs.empty() && static_cast<int>(batch.size()) < count) {
+                    batch.push_back(own.jobs.back());
+                    own.jobs.pop_back();
+                }
+            }
+            if (!batch.empty()) { return true; }
+
+            int workers{ static_cast<int>(m_lanes.size()) };
+            for (int offset{ 1 }; offset < workers; ++offset) {
+                Lane& victim{ m_lanes[(worker + offset) % workers] };
+                std::lock_guard<std::mutex> lock{ victim.mutex };
+                int available{ static_cast<int>(victim.jobs.size()) };
+                if (available == 0) { continue; }
+
+                int stolen{ std::min(count, std::max(1, available / 2)) };
+                for (int i{}; i < stolen; ++i) {
+                    batch.push_back(victim.jobs.front());
+                    victim.jobs.pop_front();
+                }
+                m_stolen.fetch_add(stolen, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        std::vector<Lane> m_lanes;
+        std::atomic<int> m_stolen{};
+
+        // Guards the two counters below, which take() waits on
+        std::mutex m_mutex{};
+        std::condition_variable m_changed{};
+        int m_outstanding{};  // jobs not completed yet, queued or taken
+        uint64_t m_returns{}; // bumped by every giveBack()
+    };
+
+    const char* sweepClassName(const SweepResult& result) {
+        if (result.maxV < 1e-3f) { return "decayed"; }
+        if (result.stdU < 1e-3f) { return "uniform"; }
+        return result.steady ? "stationary" : "dynamic";
+    }
+
+    float ParameterSweep::parameterAt(float low, float high, int count, int index) const {
+        return count > 1 ? low + (high - low) * index / (count - 1) : low;
+    }
+
+    bool ParameterSweep::run(const SweepOptions& options) {
+        if (options.fCount < 1 || options.kCount < 1 || options.size < 8 ||
+            options.maxSteps < 1 || options.checkInterval < 1) {
+            std::cerr << "Invalid sweep: needs at least one F and k value, grids of 8 or "
+                         "more cells and a step budget\n";
+            return false;
+        }
+
+        m_options = options;
+        int jobs{ options.fCount * options.kCount };
+        m_results.assign(jobs, SweepResult{});
+        m_atlas.assign(static_cast<size_t>(getAtlasWidth()) * getAtlasHeight() * 3, 0);
+        m_completed = 0;
+
+        SimulationCPU seeded{ options.size, options.size };
+        seeded.setSeed(options.seed);
+        seeded.initialize();
+        m_initialState.assign(seeded.getData(),
+                              seeded.getData() + static_cast<size_t>(options.size) * options.size * 2);
+
+        int cpuWorkers{ options.threads > 0
+                            ? options.threads
+                            : std::max(1, static_cast<int>(std::thread::hardware_concurrency())) };
+#ifndef USE_OPENCL
+        if (!options.devices.empty()) {
+            std::cerr << "Built without OpenCL, sweeping on the CPU only\n";
+            m_options.devices.clear();
+        }
+#endif
+        int workers{ cpuWorkers + static_cast<int>(m_options.devices.size()) };
+        JobQueue queue{ workers, jobs };
+
+        std::cout << "Sweeping " << options.fCount << "x" << options.kCount << " (F, k) pairs on "
+                  << options.size << "x" << options.size << " grids, up to " << options.maxSteps
+                  << " steps each, with " << cpuWorkers << " CPU worker(s) and "
+                  << m_options.devices.size() << " OpenCL device(s)\n";
+
+        auto start{ std::chrono::steady_clock::now() };
+        std::vector<std::thread> threads{};
+        threads.reserve(workers);
+        m_activeWorkers = workers;
+        for (int w{}; w < workers; ++w) {
+            int device{ w < cpuWorkers ? -1 : m_options.devices[w - cpuWorkers] };
+            threads.emplace_back(&ParameterSweep::runWorker, this, std::ref(queue), w, device);
+        }
+
+        int reported{ -1 };
+        while (m_completed.load() < jobs && m_activeWorkers.load() > 0) {
+            int completed{ m_completed.load() };
+            if (completed != reported) {
+                std::cout << "\r  " << completed << "/" << jobs << " done" << std::flush;
+                reported = completed;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+        for (auto& thread : threads) { thread.join(); }
+
+        double seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                            .count() };
+        if (m_completed.load() < jobs) {
+            std::cerr << "\nSweep failed: " << jobs - m_completed.load() << " of " << jobs
+                      << " members did not finish\n";
+            return false;
+        }
+        uint64_t steps{};
+        for (const SweepResult& result : m_results) { steps += result.steps; }
+        std::cout << "\r  " << jobs << "/" << jobs << " done in " << std::fixed
+                  << std::setprecision(2) << seconds << " s, "
+                  << std::setprecision(1) << steps / seconds << " member steps/s, "
+                  << queue.getStolen() << " jobs stolen\n"
+                  << std::defaultfloat;
+        return true;
+    }
+
+    SimulationParams ParameterSweep::startMember(int job, int device) {
+        // Clears what a failed worker may have left of an earlier attempt
+        SweepResult& result{ m_results[job] };
+        result = SweepResult{};
+        result.F = parameterAt(m_options.fMin, m_options.fMax, m_options.fCount,
+                               job / m_options.kCount);
+        result.k = parameterAt(m_options.kMin, m_options.kMax, m_options.kCount,
+                               job % m_options.kCount);
+        result.device = device;
+
+        SimulationParams params{ m_options.base };
+        params.F = result.F;
+        params.k = result.k;
+        return params;
+    }
+
+    void ParameterSweep::runWorker(JobQueue& jobs, int worker, int device) {
+        struct Finished {
+            std::atomic<int>& active;
+            ~Finished() { active.fetch_sub(1); }
+        } finished{ m_activeWorkers };
+
+        if (device < 0) {
+            runCPUWorker(jobs, worker);
+        } else {
+            runDeviceWorker(jobs, worker, device);
+        }
+    }
+
+    void ParameterSweep::runBatches(JobQueue& jobs, int worker, int device, int members,
+                                    const BatchEngine& engine) {
+        const SweepOptions& options{ m_options };
+        size_t cells{ static_cast<size_t>(options.size) * options.size };
+        std::vector<float> stack(cells * 2 * members);
+        std::vector<float> previous(options.tolerance > 0.0f ? cells * members : 0);
+        std::vector<int> batch{};
+        std::vector<bool> running{};
+
+        std::vector<int> unfinished{};
+
+        // Takes up to a batch's worth of jobs and steps them together; members
+        // that settle early are finished right away and idle until the batch is done.
+        // If the engine fails, the members still running are handed back for
+        // the other workers and this one stops
+        while (jobs.take(worker, members, batch)) {
+            auto start{ std::chrono::steady_clock::now() };
+            int count{ static_cast<int>(batch.size()) };
+            for (int i{}; i < count; ++i) {
+                if (!engine.load(i, startMember(batch[i], device))) {
+                    jobs.giveBack(worker, batch);
+                    return;
+                }
+                std::copy(m_initialState.begin(), m_initialState.end(),
+                          stack.begin() + cells * 2 * i);
+            }
+
+            running.assign(count, true);
+            int left{ count };
+            auto finish = [&](int i) {
+                SweepResult& result{ m_results[batch[i]] };
+                result.seconds = secondsSince(start);
+                finishMember(batch[i], stack.data() + cells * 2 * i, result);
+                jobs.complete();
+                running[i] = false;
+                --left;
+            };
+
+            uint64_t steps{};
+            while (left > 0 && steps < options.maxSteps) {
+                int chunk{ static_cast<int>(
+                    std::min<uint64_t>(options.checkInterval, options.maxSteps - steps)) };
+                for (int i{}; i < count && !previous.empty(); ++i) {
+                    if (running[i]) {
+                        copyU(stack.data() + cells * 2 * i, previous.data() + cells * i, cells);
+                    }
+                }
+                steps += chunk;
+                if (!engine.step(chunk) || !engine.read(count, stack.data())) {
+                    unfinished.clear();
+                    for (int i{}; i < count; ++i) {
+                        if (running[i]) { unfinished.push_back(batch[i]); }
+                    }
+                    jobs.giveBack(worker, unfinished);
+                    return;
+                }
+
+                for (int i{}; i < count; ++i) {
+                    if (!running[i]) { continue; }
+                    SweepResult& result{ m_results[batch[i]] };
+                    result.steps = steps;
+                    if (previous.empty()) { continue; }
+                    result.change = rmsChange(stack.data() + cells * 2 * i,
+                                              previous.data() + cells * i, cells, chunk);
+                    if (result.change < options.tolerance) {
+                        result.steady = true;
+                        finish(i);
+                    }
+                }
+            }
+            for (int i{}; i < count; ++i) {
+                if (running[i]) { finish(i); }
+            }
+        }
+    }
+
+    void ParameterSweep::runCPUWorker(JobQueue& jobs, int worker) {
+        size_t cells{ static_cast<size_t>(m_options.size) * m_options.size };
+        SimulationCPUEnsemble ensemble{ m_options.size, m_options.size, m_options.lanes };
+
+        BatchEngine engine{};
+        engine.load = [&](int member, const SimulationParams& params) {
+            ensemble.setParams(member, params);
+            ensemble.loadMember(member, m_initialState.data());
+            return true;
+        };
+        engine.step = [&](int steps) {
+            ensemble.step(steps);
+            return true;
+        };
+        engine.read = [&](int count, float* stack) {
+            for (int i{}; i < count; ++i) { ensemble.extractMember(i, stack + cells * 2 * i); }
+            return true;
+        };
+        runBatches(jobs, worker, -1, ensemble.getLanes(), engine);
+    }
+
+#ifdef USE_OPENCL
+    void ParameterSweep::runDeviceWorker(JobQueue& jobs, int worker, int device) {
+        int members{ std::max(1, m_options.deviceBatch) };
+
+        // A device that fails to start leaves its share to be stolen
+        ComputeManager computeManager{};
+        if (!computeManager.initialize(false, device)) { return; }
+        SimulationEnsemble ensemble{ m_options.size, m_options.size, members, &computeManager };
+        if (!ensemble.initialize()) { return; }
+
+        BatchEngine engine{};
+        engine.load = [&](int member, const SimulationParams& params) {
+            ensemble.setParams(member, params);
+            return ensemble.loadMember(member, m_initialState.data());
+        };
+        engine.step = [&](int steps) { return ensemble.step(steps); };
+        engine.read = [&](int, float* stack) { return ensemble.readAll(stack); };
+        runBatches(jobs, worker, device, members, engine);
+    }
+#else
+    void ParameterSweep::runDeviceWorker(JobQueue&, int, int) {}
+#endif
+
+    void ParameterSweep::finishMember(int job, const float* field, SweepResult& result) {
+        int size{ m_options.size };
+        size_t cells{ static_cast<size_t>(size) * size };
+
+        double sumU{};
+        double sumUU{};
+        double sumV{};
+        size_t covered{};
+        result.minU = field[0];
+        result.maxU = field[0];
+        result.maxV = field[1];
+        for (size_t i{}; i < cells; ++i) {
+            float u{ field[i * 2] };
+            float v{ field[i * 2 + 1] };
+            sumU += u;
+            sumUU += static_cast<double>(u) * u;
+            sumV += v;
+            result.minU = std::min(result.minU, u);
+            result.maxU = std::max(result.maxU, u);
+            result.maxV = std::max(result.maxV, v);
+            covered += v > 0.1f;
+        }
+        double mean{ sumU / cells };
+        result.meanU = static_cast<float>(mean);
+        result.stdU = static_cast<float>(std::sqrt(std::max(0.0, sumUU / cells - mean * mean)));
+        result.meanV = static_cast<float>(sumV / cells);
+        result.coverage = static_cast<float>(covered) / cells;
+
+        // Highest F on top; within a tile, row 0 of the field at the bottom as
+        // on screen. Tiles don't overlap, so workers write them unlocked
+        int tileRow{ m_options.fCount - 1 - job / m_options.kCount };
+        int tileColumn{ job % m_options.kCount };
+        size_t atlasStride{ static_cast<size_t>(getAtlasWidth()) * 3 };
+        uint8_t* tile{ m_atlas.data() + atlasStride * tileRow * size +
+                       static_cast<size_t>(tileColumn) * size * 3 };
+        for (int y{}; y < size; ++y) {
+            convertHeatMapRGB(field + static_cast<size_t>(size - 1 - y) * size * 2,
+                              static_cast<size_t>(size), tile + atlasStride * y);
+        }
+        m_completed.fetch_add(1);
+    }
+
+    bool ParameterSweep::writeAtlas(const std::string& path, int level) const {
+        if (m_atlas.empty()) { return false; }
+
+        std::vector<uint8_t> encoded{};
+        if (!encodePNG(m_atlas.data(), getAtlasWidth(), getAtlasHeight(), level, encoded)) {
+            return false;
+        }
+        FileWriter file{};
+        if (!file.open(path) || !file.write(encoded.data(), encoded.size()) || !file.close()) {
+            std::cerr << "Failed to write sweep atlas " << path << '\n';
+            return false;
+        }
+        return true;
+    }
+
+    bool ParameterSweep::writeCSV(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open CSV output: " << path << '\n';
+            return false;
+        }
+
+        file << "F,k,steps,steady,change_per_step,mean_u,std_u,min_u,max_u,mean_v,max_v,"
+                "coverage,class,device,seconds\n";
+        file << std::setprecision(6);
+        for (const SweepResult& r : m_results) {
+            file << r.F << ',' << r.k << ',' << r.steps << ',' << (r.steady ? 1 : 0) << ','
+                 << r.change << ',' << r.meanU << ',' << r.stdU << ',' << r.minU << ','
+                 << r.maxU << ',' << r.meanV << ',' << r.maxV << ',' << r.coverage << ','
+                 << sweepClassName(r) << ','
+                 << (r.device < 0 ? std::string{ "cpu" } : "cl" + std::to_string(r.device))
+                 << ',' << r.seconds << '\n';
+        }
+        return file.good();
+    }
+
+} // namespace GreyScott
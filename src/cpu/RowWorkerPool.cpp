@@ -0,0 +1,76 @@
+#include "RowWorkerPool.hpp"
+#include <algorithm>
+
+namespace GreyScott {
+    RowWorkerPool::~RowWorkerPool() {
+        stopWorkers();
+    }
+
+    void RowWorkerPool::setThreadCount(int threads) {
+        threads = std::max(threads, 1);
+        if (threads == m_threadCount) { return; }
+
+        stopWorkers();
+        m_stopping = false;
+        m_threadCount = threads;
+        m_workers.reserve(threads - 1);
+        for (int band{}; band < threads - 1; ++band) {
+            m_workers.emplace_back(&RowWorkerPool::workerLoop, this, band, m_generation);
+        }
+    }
+
+    void RowWorkerPool::run(int rows, const Task& task) {
+        int threads{ m_threadCount };
+        if (threads == 1) {
+            task(0, rows);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_task = &task;
+            m_rows = rows;
+            m_pending = threads - 1;
+            ++m_generation;
+        }
+        m_start.notify_all();
+
+        task(rows * (threads - 1) / threads, rows);
+
+        std::unique_lock<std::mutex> lock{ m_mutex };
+        m_done.wait(lock, [this] { return m_pending == 0; });
+        m_task = nullptr;
+    }
+
+    // `seen` starts at the generation current when the helper was started,
+    // so it waits for the next run() even if it starts late
+    void RowWorkerPool::workerLoop(int band, uint64_t seen) {
+        std::unique_lock<std::mutex> lock{ m_mutex };
+        while (true) {
+            m_start.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) { return; }
+            seen = m_generation;
+
+            const Task& task{ *m_task };
+            int threads{ m_threadCount };
+            int rows{ m_rows };
+            lock.unlock();
+            task(rows * band / threads, rows * (band + 1) / threads);
+            lock.lock();
+
+            if (--m_pending == 0) { m_done.notify_one(); }
+        }
+    }
+
+    void RowWorkerPool::stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_stopping = true;
+        }
+        m_start.notify_all();
+        for (auto& worker : m_workers) { worker.join(); }
+        m_workers.clear();
+        m_threadCount = 1;
+    }
+
+} // namespace GreyScott
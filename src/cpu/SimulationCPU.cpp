@@ -6,10 +6,13 @@
 namespace GreyScott {
     SimulationCPU::SimulationCPU(int width, int height) :
         m_width{ width },
-        m_height{ height }
+        m_height{ height },
+        m_seed{ std::random_device{}() }
     {
         m_data.resize(width * height * 2);
         m_dataNext.resize(width * height * 2);
+        m_current = m_data.data();
+        m_next = m_dataNext.data();
     }
 
     void SimulationCPU::initialize() {
@@ -17,13 +20,12 @@ namespace GreyScott {
     }
 
     void SimulationCPU::initializeState() {
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        std::mt19937 gen(m_seed);
         std::uniform_real_distribution<float> dis(-0.05f, 0.05f);
 
         for (int i{}; i < m_width * m_height * 2; i += 2) {
-            m_data[i + 0] = 1.0f;
-            m_data[i + 1] = 0.0f;
+            m_current[i + 0] = 1.0f;
+            m_current[i + 1] = 0.0f;
         }
 
         int centerX{ m_width / 2 };
@@ -36,14 +38,14 @@ namespace GreyScott {
                 int dy{ y - centerY };
                 if (dx * dx + dy * dy < radius * radius) {
                     int idx{ (y * m_width + x) * 2 };
-                    m_data[idx + 0] = 0.5f + dis(gen);
-                    m_data[idx + 1] = 0.25f + dis(gen);
+                    m_current[idx + 0] = 0.5f + dis(gen);
+                    m_current[idx + 1] = 0.25f + dis(gen);
                 }
             }
         }
     }
 
-    float SimulationCPU::computeLaplacian(const std::vector<float>& field, int x, int y, int component) {
+    float SimulationCPU::computeLaplacian(const float* field, int x, int y, int component) {
         int xm1{ (x - 1 + m_width) % m_width };
         int xp1{ (x + 1) % m_width };
         int ym1{ (y - 1 + m_height) % m_height };
@@ -58,40 +60,74 @@ namespace GreyScott {
         return field[left] + field[right] + field[up] + field[down] - 4.0f * field[idx];
     }
 
-    void SimulationCPU::step(const SimulationParams& params) {
-        auto start{ std::chrono::high_resolution_clock::now() };
+    void SimulationCPU::setThreadCount(int threads) {
+        m_threadCount = std::clamp(threads, 1, m_height);
+        m_workers.setThreadCount(m_threadCount);
+    }
 
-        for (int y{}; y < m_height; ++y) {
+    void SimulationCPU::stepRows(const SimulationParams& params, int yBegin, int yEnd) {
+        for (int y{ yBegin }; y < yEnd; ++y) {
             for (int x{}; x < m_width; ++x) {
                 int idx{ (y * m_width + x) * 2 };
 
-                float u{ m_data[idx + 0] };
-                float v{ m_data[idx + 1] };
+                float u{ m_current[idx + 0] };
+                float v{ m_current[idx + 1] };
 
-                float laplacian_u{ computeLaplacian(m_data, x, y, 0) };
-                float laplacian_v{ computeLaplacian(m_data, x, y, 1) };
+                float laplacian_u{ computeLaplacian(m_current, x, y, 0) };
+                float laplacian_v{ computeLaplacian(m_current, x, y, 1) };
 
                 float uvv{ u * v * v };
                 float du{ params.Du * laplacian_u - uvv + params.F * (1.0f - u) };
                 float dv{ params.Dv * laplacian_v + uvv - (params.F + params.k) * v };
 
-                m_dataNext[idx + 0] = std::clamp(u + du * params.dt, 0.0f, 1.0f);
-                m_dataNext[idx + 1] = std::clamp(v + dv * params.dt, 0.0f, 1.0f);
+                m_next[idx + 0] = std::clamp(u + du * params.dt, 0.0f, 1.0f);
+                m_next[idx + 1] = std::clamp(v + dv * params.dt, 0.0f, 1.0f);
             }
         }
+    }
 
-        std::swap(m_data, m_dataNext);
+    void SimulationCPU::step(const SimulationParams& params, int iterations) {
+        if (iterations < 1) { return; }
 
+        auto start{ std::chrono::high_resolution_clock::now() };
+
+        // Row bands are independent; the pool's threads stay parked between steps
+        RowWorkerPool::Task task{ [this, &params](int yBegin, int yEnd) {
+            stepRows(params, yBegin, yEnd);
+        } };
+        for (int i{}; i < iterations; ++i) {
+            m_workers.run(m_height, task);
+            std::swap(m_current, m_next);
+        }
+
+        // Mean time per step, comparable with the OpenCL engine
         auto end{ std::chrono::high_resolution_clock::now() };
-        m_lastComputeTime = std::chrono::duration<float, std::milli>(end - start).count();
+        m_lastComputeTime =
+            std::chrono::duration<float, std::milli>(end - start).count() / iterations;
     }
 
     void SimulationCPU::reset() {
+        // Every reset draws a new pattern; the seed is kept for reproduction
+        m_seed = std::random_device{}();
         initializeState();
     }
 
     void SimulationCPU::syncFrom(const float* data) {
-        std::copy(data, data + m_width * m_height * 2, m_data.begin());
+        std::copy(data, data + m_width * m_height * 2, m_current);
+    }
+
+    void SimulationCPU::attachStorage(float* current, float* next) {
+        m_current = current;
+        m_next = next;
+        m_externalStorage = true;
+    }
+
+    void SimulationCPU::detachStorage() {
+        // Falls back to the owned buffers; their contents are whatever was
+        // there before attaching, so callers resync if they need the state
+        m_current = m_data.data();
+        m_next = m_dataNext.data();
+        m_externalStorage = false;
     }
 
     void SimulationCPU::loadPreset(int presetIndex) {
@@ -0,0 +1,322 @@
+#include "SimulationCPUEnsemble.hpp"
+#include "SimulationCPU.hpp"
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #include <immintrin.h>
+    #define GREYSCOTT_X86_SIMD 1
+#endif
+
+// Keeps a * b + c as two roundings where the target has FMA, matching the
+// scalar engine; Clang doesn't fuse across intrinsics to begin with
+#if defined(__clang__)
+    #define GREYSCOTT_NO_CONTRACT
+#else
+    #define GREYSCOTT_NO_CONTRACT __attribute__((optimize("fp-contract=off")))
+#endif
+
+namespace GreyScott {
+    namespace {
+        enum Param { kDu, kDv, kF, kK, kDt, kParamCount };
+
+        struct Rows {
+            const float* current{};
+            float* next{};
+            const float* params{};
+            int width{};
+            int height{};
+            int lanes{};
+        };
+
+        // Offset of the first value (U of lane 0) of cell (x, y)
+        size_t cellOffset(const Rows& rows, int x, int y) {
+            return (static_cast<size_t>(y) * rows.width + x) * 2 * rows.lanes;
+        }
+
+        // Same operations in the same order as SimulationCPU::stepRows
+        void stepRowsScalar(const Rows& rows, int yBegin, int yEnd) {
+            const int lanes{ rows.lanes };
+            for (int y{ yBegin }; y < yEnd; ++y) {
+                int ym1{ (y - 1 + rows.height) % rows.height };
+                int yp1{ (y + 1) % rows.height };
+                for (int x{}; x < rows.width; ++x) {
+                    int xm1{ (x - 1 + rows.width) % rows.width };
+                    int xp1{ (x + 1) % rows.width };
+                    const float* c{ rows.current + cellOffset(rows, x, y) };
+                    const float* l{ rows.current + cellOffset(rows, xm1, y) };
+                    const float* r{ rows.current + cellOffset(rows, xp1, y) };
+                    const float* up{ rows.current + cellOffset(rows, x, ym1) };
+                    const float* down{ rows.current + cellOffset(rows, x, yp1) };
+                    float* out{ rows.next + cellOffset(rows, x, y) };
+
+                    for (int lane{}; lane < lanes; ++lane) {
+                        const float* p{ rows.params + lane };
+                        int v{ lanes + lane };
+                        float laplacianU{ l[lane] + r[lane] + up[lane] + down[lane] - 4.0f * c[lane] };
+                        float laplacianV{ l[v] + r[v] + up[v] + down[v] - 4.0f * c[v] };
+
+                        float uvv{ c[lane] * c[v] * c[v] };
+                        float du{ p[kDu * lanes] * laplacianU - uvv + p[kF * lanes] * (1.0f - c[lane]) };
+                        float dv{ p[kDv * lanes] * laplacianV + uvv -
+                                  (p[kF * lanes] + p[kK * lanes]) * c[v] };
+
+                        out[lane] = std::clamp(c[lane] + du * p[kDt * lanes], 0.0f, 1.0f);
+                        out[v] = std::clamp(c[v] + dv * p[kDt * lanes], 0.0f, 1.0f);
+                    }
+                }
+            }
+        }
+
+#ifdef GREYSCOTT_X86_SIMD
+        // One register of 8 lanes at a time; lanes is a multiple of 8
+        __attribute__((target("avx2"))) GREYSCOTT_NO_CONTRACT
+        void stepRowsAVX2(const Rows& rows, int yBegin, int yEnd) {
+            const int lanes{ rows.lanes };
+            const __m256 zero{ _mm256_setzero_ps() };
+            const __m256 one{ _mm256_set1_ps(1.0f) };
+            const __m256 four{ _mm256_set1_ps(4.0f) };
+
+            for (int y{ yBegin }; y < yEnd; ++y) {
+                int ym1{ (y - 1 + rows.height) % rows.height };
+                int yp1{ (y + 1) % rows.height };
+                for (int x{}; x < rows.width; ++x) {
+                    int xm1{ (x - 1 + rows.width) % rows.width };
+                    int xp1{ (x + 1) % rows.width };
+                    const float* c{ rows.current + cellOffset(rows, x, y) };
+                    const float* l{ rows.current + cellOffset(rows, xm1, y) };
+                    const float* r{ rows.current + cellOffset(rows, xp1, y) };
+                    const float* up{ rows.current + cellOffset(rows, x, ym1) };
+                    const float* down{ rows.current + cellOffset(rows, x, yp1) };
+                    float* out{ rows.next + cellOffset(rows, x, y) };
+
+                    for (int lane{}; lane < lanes; lane += 8) {
+                        const float* p{ rows.params + lane };
+                        int v{ lanes + lane };
+                        __m256 u0{ _mm256_load_ps(c + lane) };
+                        __m256 v0{ _mm256_load_ps(c + v) };
+                        __m256 laplacianU{ _mm256_sub_ps(
+                            _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_load_ps(l + lane),
+                                                                      _mm256_load_ps(r + lane)),
+                                                        _mm256_load_ps(up + lane)),
+                                          _mm256_load_ps(down + lane)),
+                            _mm256_mul_ps(four, u0)) };
+                        __m256 laplacianV{ _mm256_sub_ps(
+                            _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_load_ps(l + v),
+                                                                      _mm256_load_ps(r + v)),
+                                                        _mm256_load_ps(up + v)),
+                                          _mm256_load_ps(down + v)),
+                            _mm256_mul_ps(four, v0)) };
+
+                        __m256 F{ _mm256_load_ps(p + kF * lanes) };
+                        __m256 dt{ _mm256_load_ps(p + kDt * lanes) };
+                        __m256 uvv{ _mm256_mul_ps(_mm256_mul_ps(u0, v0), v0) };
+                        __m256 du{ _mm256_add_ps(
+                            _mm256_sub_ps(_mm256_mul_ps(_mm256_load_ps(p + kDu * lanes), laplacianU), uvv),
+                            _mm256_mul_ps(F, _mm256_sub_ps(one, u0))) };
+                        __m256 dv{ _mm256_sub_ps(
+                            _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(p + kDv * lanes), laplacianV), uvv),
+                            _mm256_mul_ps(_mm256_add_ps(F, _mm256_load_ps(p + kK * lanes)), v0)) };
+
+                        // max(0, x) then min(1, x) keep x on ties, as std::clamp does
+                        _mm256_store_ps(out + lane, _mm256_min_ps(one, _mm256_max_ps(
+                            zero, _mm256_add_ps(u0, _mm256_mul_ps(du, dt)))));
+                        _mm256_store_ps(out + v, _mm256_min_ps(one, _mm256_max_ps(
+                            zero, _mm256_add_ps(v0, _mm256_mul_ps(dv, dt)))));
+                    }
+                }
+            }
+        }
+
+        // clamp(x, 0, 1) with x kept on ties, as in the AVX2 path; the
+        // zero-masked forms avoid a false -Wmaybe-uninitialized from GCC 12's
+        // headers for the plain ones
+        __attribute__((target("avx512f"))) inline __m512 clampUnit512(__m512 x) {
+            const __mmask16 all{ 0xffff };
+            return _mm512_maskz_min_ps(all, _mm512_set1_ps(1.0f),
+                                       _mm512_maskz_max_ps(all, _mm512_setzero_ps(), x));
+        }
+
+        // All 16 lanes in one register
+        __attribute__((target("avx512f"))) GREYSCOTT_NO_CONTRACT
+        void stepRowsAVX512(const Rows& rows, int yBegin, int yEnd) {
+            constexpr int lanes{ 16 };
+            const __m512 one{ _mm512_set1_ps(1.0f) };
+            const __m512 four{ _mm512_set1_ps(4.0f) };
+            const __m512 Du{ _mm512_load_ps(rows.params + kDu * lanes) };
+            const __m512 Dv{ _mm512_load_ps(rows.params + kDv * lanes) };
+            const __m512 F{ _mm512_load_ps(rows.params + kF * lanes) };
+            const __m512 k{ _mm512_load_ps(rows.params + kK * lanes) };
+            const __m512 dt{ _mm512_load_ps(rows.params + kDt * lanes) };
+
+            for (int y{ yBegin }; y < yEnd; ++y) {
+                int ym1{ (y - 1 + rows.height) % rows.height };
+                int yp1{ (y + 1) % rows.height };
+                for (int x{}; x < rows.width; ++x) {
+                    int xm1{ (x - 1 + rows.width) % rows.width };
+                    int xp1{ (x + 1) % rows.width };
+                    const float* c{ rows.current + cellOffset(rows, x, y) };
+                    const float* l{ rows.current + cellOffset(rows, xm1, y) };
+                    const float* r{ rows.current + cellOffset(rows, xp1, y) };
+                    const float* up{ rows.current + cellOffset(rows, x, ym1) };
+                    const float* down{ rows.current + cellOffset(rows, x, yp1) };
+                    float* out{ rows.next + cellOffset(rows, x, y) };
+
+                    __m512 u0{ _mm512_load_ps(c) };
+                    __m512 v0{ _mm512_load_ps(c + lanes) };
+                    __m512 laplacianU{ _mm512_sub_ps(
+                        _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_load_ps(l), _mm512_load_ps(r)),
+                                                    _mm512_load_ps(up)),
+                                      _mm512_load_ps(down)),
+                        _mm512_mul_ps(four, u0)) };
+                    __m512 laplacianV{ _mm512_sub_ps(
+                        _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(_mm512_load_ps(l + lanes),
+                                                                  _mm512_load_ps(r + lanes)),
+                                                    _mm512_load_ps(up + lanes)),
+                                      _mm512_load_ps(down + lanes)),
+                        _mm512_mul_ps(four, v0)) };
+
+                    __m512 uvv{ _mm512_mul_ps(_mm512_mul_ps(u0, v0), v0) };
+                    __m512 du{ _mm512_add_ps(_mm512_sub_ps(_mm512_mul_ps(Du, laplacianU), uvv),
+                                             _mm512_mul_ps(F, _mm512_sub_ps(one, u0))) };
+                    __m512 dv{ _mm512_sub_ps(_mm512_add_ps(_mm512_mul_ps(Dv, laplacianV), uvv),
+                                             _mm512_mul_ps(_mm512_add_ps(F, k), v0)) };
+
+                    _mm512_store_ps(out, clampUnit512(_mm512_add_ps(u0, _mm512_mul_ps(du, dt))));
+                    _mm512_store_ps(out + lanes,
+                                    clampUnit512(_mm512_add_ps(v0, _mm512_mul_ps(dv, dt))));
+                }
+            }
+        }
+
+        bool hasAVX2() {
+            static const bool supported{ __builtin_cpu_supports("avx2") != 0 };
+            return supported;
+        }
+
+        bool hasAVX512() {
+            static const bool supported{ __builtin_cpu_supports("avx512f") != 0 };
+            return supported;
+        }
+#endif
+
+        void stepLanes(const Rows& rows, int yBegin, int yEnd) {
+#ifdef GREYSCOTT_X86_SIMD
+            if (rows.lanes == 16 && hasAVX512()) {
+                stepRowsAVX512(rows, yBegin, yEnd);
+                return;
+            }
+            if (hasAVX2()) {
+                stepRowsAVX2(rows, yBegin, yEnd);
+                return;
+            }
+#endif
+            stepRowsScalar(rows, yBegin, yEnd);
+        }
+    } // namespace
+
+    SimulationCPUEnsemble::SimulationCPUEnsemble(int width, int height, int lanes) :
+        m_width{ width },
+        m_height{ height }
+    {
+#ifdef GREYSCOTT_X86_SIMD
+        if (lanes == 0) { lanes = hasAVX512() ? 16 : 8; }
+#endif
+        m_lanes = lanes == 16 ? 16 : 8;
+
+        size_t values{ static_cast<size_t>(width) * height * 2 * m_lanes };
+        m_data.resize(values);
+        m_dataNext.resize(values);
+        m_current = m_data.data();
+        m_next = m_dataNext.data();
+
+        m_laneParams.resize(kParamCount * m_lanes);
+        for (int member{}; member < m_lanes; ++member) { setParams(member, SimulationParams{}); }
+
+        std::random_device random{};
+        m_seeds.resize(m_lanes);
+        for (uint32_t& seed : m_seeds) { seed = random(); }
+    }
+
+    void SimulationCPUEnsemble::initialize() {
+        SimulationCPU member{ m_width, m_height };
+        for (int lane{}; lane < m_lanes; ++lane) {
+            member.setSeed(m_seeds[lane]);
+            member.initialize();
+            loadMember(lane, member.getData());
+        }
+    }
+
+    void SimulationCPUEnsemble::setParams(int member, const SimulationParams& params) {
+        if (member < 0 || member >= m_lanes) { return; }
+        m_laneParams[kDu * m_lanes + member] = params.Du;
+        m_laneParams[kDv * m_lanes + member] = params.Dv;
+        m_laneParams[kF * m_lanes + member] = params.F;
+        m_laneParams[kK * m_lanes + member] = params.k;
+        m_laneParams[kDt * m_lanes + member] = params.dt;
+    }
+
+    SimulationParams SimulationCPUEnsemble::getParams(int member) const {
+        SimulationParams params{};
+        params.Du = m_laneParams[kDu * m_lanes + member];
+        params.Dv = m_laneParams[kDv * m_lanes + member];
+        params.F = m_laneParams[kF * m_lanes + member];
+        params.k = m_laneParams[kK * m_lanes + member];
+        params.dt = m_laneParams[kDt * m_lanes + member];
+        return params;
+    }
+
+    void SimulationCPUEnsemble::loadMember(int member, const float* data) {
+        if (member < 0 || member >= m_lanes) { return; }
+        size_t cells{ static_cast<size_t>(m_width) * m_height };
+        for (size_t i{}; i < cells; ++i) {
+            m_current[i * 2 * m_lanes + member] = data[i * 2];
+            m_current[i * 2 * m_lanes + m_lanes + member] = data[i * 2 + 1];
+        }
+    }
+
+    void SimulationCPUEnsemble::extractMember(int member, float* out) const {
+        if (member < 0 || member >= m_lanes) { return; }
+        size_t cells{ static_cast<size_t>(m_width) * m_height };
+        for (size_t i{}; i < cells; ++i) {
+            out[i * 2] = m_current[i * 2 * m_lanes + member];
+            out[i * 2 + 1] = m_current[i * 2 * m_lanes + m_lanes + member];
+        }
+    }
+
+    void SimulationCPUEnsemble::setThreadCount(int threads) {
+        m_threadCount = std::clamp(threads, 1, m_height);
+        m_workers.setThreadCount(m_threadCount);
+    }
+
+    const char* SimulationCPUEnsemble::getInstructionSet() const {
+#ifdef GREYSCOTT_X86_SIMD
+        if (m_lanes == 16 && hasAVX512()) { return "avx512"; }
+        if (hasAVX2()) { return "avx2"; }
+#endif
+        return "scalar";
+    }
+
+    void SimulationCPUEnsemble::stepRows(int yBegin, int yEnd) {
+        Rows rows{ m_current, m_next, m_laneParams.data(), m_width, m_height, m_lanes };
+        stepLanes(rows, yBegin, yEnd);
+    }
+
+    void SimulationCPUEnsemble::step(int iterations) {
+        if (iterations < 1) { return; }
+
+        auto start{ std::chrono::high_resolution_clock::now() };
+
+        RowWorkerPool::Task task{ [this](int yBegin, int yEnd) { stepRows(yBegin, yEnd); } };
+        for (int i{}; i < iterations; ++i) {
+            m_workers.run(m_height, task);
+            std::swap(m_current, m_next);
+        }
+
+        auto end{ std::chrono::high_resolution_clock::now() };
+        m_lastComputeTime =
+            std::chrono::duration<float, std::milli>(end - start).count() / iterations;
+    }
+
+} // namespace GreyScott
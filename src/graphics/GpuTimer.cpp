@@ -0,0 +1,90 @@
+#include "GpuTimer.hpp"
+#include <iostream>
+
+namespace GreyScott {
+    GpuTimer::GpuTimer(FrameProfiler* profiler) :
+        m_profiler{ profiler }
+        {}
+
+    GpuTimer::~GpuTimer() {
+        for (auto& phase : m_phases) {
+            if (phase.queries[0]) { glDeleteQueries(2, phase.queries); }
+        }
+    }
+
+    bool GpuTimer::initialize() {
+        if (!GLEW_ARB_timer_query) {
+            std::cout << "ARB_timer_query not available, GPU timings disabled\n";
+            return false;
+        }
+
+        for (auto& phase : m_phases) { glGenQueries(2, phase.queries); }
+
+        GLenum error{ glGetError() };
+        if (error != GL_NO_ERROR) {
+            std::cerr << "Failed to create timer queries! OpenGL error: " << error
+                      << '\n';
+            return false;
+        }
+
+        m_available = true;
+        return true;
+    }
+
+    void GpuTimer::begin(FramePhase phase) {
+        if (!m_available || m_active >= 0) { return; }
+
+        int index{ static_cast<int>(phase) - static_cast<int>(FramePhase::GpuUpload) };
+        if (index < 0 || index >= kPhases) { return; }
+
+        // The slot was last used two frames ago; only blocks if the GPU is
+        // still that far behind
+        int slot{ static_cast<int>(m_frame & 1) };
+        PhaseQueries& queries{ m_phases[index] };
+        if (queries.pending[slot]) { collect(index, slot, true); }
+
+        queries.issuedNs[slot] = FrameProfiler::now();
+        glBeginQuery(GL_TIME_ELAPSED, queries.queries[slot]);
+        m_active = index;
+    }
+
+    void GpuTimer::end() {
+        if (m_active < 0) { return; }
+
+        glEndQuery(GL_TIME_ELAPSED);
+        m_phases[m_active].pending[m_frame & 1] = true;
+        m_active = -1;
+    }
+
+    void GpuTimer::endFrame() {
+        if (!m_available) { return; }
+
+        // Pick up last frame's results where the GPU got to them already
+        int previous{ static_cast<int>((m_frame + 1) & 1) };
+        for (int index{}; index < kPhases; ++index) {
+            if (m_phases[index].pending[previous]) { collect(index, previous, false); }
+        }
+        ++m_frame;
+    }
+
+    void GpuTimer::collect(int phase, int slot, bool wait) {
+        PhaseQueries& queries{ m_phases[phase] };
+        GLuint query{ queries.queries[slot] };
+
+        if (!wait) {
+            GLint available{};
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) { return; }
+        }
+
+        GLuint64 elapsedNs{};
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+        queries.pending[slot] = false;
+
+        uint64_t startNs{ queries.issuedNs[slot] };
+        m_profiler->record(
+            static_cast<FramePhase>(static_cast<int>(FramePhase::GpuUpload) + phase),
+            startNs, startNs + elapsedNs);
+    }
+
+} // namespace GreyScott
@@ -1,5 +1,9 @@
 #include "Renderer.hpp"
+#include "DisplayFormatGL.hpp"
 #include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 
 // Platform-specific GLSL version
@@ -10,18 +14,21 @@
 #endif
 
 namespace GreyScott {
-    // Simple vertex shader for full-screen quad
+    // Places the unit quad at uScreenRect and maps it onto uTexRect, so the
+    // same geometry serves the zoomed full view and every streamed tile
     const char* vertexShaderSource =
 GLSL_VERSION R"(
 
-layout(location = 0) in vec2 aPos;
 layout(location = 1) in vec2 aTexCoord;
 
+uniform vec4 uScreenRect; // x0, y0, x1, y1 in clip space
+uniform vec4 uTexRect;    // offset.xy, scale.zw
+
 out vec2 TexCoord;
 
 void main() {
-    gl_Position = vec4(aPos, 0.0, 1.0);
-    TexCoord = aTexCoord;
+    gl_Position = vec4(mix(uScreenRect.xy, uScreenRect.zw, aTexCoord), 0.0, 1.0);
+    TexCoord = uTexRect.xy + aTexCoord * uTexRect.zw;
 }
 )";
 
@@ -52,6 +59,20 @@ void main() {
     vec3 color = heatMap(u);
     FragColor = vec4(color, 1.0);
 }
+)";
+
+    // Colormapped (RGBA8) textures are displayed as-is
+    const char* blitFragmentShaderSource =
+GLSL_VERSION R"(
+
+in vec2 TexCoord;
+out vec4 FragColor;
+
+uniform sampler2D uTexture;
+
+void main() {
+    FragColor = vec4(texture(uTexture, TexCoord).rgb, 1.0);
+}
 )";
 
     Renderer::Renderer(int width, int height) :
@@ -68,12 +89,17 @@ void main() {
         {}
 
     Renderer::~Renderer() {
+        for (auto& slot : m_uploadSlots) {
+            if (slot.fence) { glDeleteSync(slot.fence); }
+            // Deleting a buffer also unmaps it
+            if (slot.buffer) { glDeleteBuffers(1, &slot.buffer); }
+        }
         if (m_shaderProgram) { glDeleteProgram(m_shaderProgram); }
         if (m_vertexShader) { glDeleteShader(m_vertexShader); }
         if (m_fragmentShader) { glDeleteShader(m_fragmentShader); }
         if (m_vbo) { glDeleteBuffers(1, &m_vbo); }
         if (m_vao) { glDeleteVertexArrays(1, &m_vao); }
-        if (m_texture && !m_usingExternalTexture) { 
+        if (m_texture && (!m_usingExternalTexture || m_tiled)) { 
             glDeleteTextures(1, &m_texture); 
         }
     }
@@ -84,14 +110,18 @@ void main() {
             return false;
         }
 
-        if (!m_usingExternalTexture) {
+        if (m_tiled) {
+            if (!createTileAtlas()) { return false; }
+        } else if (!m_usingExternalTexture) {
             if (!createTexture()) { return false; }
+            m_persistentUpload = createUploadRing();
         }
         if (!createShaders()) { return false; }
         if (!createQuad()) { return false; }
 
         std::cout << "Renderer initialized successfully\n";
-        std::cout << "  Grid size: " << m_width << "x" << m_height;
+        std::cout << "  Grid size: " << m_width << "x" << m_height
+                  << (m_tiled ? " (tiled)" : "") << '\n';
 
         m_initialized = true;
         return true;
@@ -107,9 +137,12 @@ void main() {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-        // Allocate texture memory (RG format for U and V concentrations)
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, m_width, m_height, 0, GL_RG,
-                     GL_FLOAT, nullptr);
+        // Allocate texture memory (U and V, or just U in the reduced formats)
+        GLTextureFormat format{ glTextureFormat(m_displayFormat) };
+        // R8/R16F rows aren't 4-byte aligned for every width
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, m_width, m_height,
+                     0, format.format, format.type, nullptr);
 
         GLenum error{ glGetError() };
         if (error != GL_NO_ERROR) {
@@ -118,7 +151,78 @@ void main() {
             return false;
         }
 
-        std::cout << "Created texture: " << m_width << "x" << m_height << '\n';
+        std::cout << "Created texture: " << m_width << "x" << m_height << " "
+                  << displayFormatName(m_displayFormat) << '\n';
+        return true;
+    }
+
+    bool Renderer::createTileAtlas() {
+        glGenTextures(1, &m_texture);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+
+        // Tiles sit next to each other in the atlas; nearest filtering keeps
+        // them from bleeding into their neighbours, and the level of detail
+        // already keeps texels close to one per pixel
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        GLTextureFormat format{ glTextureFormat(m_displayFormat) };
+        int atlasSize{ kAtlasTiles * kTileSize };
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, atlasSize, atlasSize,
+                     0, format.format, format.type, nullptr);
+
+        GLenum error{ glGetError() };
+        if (error != GL_NO_ERROR) {
+            std::cerr << "Failed to create tile atlas! OpenGL error: " << error
+                      << '\n';
+            return false;
+        }
+
+        m_tileSlots.assign(kAtlasTiles * kAtlasTiles, TileSlot{});
+        m_tileStaging.resize(static_cast<size_t>(kTileSize) * kTileSize *
+                             displayBytesPerTexel(m_displayFormat));
+
+        std::cout << "Created tile atlas: " << atlasSize << "x" << atlasSize << " "
+                  << displayFormatName(m_displayFormat) << ", " << kTileSize << "x"
+                  << kTileSize << " tiles\n";
+        return true;
+    }
+
+    bool Renderer::createUploadRing() {
+        if (!GLEW_ARB_buffer_storage) {
+            std::cout << "ARB_buffer_storage not available, using direct texture uploads\n";
+            return false;
+        }
+
+        GLsizeiptr size{ static_cast<GLsizeiptr>(displayBytesPerTexel(m_displayFormat)) *
+                         m_width * m_height };
+        GLbitfield flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+
+        for (auto& slot : m_uploadSlots) {
+            glGenBuffers(1, &slot.buffer);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+            glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+            slot.mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+            if (!slot.mapped) { break; }
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        GLenum error{ glGetError() };
+        bool mapped{ m_uploadSlots[kUploadSlots - 1].mapped != nullptr };
+        if (error != GL_NO_ERROR || !mapped) {
+            std::cerr << "Failed to create upload buffers! OpenGL error: " << error
+                      << ", using direct texture uploads\n";
+            for (auto& slot : m_uploadSlots) {
+                if (slot.buffer) { glDeleteBuffers(1, &slot.buffer); }
+                slot = UploadSlot{};
+            }
+            return false;
+        }
+
+        std::cout << "Created " << kUploadSlots << " persistent-mapped upload buffers\n";
         return true;
     }
 
@@ -140,8 +244,11 @@ void main() {
         }
 
         // Compile fragment shader
+        const char* fragmentSource{ m_displayFormat == DisplayFormat::RGBA8
+                                        ? blitFragmentShaderSource
+                                        : fragmentShaderSource };
         m_fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(m_fragmentShader, 1, &fragmentShaderSource, nullptr);
+        glShaderSource(m_fragmentShader, 1, &fragmentSource, nullptr);
         glCompileShader(m_fragmentShader);
 
         glGetShaderiv(m_fragmentShader, GL_COMPILE_STATUS, &success);
@@ -166,6 +273,9 @@ void main() {
             return false;
         }
 
+        m_screenRectLocation = glGetUniformLocation(m_shaderProgram, "uScreenRect");
+        m_texRectLocation = glGetUniformLocation(m_shaderProgram, "uTexRect");
+
         std::cout << "Shaders compiled and linked successfully\n";
         return true;
     }
@@ -225,31 +335,272 @@ void main() {
         std::cout << "Using external texture ID: " << externalTexture << '\n';
     }
 
-    void Renderer::updateTexture(const float* data) {
-        if (!m_initialized || !data || m_usingExternalTexture) { return; }
+    void Renderer::setTiledView(bool tiled) {
+        if (m_initialized) {
+            std::cerr << "Cannot change the view mode after initialization!\n";
+            return;
+        }
+
+        m_tiled = tiled;
+    }
+
+    void Renderer::setDisplayFormat(DisplayFormat format) {
+        if (m_initialized) {
+            std::cerr << "Cannot change display format after initialization!\n";
+            return;
+        }
+
+        m_displayFormat = format;
+    }
+
+    void Renderer::updateTexture(const void* data) {
+        if (!m_initialized || !data) { return; }
+
+        if (m_tiled) {
+            // Tiles are pulled from the source when they become visible
+            m_tileSource = static_cast<const uint8_t*>(data);
+            ++m_sourceVersion;
+            return;
+        }
+        if (m_usingExternalTexture) { return; }
+
+        if (void* slot{ acquireUploadBuffer() }) {
+            std::memcpy(slot, data, displayBytesPerTexel(m_displayFormat) * m_width * m_height);
+            commitUpload();
+            return;
+        }
 
+        GLTextureFormat format{ glTextureFormat(m_displayFormat) };
         glBindTexture(GL_TEXTURE_2D, m_texture);
-        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, GL_RG,
-                        GL_FLOAT, data);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, format.format,
+                        format.type, data);
     }
 
-    void Renderer::render() {
+    void* Renderer::acquireUploadBuffer() {
+        if (!m_persistentUpload) { return nullptr; }
+
+        UploadSlot& slot{ m_uploadSlots[m_uploadIndex] };
+        if (slot.fence) {
+            // Only blocks when the GPU is still sourcing a frame from this
+            // slot, i.e. when uploads run kUploadSlots frames behind
+            GLenum result{};
+            do {
+                result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                          1000000000);
+            } while (result == GL_TIMEOUT_EXPIRED);
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+
+        m_uploadAcquired = true;
+        return slot.mapped;
+    }
+
+    void Renderer::commitUpload() {
+        if (!m_uploadAcquired) { return; }
+        m_uploadAcquired = false;
+
+        UploadSlot& slot{ m_uploadSlots[m_uploadIndex] };
+
+        // Coherent mapping: the writes are visible without an explicit flush,
+        // and the copy into the texture runs asynchronously from the PBO
+        GLTextureFormat format{ glTextureFormat(m_displayFormat) };
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, format.format,
+                        format.type, nullptr);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_uploadIndex = (m_uploadIndex + 1) % kUploadSlots;
+    }
+
+    void Renderer::render(GLuint texture) {
         if (!m_initialized) { return; }
 
         // Use shader program
         glUseProgram(m_shaderProgram);
 
-        // Bind texture
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, m_texture);
-
         // Set texture uniform (already 0 by default, but explicit is better)
+        glActiveTexture(GL_TEXTURE0);
         GLint texLocation = glGetUniformLocation(m_shaderProgram, "uTexture");
         glUniform1i(texLocation, 0);
 
-        // Draw quad
         glBindVertexArray(m_vao);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        if (m_tiled) {
+            renderTiles();
+        } else {
+            glBindTexture(GL_TEXTURE_2D, texture ? texture : m_texture);
+
+            float screenRect[4]{ -1.0f, -1.0f, 1.0f, 1.0f };
+            float texRect[4]{ m_viewX, m_viewY, m_viewSize, m_viewSize };
+            drawQuad(screenRect, texRect);
+        }
         glBindVertexArray(0);
     }
+
+    void Renderer::drawQuad(const float screenRect[4], const float texRect[4]) {
+        glUniform4fv(m_screenRectLocation, 1, screenRect);
+        glUniform4fv(m_texRectLocation, 1, texRect);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    }
+
+    void Renderer::renderTiles() {
+        m_visibleTiles = 0;
+        m_tileUploads = 0;
+        if (!m_tileSource) { return; }
+        ++m_frameIndex;
+
+        // Pick the level whose texels are closest to (but not below) one
+        // per pixel; level L keeps every 2^L-th cell in each direction
+        GLint viewport[4]{};
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        float cellsPerPixel{ m_viewSize * std::max(static_cast<float>(m_width) / viewport[2],
+                                                   static_cast<float>(m_height) / viewport[3]) };
+        int level{};
+        while ((2 << level) <= cellsPerPixel && (m_width >> (level + 1)) > 0 &&
+               (m_height >> (level + 1)) > 0) {
+            ++level;
+        }
+        m_viewLevel = level;
+
+        int stride{ 1 << level };
+        int levelWidth{ (m_width + stride - 1) / stride };
+        int levelHeight{ (m_height + stride - 1) / stride };
+        float tileCells{ static_cast<float>(kTileSize * stride) };
+
+        // Visible cell range
+        float x0{ m_viewX * m_width };
+        float y0{ m_viewY * m_height };
+        float x1{ (m_viewX + m_viewSize) * m_width };
+        float y1{ (m_viewY + m_viewSize) * m_height };
+
+        int firstX{ static_cast<int>(x0 / tileCells) };
+        int firstY{ static_cast<int>(y0 / tileCells) };
+        int lastX{ std::min(static_cast<int>(std::ceil(x1 / tileCells)),
+                            (levelWidth + kTileSize - 1) / kTileSize) };
+        int lastY{ std::min(static_cast<int>(std::ceil(y1 / tileCells)),
+                            (levelHeight + kTileSize - 1) / kTileSize) };
+
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        float atlasSize{ static_cast<float>(kAtlasTiles * kTileSize) };
+        for (int tileY{ firstY }; tileY < lastY; ++tileY) {
+            for (int tileX{ firstX }; tileX < lastX; ++tileX) {
+                int slot{ residentTile(level, tileX, tileY) };
+                if (slot < 0) { continue; } // More tiles visible than slots
+
+                int width{ std::min(kTileSize, levelWidth - tileX * kTileSize) };
+                int height{ std::min(kTileSize, levelHeight - tileY * kTileSize) };
+                if (m_tileSlots[slot].version != m_sourceVersion) {
+                    uploadTile(slot, level, tileX, tileY, width, height);
+                }
+
+                // Cells covered by the tile, placed relative to the view
+                float cellX{ tileX * tileCells };
+                float cellY{ tileY * tileCells };
+                float screenRect[4]{
+                    (cellX - x0) / (x1 - x0) * 2.0f - 1.0f,
+                    (cellY - y0) / (y1 - y0) * 2.0f - 1.0f,
+                    (cellX + width * stride - x0) / (x1 - x0) * 2.0f - 1.0f,
+                    (cellY + height * stride - y0) / (y1 - y0) * 2.0f - 1.0f
+                };
+                float texRect[4]{
+                    (slot % kAtlasTiles) * kTileSize / atlasSize,
+                    (slot / kAtlasTiles) * kTileSize / atlasSize,
+                    width / atlasSize,
+                    height / atlasSize
+                };
+                drawQuad(screenRect, texRect);
+                ++m_visibleTiles;
+            }
+        }
+    }
+
+    int Renderer::residentTile(int level, int tileX, int tileY) {
+        uint64_t key{ static_cast<uint64_t>(level) << 48 |
+                      static_cast<uint64_t>(tileY) << 24 | static_cast<uint64_t>(tileX) };
+        auto found{ m_tileLookup.find(key) };
+        if (found != m_tileLookup.end()) {
+            m_tileSlots[found->second].lastUsed = m_frameIndex;
+            return found->second;
+        }
+
+        // Evict the least recently used tile that this frame doesn't need
+        int victim{ -1 };
+        for (int i{}; i < static_cast<int>(m_tileSlots.size()); ++i) {
+            if (m_tileSlots[i].lastUsed == m_frameIndex) { continue; }
+            if (victim < 0 || m_tileSlots[i].lastUsed < m_tileSlots[victim].lastUsed) {
+                victim = i;
+            }
+        }
+        if (victim < 0) { return -1; }
+
+        TileSlot& slot{ m_tileSlots[victim] };
+        if (slot.key != UINT64_MAX) { m_tileLookup.erase(slot.key); }
+        slot = TileSlot{ key, 0, m_frameIndex };
+        m_tileLookup[key] = victim;
+        return victim;
+    }
+
+    void Renderer::uploadTile(int slot, int level, int tileX, int tileY, int width,
+                              int height) {
+        size_t texelBytes{ displayBytesPerTexel(m_displayFormat) };
+        int stride{ 1 << level };
+
+        for (int row{}; row < height; ++row) {
+            size_t cellY{ static_cast<size_t>(tileY * kTileSize + row) * stride };
+            size_t cellX{ static_cast<size_t>(tileX) * kTileSize * stride };
+            const uint8_t* source{ m_tileSource + (cellY * m_width + cellX) * texelBytes };
+            uint8_t* target{ m_tileStaging.data() + static_cast<size_t>(row) * width * texelBytes };
+
+            if (stride == 1) {
+                std::memcpy(target, source, width * texelBytes);
+                continue;
+            }
+            for (int column{}; column < width; ++column) {
+                std::memcpy(target + column * texelBytes,
+                            source + static_cast<size_t>(column) * stride * texelBytes,
+                            texelBytes);
+            }
+        }
+
+        GLTextureFormat format{ glTextureFormat(m_displayFormat) };
+        glTexSubImage2D(GL_TEXTURE_2D, 0, (slot % kAtlasTiles) * kTileSize,
+                        (slot / kAtlasTiles) * kTileSize, width, height, format.format,
+                        format.type, m_tileStaging.data());
+
+        m_tileSlots[slot].version = m_sourceVersion;
+        ++m_tileUploads;
+    }
+
+    void Renderer::zoomAt(float x, float y, float factor) {
+        // Keep the grid point under (x, y) in place
+        float gridX{ m_viewX + x * m_viewSize };
+        float gridY{ m_viewY + y * m_viewSize };
+
+        // Zooming stops at 16 cells across the smaller side
+        float minSize{ std::min(1.0f, 16.0f / std::min(m_width, m_height)) };
+        m_viewSize = std::clamp(m_viewSize * factor, minSize, 1.0f);
+        m_viewX = gridX - x * m_viewSize;
+        m_viewY = gridY - y * m_viewSize;
+        clampView();
+    }
+
+    void Renderer::pan(float dx, float dy) {
+        // The grid follows the cursor
+        m_viewX -= dx * m_viewSize;
+        m_viewY -= dy * m_viewSize;
+        clampView();
+    }
+
+    void Renderer::resetView() {
+        m_viewX = 0.0f;
+        m_viewY = 0.0f;
+        m_viewSize = 1.0f;
+    }
+
+    void Renderer::clampView() {
+        m_viewX = std::clamp(m_viewX, 0.0f, 1.0f - m_viewSize);
+        m_viewY = std::clamp(m_viewY, 0.0f, 1.0f - m_viewSize);
+    }
 } // namespace GreyScott
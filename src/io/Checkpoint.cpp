@@ -0,0 +1,185 @@
+#include "Checkpoint.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace GreyScott {
+    namespace {
+        bool validateHeader(const CheckpointHeader& header, uint64_t fileSize) {
+            if (std::memcmp(header.magic, CheckpointHeader::kMagic, sizeof(header.magic)) != 0) {
+                std::cerr << "Not a checkpoint file\n";
+                return false;
+            }
+            if (header.version != CheckpointHeader::kVersion) {
+                std::cerr << "Unsupported checkpoint version: " << header.version << '\n';
+                return false;
+            }
+            if (header.layout != CheckpointHeader::Layout::InterleavedUV ||
+                header.channels != 2 || header.bytesPerValue != sizeof(float)) {
+                std::cerr << "Unsupported checkpoint layout or precision\n";
+                return false;
+            }
+
+            uint64_t expected{ static_cast<uint64_t>(header.width) * header.height *
+                               header.channels * header.bytesPerValue };
+            if (header.width == 0 || header.height == 0 || header.dataBytes != expected ||
+                header.dataOffset < sizeof(CheckpointHeader) ||
+                header.dataOffset % sizeof(float) != 0 ||
+                fileSize < header.dataOffset + header.dataBytes) {
+                std::cerr << "Checkpoint is truncated or corrupt\n";
+                return false;
+            }
+            return true;
+        }
+
+    } // namespace
+
+    bool writeCheckpoint(const std::string& path, const CheckpointInfo& info,
+                         const float* field, const FileWriterOptions& io) {
+        CheckpointHeader header{};
+        std::memcpy(header.magic, CheckpointHeader::kMagic, sizeof(header.magic));
+        header.width = static_cast<uint32_t>(info.width);
+        header.height = static_cast<uint32_t>(info.height);
+        header.seed = info.seed;
+        header.step = info.step;
+        header.params = info.params;
+        header.dataBytes = static_cast<uint64_t>(info.width) * info.height * 2 * sizeof(float);
+
+        std::string tempPath{ path + ".tmp" };
+        FileWriter file{};
+        if (!file.open(tempPath, io)) { return false; }
+
+        // Padded to dataOffset, which keeps the field block-aligned
+        std::vector<char, AlignedAllocator<char>> prefix(header.dataOffset);
+        std::memcpy(prefix.data(), &header, sizeof(header));
+        bool written{ file.write(prefix.data(), prefix.size()) &&
+                      file.write(field, header.dataBytes) };
+        // Synced, so the data is durable before the rename makes it the checkpoint
+        if (!file.close(true) || !written) {
+            std::cerr << "Failed to write checkpoint file: " << tempPath << '\n';
+            return false;
+        }
+
+#ifdef _WIN32
+        std::remove(path.c_str()); // rename doesn't replace on Windows
+#endif
+        if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::cerr << "Failed to move checkpoint into place: " << path << '\n';
+            return false;
+        }
+        return true;
+    }
+
+    CheckpointWriter::~CheckpointWriter() { wait(); }
+
+    void CheckpointWriter::save(const std::string& path, const CheckpointInfo& info,
+                                const float* field) {
+        wait();
+
+        m_field.assign(field, field + static_cast<size_t>(info.width) * info.height * 2);
+        m_busy.store(true, std::memory_order_release);
+        m_thread = std::thread([this, path, info] {
+            if (writeCheckpoint(path, info, m_field.data(), m_io)) {
+                std::cout << "Saved checkpoint at step " << info.step << " to " << path
+                          << '\n';
+            }
+            m_busy.store(false, std::memory_order_release);
+        });
+    }
+
+    void CheckpointWriter::wait() {
+        if (m_thread.joinable()) { m_thread.join(); }
+    }
+
+    MappedCheckpoint::~MappedCheckpoint() { close(); }
+
+    bool MappedCheckpoint::open(const std::string& path) {
+        close();
+
+        CheckpointHeader header{};
+#ifndef _WIN32
+        int fd{ ::open(path.c_str(), O_RDONLY) };
+        if (fd < 0) {
+            std::cerr << "Failed to open checkpoint file: " << path << '\n';
+            return false;
+        }
+
+        struct stat status{};
+        if (::fstat(fd, &status) != 0 ||
+            static_cast<size_t>(status.st_size) < sizeof(CheckpointHeader)) {
+            std::cerr << "Checkpoint is truncated or corrupt\n";
+            ::close(fd);
+            return false;
+        }
+
+        m_mappingSize = static_cast<size_t>(status.st_size);
+        m_mapping = ::mmap(nullptr, m_mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps the file alive
+        if (m_mapping == MAP_FAILED) {
+            std::cerr << "Failed to map checkpoint file: " << path << '\n';
+            m_mapping = nullptr;
+            return false;
+        }
+
+        std::memcpy(&header, m_mapping, sizeof(header));
+        if (!validateHeader(header, m_mappingSize)) {
+            close();
+            return false;
+        }
+
+        // The whole field is about to be copied front to back
+        const auto* base{ static_cast<const char*>(m_mapping) };
+        ::madvise(const_cast<char*>(base), m_mappingSize, MADV_SEQUENTIAL);
+        ::madvise(const_cast<char*>(base), m_mappingSize, MADV_WILLNEED);
+        m_field = reinterpret_cast<const float*>(base + header.dataOffset);
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open checkpoint file: " << path << '\n';
+            return false;
+        }
+
+        uint64_t fileSize{ static_cast<uint64_t>(file.tellg()) };
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file.good() || !validateHeader(header, fileSize)) { return false; }
+
+        m_buffer.resize(header.dataBytes / sizeof(float));
+        file.seekg(header.dataOffset);
+        file.read(reinterpret_cast<char*>(m_buffer.data()),
+                  static_cast<std::streamsize>(header.dataBytes));
+        if (!file.good()) {
+            std::cerr << "Failed to read checkpoint file: " << path << '\n';
+            return false;
+        }
+        m_field = m_buffer.data();
+#endif
+
+        m_info.width = static_cast<int>(header.width);
+        m_info.height = static_cast<int>(header.height);
+        m_info.params = header.params;
+        m_info.step = header.step;
+        m_info.seed = header.seed;
+        return true;
+    }
+
+    void MappedCheckpoint::close() {
+#ifndef _WIN32
+        if (m_mapping) { ::munmap(m_mapping, m_mappingSize); }
+#endif
+        m_mapping = nullptr;
+        m_mappingSize = 0;
+        m_field = nullptr;
+        m_buffer.clear();
+        m_buffer.shrink_to_fit();
+    }
+
+} // namespace GreyScott
@@ -0,0 +1,395 @@
+#include "FileWriter.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+    // Headers from before 5.6 have neither the opcode probe nor IORING_OP_WRITE
+    #ifdef IO_URING_OP_SUPPORTED
+        #include <sys/mman.h>
+        #include <sys/syscall.h>
+        #include <vector>
+        #define GREYSCOTT_HAS_URING 1
+    #endif
+#endif
+
+namespace GreyScott {
+    namespace {
+        bool isPageAligned(const void* pointer) {
+            return reinterpret_cast<uintptr_t>(pointer) % kPageAlignment == 0;
+        }
+
+        size_t roundUpToPage(size_t bytes) {
+            return (bytes + kPageAlignment - 1) / kPageAlignment * kPageAlignment;
+        }
+    } // namespace
+
+#ifdef GREYSCOTT_HAS_URING
+    // Minimal io_uring over the raw syscalls (no liburing dependency)
+    struct FileWriter::Ring {
+        ~Ring() {
+            if (sqes) { ::munmap(sqes, sqesBytes); }
+            if (cqMap && cqMap != sqMap) { ::munmap(cqMap, cqMapBytes); }
+            if (sqMap) { ::munmap(sqMap, sqMapBytes); }
+            if (fd >= 0) { ::close(fd); }
+        }
+
+        bool setup(unsigned depth) {
+            io_uring_params params{};
+            fd = static_cast<int>(::syscall(__NR_io_uring_setup, depth, &params));
+            if (fd < 0) { return false; } // Old kernel, or blocked by seccomp
+            // 5.1-5.5 set up a ring, but every IORING_OP_WRITE fails with -EINVAL
+            if (!supportsWrite()) { return false; }
+
+            sqMapBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqMapBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool singleMap{ (params.features & IORING_FEAT_SINGLE_MMAP) != 0 };
+            if (singleMap) { sqMapBytes = cqMapBytes = std::max(sqMapBytes, cqMapBytes); }
+
+            sqMap = ::mmap(nullptr, sqMapBytes, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sqMap == MAP_FAILED) {
+                sqMap = nullptr;
+                return false;
+            }
+            cqMap = singleMap ? sqMap
+                              : ::mmap(nullptr, cqMapBytes, PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cqMap == MAP_FAILED) {
+                cqMap = nullptr;
+                return false;
+            }
+            sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqeMap{ ::mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES) };
+            if (sqeMap == MAP_FAILED) { return false; }
+            sqes = static_cast<io_uring_sqe*>(sqeMap);
+
+            auto* sq{ static_cast<uint8_t*>(sqMap) };
+            auto* cq{ static_cast<uint8_t*>(cqMap) };
+            sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        // IORING_REGISTER_PROBE itself arrived with IORING_OP_WRITE in 5.6
+        bool supportsWrite() const {
+            constexpr unsigned kProbeOps{ 256 };
+            std::vector<uint8_t> buffer(sizeof(io_uring_probe) +
+                                        kProbeOps * sizeof(io_uring_probe_op));
+            auto* probe{ reinterpret_cast<io_uring_probe*>(buffer.data()) };
+            if (::syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe,
+                          kProbeOps) < 0) {
+                return false;
+            }
+            return probe->last_op >= IORING_OP_WRITE && probe->ops_len > IORING_OP_WRITE &&
+                   (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED) != 0;
+        }
+
+        // Queues one write and hands it to the kernel
+        bool push(int file, const void* data, size_t bytes, uint64_t offset, uint64_t tag) {
+            unsigned tail{ *sqTail };
+            unsigned index{ tail & sqMask };
+            io_uring_sqe& sqe{ sqes[index] };
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_WRITE;
+            sqe.fd = file;
+            sqe.addr = reinterpret_cast<uint64_t>(data);
+            sqe.len = static_cast<uint32_t>(bytes);
+            sqe.off = offset;
+            sqe.user_data = tag;
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+
+            if (::syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0) < 0) { return false; }
+            ++inFlight;
+            return true;
+        }
+
+        int fd{ -1 };
+        void* sqMap{};
+        void* cqMap{};
+        size_t sqMapBytes{};
+        size_t cqMapBytes{};
+        size_t sqesBytes{};
+        io_uring_sqe* sqes{};
+        io_uring_cqe* cqes{};
+        unsigned* sqTail{};
+        unsigned* sqArray{};
+        unsigned* cqHead{};
+        unsigned* cqTail{};
+        unsigned sqMask{};
+        unsigned cqMask{};
+        unsigned inFlight{};
+    };
+#else
+    struct FileWriter::Ring {};
+#endif
+
+    FileWriter::FileWriter() = default;
+
+    FileWriter::~FileWriter() { close(); }
+
+    bool FileWriter::isOpen() const {
+#ifdef _WIN32
+        return m_file != nullptr;
+#else
+        return m_fd >= 0;
+#endif
+    }
+
+    bool FileWriter::open(const std::string& path, const FileWriterOptions& options) {
+        close();
+        m_options = options;
+        m_options.queueDepth = std::max(1, options.queueDepth);
+        m_options.chunkBytes = roundUpToPage(std::max(options.chunkBytes, kPageAlignment));
+        m_size = 0;
+        m_offset = 0;
+        m_fill = 0;
+        m_current = -1;
+        m_failed = false;
+        m_direct = false;
+
+#ifdef _WIN32
+        if (options.mode == IOMode::Direct) {
+            std::cerr << "Direct I/O isn't supported on Windows, using buffered writes\n";
+        }
+        m_file = std::fopen(path.c_str(), "wb");
+        if (!m_file) {
+            std::cerr << "Failed to open file for writing: " << path << '\n';
+            return false;
+        }
+        return true;
+#else
+        int flags{ O_WRONLY | O_CREAT | O_TRUNC };
+        if (options.mode == IOMode::Direct) {
+    #ifdef O_DIRECT
+            m_fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+            // e.g. tmpfs rejects O_DIRECT
+            if (m_fd < 0 && errno == EINVAL) {
+                std::cerr << "Direct I/O unsupported for " << path
+                          << ", using buffered writes\n";
+            }
+            m_direct = m_fd >= 0;
+    #endif
+        }
+        if (m_fd < 0) { m_fd = ::open(path.c_str(), flags, 0644); }
+        if (m_fd < 0) {
+            std::cerr << "Failed to open file for writing: " << path << " ("
+                      << std::strerror(errno) << ")\n";
+            return false;
+        }
+    #if !defined(O_DIRECT) && defined(F_NOCACHE)
+        // macOS: closest equivalent, bypasses the unified buffer cache
+        if (options.mode == IOMode::Direct) {
+            m_direct = ::fcntl(m_fd, F_NOCACHE, 1) == 0;
+        }
+    #endif
+
+    #ifdef GREYSCOTT_HAS_URING
+        if (m_direct && options.useUring) {
+            m_ring = std::make_unique<Ring>();
+            if (!m_ring->setup(static_cast<unsigned>(m_options.queueDepth))) {
+                std::cerr << "io_uring unavailable, using pwrite\n";
+                m_ring.reset();
+            }
+        }
+    #endif
+        return true;
+#endif
+    }
+
+    bool FileWriter::writeAt(const uint8_t* data, size_t bytes, uint64_t offset) {
+#ifdef _WIN32
+        (void)offset;
+        return std::fwrite(data, 1, bytes, m_file) == bytes;
+#else
+        while (bytes > 0) {
+            ssize_t written{ ::pwrite(m_fd, data, bytes, static_cast<off_t>(offset)) };
+            if (written < 0) {
+                if (errno == EINTR) { continue; }
+                std::cerr << "Failed to write file! Error: " << std::strerror(errno) << '\n';
+                return false;
+            }
+            data += written;
+            bytes -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+        return true;
+#endif
+    }
+
+    bool FileWriter::submit(const uint8_t* data, size_t bytes, int staging) {
+        // After a failed write the file has a hole where it should have
+        // gone, so every later write (and wait/close) fails as well
+#ifdef GREYSCOTT_HAS_URING
+        if (m_ring) {
+            if (m_ring->inFlight >= static_cast<unsigned>(m_options.queueDepth) && !reap(1)) {
+                m_failed = true;
+                return false;
+            }
+
+            // The tag carries what the completion must check and release
+            uint64_t tag{ (static_cast<uint64_t>(bytes) << 16) |
+                          static_cast<uint64_t>(staging + 1) };
+            if (staging >= 0) { m_stagingBusy[staging] = true; }
+            if (!m_ring->push(m_fd, data, bytes, m_offset, tag)) {
+                std::cerr << "Failed to submit write! Error: " << std::strerror(errno) << '\n';
+                if (staging >= 0) { m_stagingBusy[staging] = false; }
+                m_failed = true;
+                return false;
+            }
+            m_offset += bytes;
+            return true;
+        }
+#endif
+        (void)staging;
+        if (!writeAt(data, bytes, m_offset)) {
+            m_failed = true;
+            return false;
+        }
+        m_offset += bytes;
+        return true;
+    }
+
+    bool FileWriter::reap(unsigned minimum) {
+#ifdef GREYSCOTT_HAS_URING
+        Ring& ring{ *m_ring };
+        minimum = std::min(minimum, ring.inFlight);
+        while (minimum > 0) {
+            if (::syscall(__NR_io_uring_enter, ring.fd, 0, minimum, IORING_ENTER_GETEVENTS,
+                          nullptr, 0) < 0 && errno != EINTR) {
+                std::cerr << "Failed to wait for writes! Error: " << std::strerror(errno) << '\n';
+                return false;
+            }
+
+            unsigned head{ *ring.cqHead };
+            unsigned tail{ __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE) };
+            for (; head != tail; ++head) {
+                const io_uring_cqe& cqe{ ring.cqes[head & ring.cqMask] };
+                int staging{ static_cast<int>(cqe.user_data & 0xffff) - 1 };
+                auto expected{ static_cast<int64_t>(cqe.user_data >> 16) };
+                if (staging >= 0) { m_stagingBusy[staging] = false; }
+                if (cqe.res != expected) {
+                    std::cerr << "Failed to write file! Error: "
+                              << (cqe.res < 0 ? std::strerror(-cqe.res) : "short write") << '\n';
+                    m_failed = true;
+                }
+                --ring.inFlight;
+                minimum = minimum > 0 ? minimum - 1 : 0;
+            }
+            __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+        }
+#else
+        (void)minimum;
+#endif
+        return !m_failed;
+    }
+
+    int FileWriter::acquireStaging() {
+        for (;;) {
+            for (size_t i{}; i < m_staging.size(); ++i) {
+                if (!m_stagingBusy[i]) { return static_cast<int>(i); }
+            }
+            // One per write in flight, plus the one being filled
+            if (m_staging.size() <= static_cast<size_t>(m_options.queueDepth)) {
+                m_staging.emplace_back(m_options.chunkBytes);
+                m_stagingBusy.push_back(false);
+                return static_cast<int>(m_staging.size() - 1);
+            }
+            if (!reap(1)) { return -1; }
+        }
+    }
+
+    bool FileWriter::submitStaging(bool final) {
+        if (m_current < 0 || m_fill == 0) { return true; }
+
+        size_t bytes{ m_fill };
+        if (final && m_direct) {
+            // Direct writes cover whole blocks; close() trims the padding
+            bytes = roundUpToPage(m_fill);
+            std::fill(m_staging[m_current].begin() + m_fill,
+                      m_staging[m_current].begin() + bytes, uint8_t{ 0 });
+        }
+        bool ok{ submit(m_staging[m_current].data(), bytes, m_current) };
+        m_current = -1;
+        m_fill = 0;
+        return ok;
+    }
+
+    bool FileWriter::write(const void* data, size_t bytes) {
+        if (!isOpen() || m_failed) { return false; }
+        m_size += bytes;
+
+        const auto* source{ static_cast<const uint8_t*>(data) };
+        if (!m_direct) {
+            // The page cache does the buffering
+            return submit(source, bytes, -1);
+        }
+
+        while (bytes > 0) {
+            // Aligned data goes out in place once the staged data ends on a
+            // block boundary, so every direct write stays block-aligned
+            if (isPageAligned(source) && bytes >= kPageAlignment && m_fill % kPageAlignment == 0) {
+                if (!submitStaging(false)) { return false; }
+                size_t chunk{ std::min(bytes / kPageAlignment * kPageAlignment,
+                                       m_options.chunkBytes) };
+                if (!submit(source, chunk, -1)) { return false; }
+                source += chunk;
+                bytes -= chunk;
+                continue;
+            }
+
+            if (m_current < 0) {
+                m_current = acquireStaging();
+                if (m_current < 0) { return false; }
+            }
+            size_t count{ std::min(bytes, m_options.chunkBytes - m_fill) };
+            std::memcpy(m_staging[m_current].data() + m_fill, source, count);
+            m_fill += count;
+            source += count;
+            bytes -= count;
+            if (m_fill == m_options.chunkBytes && !submitStaging(false)) { return false; }
+        }
+        return true;
+    }
+
+    bool FileWriter::wait() {
+        if (m_ring) { return reap(m_ring->inFlight); }
+        return !m_failed;
+    }
+
+    bool FileWriter::close(bool sync) {
+        if (!isOpen()) { return true; }
+
+        bool ok{ submitStaging(true) && wait() };
+#ifdef _WIN32
+        ok &= std::fflush(m_file) == 0;
+        std::fclose(m_file);
+        m_file = nullptr;
+#else
+        if (ok && m_offset != m_size && ::ftruncate(m_fd, static_cast<off_t>(m_size)) != 0) {
+            std::cerr << "Failed to trim file! Error: " << std::strerror(errno) << '\n';
+            ok = false;
+        }
+        if (ok && sync) { ok = ::fsync(m_fd) == 0; }
+        ::close(m_fd);
+        m_fd = -1;
+#endif
+        m_ring.reset();
+        return ok && !m_failed;
+    }
+
+} // namespace GreyScott
@@ -0,0 +1,293 @@
+#include "FrameExporter.hpp"
+#include "DisplayFormat.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#ifdef USE_ZLIB
+    #include <zlib.h>
+#endif
+
+#ifndef _WIN32
+    #include <csignal>
+#endif
+
+namespace GreyScott {
+    namespace {
+        void appendBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+            for (int shift{ 24 }; shift >= 0; shift -= 8) {
+                out.push_back(static_cast<uint8_t>(value >> shift));
+            }
+        }
+
+#ifndef USE_ZLIB
+        uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size) {
+            static const auto table{ [] {
+                std::vector<uint32_t> entries(256);
+                for (uint32_t i{}; i < 256; ++i) {
+                    uint32_t value{ i };
+                    for (int bit{}; bit < 8; ++bit) {
+                        value = (value & 1u) ? 0xedb88320u ^ (value >> 1) : value >> 1;
+                    }
+                    entries[i] = value;
+                }
+                return entries;
+            }() };
+
+            crc = ~crc;
+            for (size_t i{}; i < size; ++i) { crc = table[(crc ^ data[i]) & 0xffu] ^ (crc >> 8); }
+            return ~crc;
+        }
+
+        uint32_t adler32(const uint8_t* data, size_t size) {
+            uint32_t a{ 1 };
+            uint32_t b{};
+            while (size > 0) {
+                // Largest run before b can overflow
+                size_t run{ std::min<size_t>(size, 5552) };
+                for (size_t i{}; i < run; ++i) {
+                    a += data[i];
+                    b += a;
+                }
+                a %= 65521u;
+                b %= 65521u;
+                data += run;
+                size -= run;
+            }
+            return (b << 16) | a;
+        }
+
+        // A zlib stream of stored (uncompressed) deflate blocks
+        void storeDeflate(const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+            out.clear();
+            out.push_back(0x78);
+            out.push_back(0x01);
+            size_t offset{};
+            do {
+                size_t block{ std::min<size_t>(in.size() - offset, 65535) };
+                bool last{ offset + block == in.size() };
+                out.push_back(last ? 1 : 0);
+                out.push_back(static_cast<uint8_t>(block));
+                out.push_back(static_cast<uint8_t>(block >> 8));
+                out.push_back(static_cast<uint8_t>(~block));
+                out.push_back(static_cast<uint8_t>(~block >> 8));
+                out.insert(out.end(), in.begin() + offset, in.begin() + offset + block);
+                offset += block;
+            } while (offset < in.size());
+            appendBigEndian(out, adler32(in.data(), in.size()));
+        }
+#endif
+
+        void appendChunk(std::vector<uint8_t>& png, const char* type,
+                         const uint8_t* data, size_t size) {
+            appendBigEndian(png, static_cast<uint32_t>(size));
+            size_t start{ png.size() };
+            png.insert(png.end(), type, type + 4);
+            png.insert(png.end(), data, data + size);
+            uint32_t crc{ static_cast<uint32_t>(
+                crc32(0, png.data() + start, static_cast<unsigned>(png.size() - start))) };
+            appendBigEndian(png, crc);
+        }
+
+        // Row 0 of the field is drawn at the bottom of the screen, images
+        // start at the top
+        void colormapFlipped(const float* field, int width, int height, uint8_t* rgb) {
+            size_t stride{ static_cast<size_t>(width) * 3 };
+            for (int y{}; y < height; ++y) {
+                convertHeatMapRGB(field + static_cast<size_t>(height - 1 - y) * width * 2,
+                                  static_cast<size_t>(width), rgb + stride * y);
+            }
+        }
+    } // namespace
+
+    // Every row uses the Up filter, which turns the smooth gradients of the
+    // heat map into runs of small values
+    bool encodePNG(const uint8_t* rgb, int width, int height, int level,
+                   std::vector<uint8_t>& png) {
+        thread_local std::vector<uint8_t> filtered{};
+        thread_local std::vector<uint8_t> packed{};
+
+        size_t stride{ static_cast<size_t>(width) * 3 };
+        filtered.resize((stride + 1) * height);
+        for (int y{}; y < height; ++y) {
+            uint8_t* row{ filtered.data() + (stride + 1) * y };
+            const uint8_t* current{ rgb + stride * y };
+            row[0] = 2;
+            if (y == 0) {
+                std::memcpy(row + 1, current, stride);
+                continue;
+            }
+            const uint8_t* above{ current - stride };
+            for (size_t x{}; x < stride; ++x) {
+                row[x + 1] = static_cast<uint8_t>(current[x] - above[x]);
+            }
+        }
+
+#ifdef USE_ZLIB
+        uLongf packedSize{ compressBound(static_cast<uLong>(filtered.size())) };
+        packed.resize(packedSize);
+        int result{ compress2(packed.data(), &packedSize, filtered.data(),
+                              static_cast<uLong>(filtered.size()), level) };
+        if (result != Z_OK) {
+            std::cerr << "Failed to compress PNG frame! Error: " << result << '\n';
+            return false;
+        }
+        packed.resize(packedSize);
+#else
+        (void)level;
+        storeDeflate(filtered, packed);
+#endif
+
+        uint8_t header[13]{};
+        for (int i{}; i < 4; ++i) {
+            header[i] = static_cast<uint8_t>(width >> (24 - i * 8));
+            header[4 + i] = static_cast<uint8_t>(height >> (24 - i * 8));
+        }
+        header[8] = 8; // Bit depth
+        header[9] = 2; // Truecolor
+
+        static constexpr uint8_t signature[8]{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+        png.assign(signature, signature + sizeof(signature));
+        appendChunk(png, "IHDR", header, sizeof(header));
+        appendChunk(png, "IDAT", packed.data(), packed.size());
+        appendChunk(png, "IEND", nullptr, 0);
+        return true;
+    }
+
+    FrameExporter::~FrameExporter() {
+        close();
+    }
+
+    bool FrameExporter::open(const FrameExportOptions& options, int width, int height) {
+        close();
+        m_options = options;
+        m_width = width;
+        m_height = height;
+        m_pipeBroken = false;
+        m_exported = 0;
+        m_dropped = 0;
+
+        SnapshotOptions pool{};
+        pool.interval = options.interval;
+        pool.buffers = options.buffers;
+        pool.backpressure = options.backpressure;
+        pool.threads = options.threads > 0
+                           ? options.threads
+                           : std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
+
+        if (options.format == FrameFormat::Pipe) {
+#ifdef _WIN32
+            m_pipe = _popen(options.target.c_str(), "wb");
+#else
+            // A dead encoder shows up as a failed write instead of killing us
+            std::signal(SIGPIPE, SIG_IGN);
+            m_pipe = popen(options.target.c_str(), "w");
+#endif
+            if (!m_pipe) {
+                std::cerr << "Failed to start frame encoder! Error: " << std::strerror(errno) << '\n';
+                return false;
+            }
+            pool.threads = 1;
+            std::cout << "Streaming " << width << "x" << height
+                      << " rgb24 frames to: " << options.target << '\n';
+        } else {
+            std::cout << "Recording " << frameFormatName(options.format) << " frames to "
+                      << options.target << "_<step>." << frameFormatName(options.format)
+                      << " on " << pool.threads << " threads\n";
+        }
+
+        m_writer = std::make_unique<SnapshotWriter>(
+            pool, static_cast<size_t>(width) * height * 2,
+            [this](const CheckpointInfo& info, const float* field) {
+                return writeFrame(info, field);
+            });
+        return true;
+    }
+
+    void FrameExporter::close() {
+        if (m_writer) {
+            // Encoder threads drain the queue before they exit
+            m_writer->flush();
+            m_exported = m_writer->getWritten();
+            m_dropped = m_writer->getDropped();
+            m_writer.reset();
+        }
+        if (m_pipe) {
+#ifdef _WIN32
+            _pclose(m_pipe);
+#else
+            pclose(m_pipe);
+#endif
+            m_pipe = nullptr;
+        }
+    }
+
+    bool FrameExporter::isDue(uint64_t previous, uint64_t step) const {
+        return m_writer && m_writer->isDue(previous, step);
+    }
+
+    bool FrameExporter::capture(const CheckpointInfo& info,
+                                const SnapshotWriter::FillFunction& fill) {
+        return m_writer && m_writer->capture(info, fill);
+    }
+
+    uint64_t FrameExporter::getExported() const {
+        return m_writer ? m_writer->getWritten() : m_exported;
+    }
+
+    uint64_t FrameExporter::getDropped() const {
+        return m_writer ? m_writer->getDropped() : m_dropped;
+    }
+
+    size_t FrameExporter::getQueued() const {
+        return m_writer ? m_writer->getQueued() : 0;
+    }
+
+    bool FrameExporter::writeFrame(const CheckpointInfo& info, const float* field) {
+        // Per encoder thread, reused across frames
+        thread_local std::vector<uint8_t> rgb{};
+        thread_local std::vector<uint8_t> encoded{};
+
+        rgb.resize(static_cast<size_t>(m_width) * m_height * 3);
+        colormapFlipped(field, m_width, m_height, rgb.data());
+
+        if (m_pipe) {
+            if (m_pipeBroken) { return false; }
+            if (std::fwrite(rgb.data(), 1, rgb.size(), m_pipe) != rgb.size()) {
+                std::cerr << "Failed to stream frame to encoder! Error: "
+                          << std::strerror(errno) << '\n';
+                m_pipeBroken = true;
+                return false;
+            }
+            return true;
+        }
+
+        const char* extension{ ".ppm" };
+        if (m_options.format == FrameFormat::PNG) {
+            if (!encodePNG(rgb.data(), m_width, m_height, m_options.level, encoded)) {
+                return false;
+            }
+            extension = ".png";
+        } else {
+            char header[48]{};
+            int length{ std::snprintf(header, sizeof(header), "P6\n%d %d\n255\n",
+                                      m_width, m_height) };
+            encoded.assign(header, header + length);
+            encoded.insert(encoded.end(), rgb.begin(), rgb.end());
+        }
+
+        char suffix[32]{};
+        std::snprintf(suffix, sizeof(suffix), "_%010llu",
+                      static_cast<unsigned long long>(info.step));
+        std::string path{ m_options.target + suffix + extension };
+
+        FileWriter file{};
+        if (!file.open(path, m_options.io)) { return false; }
+        bool written{ file.write(encoded.data(), encoded.size()) };
+        return file.close() && written;
+    }
+
+} // namespace GreyScott
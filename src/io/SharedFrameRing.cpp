@@ -0,0 +1,242 @@
+#include "SharedFrameRing.hpp"
+#include "AlignedAllocator.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace GreyScott {
+    namespace {
+        size_t roundUpToPage(size_t bytes) {
+            return (bytes + kPageAlignment - 1) / kPageAlignment * kPageAlignment;
+        }
+
+        size_t fieldBytes(const SharedRingHeader& header) {
+            return static_cast<size_t>(header.width) * header.height * header.channels *
+                   sizeof(float);
+        }
+
+        uint8_t* slotAt(const SharedRingHeader* header, uint32_t slot) {
+            auto* base{ reinterpret_cast<uint8_t*>(const_cast<SharedRingHeader*>(header)) };
+            return base + kPageAlignment + header->slotStride * slot;
+        }
+    } // namespace
+
+    SharedFramePublisher::~SharedFramePublisher() {
+        close();
+    }
+
+#ifdef _WIN32
+    bool SharedFramePublisher::open(const std::string&, int, int, int) {
+        std::cerr << "Shared-memory frame publishing needs POSIX shared memory\n";
+        return false;
+    }
+
+    void SharedFramePublisher::close() {}
+#else
+    bool SharedFramePublisher::open(const std::string& name, int width, int height, int slots) {
+        close();
+
+        SharedRingHeader layout{};
+        layout.width = static_cast<uint32_t>(width);
+        layout.height = static_cast<uint32_t>(height);
+        layout.slotCount = static_cast<uint32_t>(std::max(2, slots));
+        layout.slotStride = kPageAlignment + roundUpToPage(fieldBytes(layout));
+        size_t bytes{ kPageAlignment + layout.slotStride * layout.slotCount };
+
+        // A ring left behind by a crashed run would have the wrong size;
+        // readers still mapping it keep their copy
+        ::shm_unlink(name.c_str());
+        int fd{ ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600) };
+        if (fd < 0) {
+            std::cerr << "Failed to create shared memory " << name
+                      << "! Error: " << std::strerror(errno) << '\n';
+            return false;
+        }
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            std::cerr << "Failed to size shared memory " << name
+                      << "! Error: " << std::strerror(errno) << '\n';
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            return false;
+        }
+        void* map{ ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) };
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            std::cerr << "Failed to map shared memory " << name
+                      << "! Error: " << std::strerror(errno) << '\n';
+            ::shm_unlink(name.c_str());
+            return false;
+        }
+
+        m_name = name;
+        m_map = map;
+        m_mapBytes = bytes;
+        m_published = 0;
+
+        m_header = new (map) SharedRingHeader{};
+        std::memcpy(m_header->magic, SharedRingHeader::kMagic, sizeof(m_header->magic));
+        m_header->slotCount = layout.slotCount;
+        m_header->width = layout.width;
+        m_header->height = layout.height;
+        m_header->slotStride = layout.slotStride;
+        for (uint32_t slot{}; slot < layout.slotCount; ++slot) {
+            new (slotAt(m_header, slot)) SharedSlotHeader{};
+        }
+        m_header->version.store(SharedRingHeader::kVersion, std::memory_order_release);
+
+        std::cout << "Publishing frames to shared memory " << name << " ("
+                  << layout.slotCount << " slots, " << bytes / (1024 * 1024) << " MB)\n";
+        return true;
+    }
+
+    void SharedFramePublisher::close() {
+        if (!m_map) { return; }
+        ::munmap(m_map, m_mapBytes);
+        ::shm_unlink(m_name.c_str());
+        m_map = nullptr;
+        m_header = nullptr;
+    }
+#endif
+
+    void SharedFramePublisher::publish(const CheckpointInfo& info, const FillFunction& fill) {
+        if (!m_header) { return; }
+
+        uint32_t slot{ static_cast<uint32_t>(m_published % m_header->slotCount) };
+        uint8_t* base{ slotAt(m_header, slot) };
+        auto* header{ reinterpret_cast<SharedSlotHeader*>(base) };
+
+        uint64_t sequence{ header->sequence.load(std::memory_order_relaxed) };
+        header->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        fill(reinterpret_cast<float*>(base + kPageAlignment));
+        header->frame = m_published;
+        header->step = info.step;
+        header->params = info.params;
+        header->seed = info.seed;
+
+        header->sequence.store(sequence + 2, std::memory_order_release);
+        m_header->published.store(++m_published, std::memory_order_release);
+    }
+
+    SharedFrameReader::~SharedFrameReader() {
+        close();
+    }
+
+#ifdef _WIN32
+    bool SharedFrameReader::open(const std::string&) {
+        std::cerr << "Shared-memory frame rings need POSIX shared memory\n";
+        return false;
+    }
+
+    void SharedFrameReader::close() {}
+#else
+    bool SharedFrameReader::open(const std::string& name) {
+        close();
+
+        int fd{ ::shm_open(name.c_str(), O_RDONLY, 0) };
+        if (fd < 0) {
+            std::cerr << "Failed to open shared memory " << name
+                      << "! Error: " << std::strerror(errno) << '\n';
+            return false;
+        }
+        struct stat status{};
+        if (::fstat(fd, &status) != 0 ||
+            static_cast<size_t>(status.st_size) < kPageAlignment) {
+            std::cerr << "Shared memory " << name << " is not a frame ring\n";
+            ::close(fd);
+            return false;
+        }
+        size_t bytes{ static_cast<size_t>(status.st_size) };
+        void* map{ ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0) };
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            std::cerr << "Failed to map shared memory " << name
+                      << "! Error: " << std::strerror(errno) << '\n';
+            return false;
+        }
+
+        const auto* header{ static_cast<const SharedRingHeader*>(map) };
+        if (header->version.load(std::memory_order_acquire) != SharedRingHeader::kVersion ||
+            std::memcmp(header->magic, SharedRingHeader::kMagic, sizeof(header->magic)) != 0 ||
+            kPageAlignment + header->slotStride * header->slotCount > bytes) {
+            std::cerr << "Shared memory " << name
+                      << " is not a frame ring of version " << SharedRingHeader::kVersion << '\n';
+            ::munmap(map, bytes);
+            return false;
+        }
+
+        m_map = map;
+        m_mapBytes = bytes;
+        m_header = header;
+        return true;
+    }
+
+    void SharedFrameReader::close() {
+        if (!m_map) { return; }
+        ::munmap(const_cast<void*>(m_map), m_mapBytes);
+        m_map = nullptr;
+        m_header = nullptr;
+    }
+#endif
+
+    uint64_t SharedFrameReader::getPublished() const {
+        return m_header ? m_header->published.load(std::memory_order_acquire) : 0;
+    }
+
+    const SharedSlotHeader& SharedFrameReader::slotHeader(uint32_t slot) const {
+        return *reinterpret_cast<const SharedSlotHeader*>(slotAt(m_header, slot));
+    }
+
+    bool SharedFrameReader::acquire(SharedFrameView& view) const {
+        for (;;) {
+            uint64_t published{ getPublished() };
+            if (published == 0) { return false; }
+
+            uint32_t slot{ static_cast<uint32_t>((published - 1) % m_header->slotCount) };
+            const SharedSlotHeader& header{ slotHeader(slot) };
+            uint64_t sequence{ header.sequence.load(std::memory_order_acquire) };
+            if (sequence & 1) { continue; } // Being overwritten, a newer frame is coming
+
+            view.slot = slot;
+            view.sequence = sequence;
+            view.frame = header.frame;
+            view.info.width = static_cast<int>(m_header->width);
+            view.info.height = static_cast<int>(m_header->height);
+            view.info.step = header.step;
+            view.info.params = header.params;
+            view.info.seed = header.seed;
+            view.field = reinterpret_cast<const float*>(slotAt(m_header, slot) + kPageAlignment);
+            if (validate(view)) { return true; }
+        }
+    }
+
+    bool SharedFrameReader::validate(const SharedFrameView& view) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slotHeader(view.slot).sequence.load(std::memory_order_relaxed) == view.sequence;
+    }
+
+    bool SharedFrameReader::readLatest(float* field, CheckpointInfo* info) const {
+        if (!m_header) { return false; }
+        size_t bytes{ fieldBytes(*m_header) };
+
+        SharedFrameView view{};
+        do {
+            if (!acquire(view)) { return false; }
+            std::memcpy(field, view.field, bytes);
+        } while (!validate(view));
+
+        if (info) { *info = view.info; }
+        return true;
+    }
+
+} // namespace GreyScott
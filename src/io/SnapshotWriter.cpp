@@ -0,0 +1,163 @@
+#include "SnapshotWriter.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace GreyScott {
+    using Clock = std::chrono::steady_clock;
+
+    SnapshotWriter::SnapshotWriter(const SnapshotOptions& options, size_t fieldSize,
+                                   WriteFunction write) :
+        m_options{ options },
+        m_write{ std::move(write) },
+        m_free{ static_cast<size_t>(std::max(1, options.buffers)) },
+        m_ready{ static_cast<size_t>(std::max(1, options.buffers)) },
+        m_interval{ std::max<uint64_t>(1, options.interval) }
+    {
+        if (!m_write) {
+            std::string prefix{ m_options.prefix };
+            FileWriterOptions io{ m_options.io };
+            m_write = [prefix, io](const CheckpointInfo& info, const float* field) {
+                char suffix[32]{};
+                std::snprintf(suffix, sizeof(suffix), "_%010llu.ckpt",
+                              static_cast<unsigned long long>(info.step));
+                return writeCheckpoint(prefix + suffix, info, field, io);
+            };
+        }
+
+        // Every buffer is allocated and touched now, not on the first snapshot
+        m_slots.resize(static_cast<size_t>(std::max(1, options.buffers)));
+        for (uint32_t i{}; i < m_slots.size(); ++i) {
+            m_slots[i].field.assign(fieldSize, 0.0f);
+            m_free.push(i);
+        }
+
+        int threads{ std::max(1, options.threads) };
+        for (int i{}; i < threads; ++i) {
+            m_threads.emplace_back(&SnapshotWriter::writerLoop, this);
+        }
+    }
+
+    SnapshotWriter::~SnapshotWriter() {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_stopping = true;
+        }
+        m_readyWake.notify_all();
+        m_freeWake.notify_all();
+        // Writers drain the queue before they exit
+        for (auto& thread : m_threads) { thread.join(); }
+    }
+
+    bool SnapshotWriter::isDue(uint64_t previous, uint64_t step) const {
+        uint64_t interval{ getInterval() };
+        return step / interval != previous / interval;
+    }
+
+    bool SnapshotWriter::acquireSlot(uint32_t& index) {
+        if (m_free.pop(index)) { return true; }
+
+        switch (m_options.backpressure) {
+        case Backpressure::Block: {
+            std::unique_lock<std::mutex> lock{ m_mutex };
+            m_freeWake.wait(lock, [&] { return m_stopping || m_free.pop(index); });
+            return !m_stopping;
+        }
+        case Backpressure::Throttle: {
+            uint64_t interval{ getInterval() };
+            m_interval.store(interval * 2, std::memory_order_relaxed);
+            std::cerr << "Snapshot writers falling behind, interval raised to "
+                      << interval * 2 << " steps\n";
+            return false;
+        }
+        default:
+            return false;
+        }
+    }
+
+    void SnapshotWriter::releaseSlot(uint32_t index) {
+        m_slots[index].completion = nullptr;
+        m_free.push(index);
+        m_inFlight.fetch_sub(1, std::memory_order_acq_rel);
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+        }
+        m_freeWake.notify_all();
+    }
+
+    bool SnapshotWriter::capture(const CheckpointInfo& info, const FillFunction& fill) {
+        uint32_t index{};
+        if (!acquireSlot(index)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        // Writers idle again: step a throttled interval back down
+        uint64_t interval{ getInterval() };
+        if (m_options.backpressure == Backpressure::Throttle &&
+            interval > m_options.interval &&
+            m_inFlight.load(std::memory_order_acquire) == 0) {
+            m_interval.store(std::max(m_options.interval, interval / 2),
+                             std::memory_order_relaxed);
+        }
+
+        Slot& slot{ m_slots[index] };
+        slot.info = info;
+        slot.completion = fill(slot.field.data());
+
+        m_inFlight.fetch_add(1, std::memory_order_acq_rel);
+        m_ready.push(index); // Can't fail, it holds every slot
+        {
+            // Taken so a writer checking for work can't miss the notify
+            std::lock_guard<std::mutex> lock{ m_mutex };
+        }
+        m_readyWake.notify_one();
+        return true;
+    }
+
+    void SnapshotWriter::flush() {
+        std::unique_lock<std::mutex> lock{ m_mutex };
+        m_freeWake.wait(lock, [this] {
+            return m_inFlight.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+    float SnapshotWriter::getWriteMBps() const {
+        uint64_t ns{ m_writeNs.load(std::memory_order_relaxed) };
+        if (ns == 0) { return 0.0f; }
+        return m_bytesWritten.load(std::memory_order_relaxed) / 1e6f / (ns / 1e9f);
+    }
+
+    void SnapshotWriter::writerLoop() {
+        for (;;) {
+            uint32_t index{};
+            if (!m_ready.pop(index)) {
+                std::unique_lock<std::mutex> lock{ m_mutex };
+                if (m_stopping && m_ready.size() == 0) { return; }
+                m_readyWake.wait(lock, [this] { return m_stopping || m_ready.size() > 0; });
+                continue;
+            }
+
+            Slot& slot{ m_slots[index] };
+            if (slot.completion) { slot.completion(); }
+
+            auto start{ Clock::now() };
+            bool written{ m_write(slot.info, slot.field.data()) };
+            auto elapsed{ std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - start) };
+
+            if (written) {
+                m_written.fetch_add(1, std::memory_order_relaxed);
+                m_bytesWritten.fetch_add(slot.field.size() * sizeof(float),
+                                         std::memory_order_relaxed);
+                m_writeNs.fetch_add(static_cast<uint64_t>(elapsed.count()),
+                                    std::memory_order_relaxed);
+            } else {
+                m_failed.fetch_add(1, std::memory_order_relaxed);
+            }
+            releaseSlot(index);
+        }
+    }
+
+} // namespace GreyScott
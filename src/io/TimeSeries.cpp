@@ -0,0 +1,528 @@
+#include "TimeSeries.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#ifdef USE_ZLIB
+    #include <zlib.h>
+#endif
+
+namespace GreyScott {
+    namespace {
+        // Set on a tile size table entry when the tile is stored uncompressed
+        constexpr uint32_t kStoredRaw{ 1u << 31 };
+
+        struct TileRect {
+            int x0{};
+            int y0{};
+            int x1{};
+            int y1{};
+
+            size_t values() const { return static_cast<size_t>(x1 - x0) * (y1 - y0) * 2; }
+        };
+
+        TileRect tileRect(const TimeSeriesHeader& header, uint32_t tile) {
+            int size{ static_cast<int>(header.tileSize) };
+            int width{ static_cast<int>(header.width) };
+            int height{ static_cast<int>(header.height) };
+            int tilesX{ (width + size - 1) / size };
+            int x0{ static_cast<int>(tile % tilesX) * size };
+            int y0{ static_cast<int>(tile / tilesX) * size };
+            return { x0, y0, std::min(x0 + size, width), std::min(y0 + size, height) };
+        }
+
+        uint32_t tileCount(const TimeSeriesHeader& header) {
+            uint32_t tilesX{ (header.width + header.tileSize - 1) / header.tileSize };
+            uint32_t tilesY{ (header.height + header.tileSize - 1) / header.tileSize };
+            return tilesX * tilesY;
+        }
+
+        // Runs task(tile) for every tile, with workers pulling the next one
+        void forEachTile(uint32_t count, int threads,
+                         const std::function<void(uint32_t)>& task) {
+            std::atomic<uint32_t> next{};
+            auto worker{ [&] {
+                for (uint32_t tile{ next++ }; tile < count; tile = next++) { task(tile); }
+            } };
+
+            int helpers{ std::min(threads, static_cast<int>(count)) - 1 };
+            std::vector<std::thread> workers{};
+            workers.reserve(std::max(helpers, 0));
+            for (int i{}; i < helpers; ++i) { workers.emplace_back(worker); }
+            worker();
+            for (auto& thread : workers) { thread.join(); }
+        }
+
+        int resolveThreads(int threads) {
+            if (threads > 0) { return threads; }
+            return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+
+        uint32_t zigzag(int32_t value) {
+            return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+        }
+
+        int32_t unzigzag(uint32_t value) {
+            return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+        }
+
+        // Quantized values are multiples of twice the error bound; values
+        // outside the 32-bit range saturate instead of wrapping
+        uint32_t toWord(float value, float errorBound) {
+            if (errorBound > 0.0f) {
+                double scaled{ std::fmin(std::fmax(value / (2.0 * errorBound), INT32_MIN),
+                                         INT32_MAX) };
+                return static_cast<uint32_t>(static_cast<int32_t>(std::llround(scaled)));
+            }
+            uint32_t bits{};
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        float fromWord(uint32_t word, float errorBound) {
+            if (errorBound > 0.0f) {
+                return static_cast<float>(static_cast<int32_t>(word) * (2.0 * errorBound));
+            }
+            float value{};
+            std::memcpy(&value, &word, sizeof(value));
+            return value;
+        }
+
+        uint32_t residual(uint32_t word, uint32_t reference, bool quantized) {
+            return quantized ? zigzag(static_cast<int32_t>(word - reference))
+                             : word ^ reference;
+        }
+
+        uint32_t applyResidual(uint32_t residual, uint32_t reference, bool quantized) {
+            return quantized ? reference + static_cast<uint32_t>(unzigzag(residual))
+                             : residual ^ reference;
+        }
+
+        // Residuals of one tile, channel by channel, byte-shuffled into
+        // `shuffled`; `previous` is updated with this frame's words
+        void encodeTile(const float* field, uint32_t* previous, int width,
+                        const TileRect& rect, bool keyframe, float errorBound,
+                        std::vector<uint8_t>& shuffled) {
+            bool quantized{ errorBound > 0.0f };
+            size_t count{ rect.values() };
+            shuffled.resize(count * sizeof(uint32_t));
+
+            size_t i{};
+            for (int channel{}; channel < 2; ++channel) {
+                for (int y{ rect.y0 }; y < rect.y1; ++y) {
+                    uint32_t left{};
+                    for (int x{ rect.x0 }; x < rect.x1; ++x, ++i) {
+                        size_t index{ (static_cast<size_t>(y) * width + x) * 2 + channel };
+                        uint32_t word{ toWord(field[index], errorBound) };
+                        uint32_t value{ residual(word, keyframe ? left : previous[index],
+                                                 quantized) };
+                        previous[index] = word;
+                        left = word;
+
+                        for (size_t plane{}; plane < sizeof(uint32_t); ++plane) {
+                            shuffled[plane * count + i] = static_cast<uint8_t>(value >> (8 * plane));
+                        }
+                    }
+                }
+            }
+        }
+
+        // Inverse of encodeTile, leaving the frame's words in `previous`
+        void decodeTile(const uint8_t* shuffled, uint32_t* previous, int width,
+                        const TileRect& rect, bool keyframe, float errorBound) {
+            bool quantized{ errorBound > 0.0f };
+            size_t count{ rect.values() };
+
+            size_t i{};
+            for (int channel{}; channel < 2; ++channel) {
+                for (int y{ rect.y0 }; y < rect.y1; ++y) {
+                    uint32_t left{};
+                    for (int x{ rect.x0 }; x < rect.x1; ++x, ++i) {
+                        uint32_t value{};
+                        for (size_t plane{}; plane < sizeof(uint32_t); ++plane) {
+                            value |= static_cast<uint32_t>(shuffled[plane * count + i]) << (8 * plane);
+                        }
+
+                        size_t index{ (static_cast<size_t>(y) * width + x) * 2 + channel };
+                        uint32_t word{ applyResidual(value, keyframe ? left : previous[index],
+                                                     quantized) };
+                        previous[index] = word;
+                        left = word;
+                    }
+                }
+            }
+        }
+
+    } // namespace
+
+    TimeSeriesWriter::~TimeSeriesWriter() { close(); }
+
+    bool TimeSeriesWriter::open(const std::string& path, int width, int height,
+                                const TimeSeriesOptions& options) {
+        close();
+
+        if (options.errorBound > 0.0f && options.errorBound < TimeSeriesOptions::kMinErrorBound) {
+            std::cerr << "Time-series error bound " << options.errorBound
+                      << " is too small, use 0 (lossless) or at least "
+                      << TimeSeriesOptions::kMinErrorBound << '\n';
+            return false;
+        }
+
+        m_options = options;
+        m_options.tileSize = std::max(16, options.tileSize);
+        m_options.keyframeInterval = std::max(1, options.keyframeInterval);
+        m_options.threads = resolveThreads(options.threads);
+
+        m_header = TimeSeriesHeader{};
+        std::memcpy(m_header.magic, TimeSeriesHeader::kMagic, sizeof(m_header.magic));
+        m_header.width = static_cast<uint32_t>(width);
+        m_header.height = static_cast<uint32_t>(height);
+        m_header.tileSize = static_cast<uint32_t>(m_options.tileSize);
+        m_header.keyframeInterval = static_cast<uint32_t>(m_options.keyframeInterval);
+        m_header.errorBound = std::max(0.0f, options.errorBound);
+#ifdef USE_ZLIB
+        m_header.codec = TimeSeriesHeader::Codec::Zlib;
+#else
+        std::cerr << "Built without zlib, time-series frames are stored uncompressed\n";
+#endif
+
+        if (!m_file.open(path, options.io)) { return false; }
+
+        m_previous.assign(static_cast<size_t>(width) * height * 2, 0);
+        m_tiles.assign(tileCount(m_header), {});
+        m_index.clear();
+        m_frameCount = 0;
+        m_rawBytes = 0;
+        m_storedBytes = sizeof(m_header);
+        m_encodeNs = 0;
+        m_failed = false;
+        return m_file.write(&m_header, sizeof(m_header));
+    }
+
+    bool TimeSeriesWriter::append(const CheckpointInfo& info, const float* field) {
+        if (!m_file.isOpen() || m_failed) { return false; }
+        if (info.width != static_cast<int>(m_header.width) ||
+            info.height != static_cast<int>(m_header.height)) {
+            std::cerr << "Time-series frame size doesn't match the file\n";
+            return false;
+        }
+
+        auto start{ std::chrono::steady_clock::now() };
+        bool keyframe{ m_index.size() % m_header.keyframeInterval == 0 };
+
+        std::vector<uint32_t> sizes(m_tiles.size());
+        forEachTile(static_cast<uint32_t>(m_tiles.size()), m_options.threads, [&](uint32_t tile) {
+            std::vector<uint8_t>& out{ m_tiles[tile] };
+            std::vector<uint8_t> shuffled{};
+            encodeTile(field, m_previous.data(), static_cast<int>(m_header.width),
+                       tileRect(m_header, tile), keyframe, m_header.errorBound, shuffled);
+
+#ifdef USE_ZLIB
+            uLongf packed{ compressBound(static_cast<uLong>(shuffled.size())) };
+            out.resize(packed);
+            if (compress2(out.data(), &packed, shuffled.data(),
+                          static_cast<uLong>(shuffled.size()), m_options.level) == Z_OK &&
+                packed < shuffled.size()) {
+                out.resize(packed);
+                sizes[tile] = static_cast<uint32_t>(packed);
+                return;
+            }
+#endif
+            out.swap(shuffled);
+            sizes[tile] = static_cast<uint32_t>(out.size()) | kStoredRaw;
+        });
+
+        TimeSeriesFrameHeader frame{};
+        frame.flags = keyframe ? TimeSeriesFrameHeader::kKeyframe : 0;
+        frame.step = info.step;
+        frame.params = info.params;
+        frame.seed = info.seed;
+        frame.tileCount = static_cast<uint32_t>(m_tiles.size());
+        frame.payloadBytes = sizes.size() * sizeof(uint32_t);
+        for (const auto& tile : m_tiles) { frame.payloadBytes += tile.size(); }
+
+        uint64_t offset{ m_file.getSize() };
+        bool written{ m_file.write(&frame, sizeof(frame)) &&
+                      m_file.write(sizes.data(), sizes.size() * sizeof(uint32_t)) };
+        for (const auto& tile : m_tiles) {
+            written = written && m_file.write(tile.data(), tile.size());
+        }
+        // The buffers are reused by the next frame (and `sizes` goes away)
+        if (!written || !m_file.wait()) {
+            // m_previous already holds this frame, so later deltas would
+            // decode against the wrong reference; the index keeps the
+            // frames written so far
+            m_failed = true;
+            std::cerr << "Failed to write time-series frame at step " << info.step
+                      << ", no further frames are appended\n";
+            return false;
+        }
+
+        m_index.push_back({ info.step, offset, frame.flags, 0 });
+        uint64_t frameBytes{ sizeof(frame) + frame.payloadBytes };
+        m_storedBytes.fetch_add(frameBytes, std::memory_order_relaxed);
+        m_rawBytes.fetch_add(m_previous.size() * sizeof(float), std::memory_order_relaxed);
+        m_encodeNs.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count()), std::memory_order_relaxed);
+        m_frameCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool TimeSeriesWriter::close() {
+        if (!m_file.isOpen()) { return true; }
+
+        TimeSeriesTrailer trailer{};
+        std::memcpy(trailer.magic, TimeSeriesTrailer::kMagic, sizeof(trailer.magic));
+        trailer.indexOffset = m_file.getSize();
+        trailer.frameCount = m_index.size();
+        bool good{ m_file.write(m_index.data(), m_index.size() * sizeof(TimeSeriesIndexEntry)) &&
+                   m_file.write(&trailer, sizeof(trailer)) };
+        good = m_file.close() && good;
+
+        if (!good) {
+            std::cerr << "Failed to write time-series index\n";
+            return false;
+        }
+        if (!m_index.empty()) {
+            std::cout << "Time series: " << m_index.size() << " frames, ratio " << getRatio()
+                      << ":1, " << getMBps() << " MB/s\n";
+        }
+        return true;
+    }
+
+    float TimeSeriesWriter::getRatio() const {
+        uint64_t stored{ getStoredBytes() };
+        return stored > 0 ? static_cast<float>(getRawBytes()) / stored : 0.0f;
+    }
+
+    // Raw field bytes encoded and written per second of append()
+    float TimeSeriesWriter::getMBps() const {
+        uint64_t ns{ m_encodeNs.load(std::memory_order_relaxed) };
+        return ns > 0 ? getRawBytes() / 1e6f / (ns / 1e9f) : 0.0f;
+    }
+
+    bool TimeSeriesReader::open(const std::string& path) {
+        m_file.close();
+        m_file.clear();
+        m_index.clear();
+        m_decoded = SIZE_MAX;
+
+        m_file.open(path, std::ios::binary | std::ios::ate);
+        if (!m_file.is_open()) {
+            std::cerr << "Failed to open time-series file: " << path << '\n';
+            return false;
+        }
+        uint64_t fileSize{ static_cast<uint64_t>(m_file.tellg()) };
+        m_file.seekg(0);
+        m_file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header));
+
+        if (!m_file.good() ||
+            std::memcmp(m_header.magic, TimeSeriesHeader::kMagic, sizeof(m_header.magic)) != 0) {
+            std::cerr << "Not a time-series file: " << path << '\n';
+            return false;
+        }
+        if (m_header.version != TimeSeriesHeader::kVersion || m_header.channels != 2 ||
+            m_header.width == 0 || m_header.height == 0 || m_header.tileSize == 0 ||
+            m_header.keyframeInterval == 0) {
+            std::cerr << "Unsupported time-series version or layout\n";
+            return false;
+        }
+#ifndef USE_ZLIB
+        if (m_header.codec == TimeSeriesHeader::Codec::Zlib) {
+            std::cerr << "Time series is zlib-compressed, but built without zlib\n";
+            return false;
+        }
+#endif
+
+        m_previous.assign(static_cast<size_t>(m_header.width) * m_header.height * 2, 0);
+        return buildIndex(fileSize);
+    }
+
+    bool TimeSeriesReader::buildIndex(uint64_t fileSize) {
+        TimeSeriesTrailer trailer{};
+        if (fileSize >= sizeof(m_header) + sizeof(trailer)) {
+            m_file.seekg(static_cast<std::streamoff>(fileSize - sizeof(trailer)));
+            m_file.read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+        }
+
+        bool indexed{ m_file.good() &&
+                      std::memcmp(trailer.magic, TimeSeriesTrailer::kMagic,
+                                  sizeof(trailer.magic)) == 0 &&
+                      trailer.indexOffset + trailer.frameCount * sizeof(TimeSeriesIndexEntry) +
+                              sizeof(trailer) == fileSize };
+        if (indexed) {
+            m_index.resize(trailer.frameCount);
+            m_file.seekg(static_cast<std::streamoff>(trailer.indexOffset));
+            m_file.read(reinterpret_cast<char*>(m_index.data()),
+                        static_cast<std::streamsize>(m_index.size() * sizeof(TimeSeriesIndexEntry)));
+            m_framesEnd = trailer.indexOffset;
+            return m_file.good();
+        }
+
+        // Not closed cleanly: walk the frames, dropping a truncated last one
+        m_file.clear();
+        uint64_t offset{ sizeof(m_header) };
+        TimeSeriesFrameHeader frame{};
+        while (offset + sizeof(frame) <= fileSize) {
+            m_file.seekg(static_cast<std::streamoff>(offset));
+            m_file.read(reinterpret_cast<char*>(&frame), sizeof(frame));
+            if (!m_file.good() || frame.magic != TimeSeriesFrameHeader::kMagic ||
+                offset + sizeof(frame) + frame.payloadBytes > fileSize) {
+                break;
+            }
+            m_index.push_back({ frame.step, offset, frame.flags, 0 });
+            offset += sizeof(frame) + frame.payloadBytes;
+        }
+        m_file.clear();
+        m_framesEnd = offset;
+        std::cerr << "Time series has no index, recovered " << m_index.size() << " frames\n";
+        return true;
+    }
+
+    uint64_t TimeSeriesReader::getFrameBytes(size_t frame) const {
+        uint64_t end{ frame + 1 < m_index.size() ? m_index[frame + 1].offset : m_framesEnd };
+        // A corrupt index may not be in file order
+        return end > m_index[frame].offset ? end - m_index[frame].offset : 0;
+    }
+
+    bool TimeSeriesReader::readFrame(size_t frame, float* field, CheckpointInfo* info) {
+        if (frame >= m_index.size()) { return false; }
+
+        size_t keyframe{ frame };
+        while (keyframe > 0 && !(m_index[keyframe].flags & TimeSeriesFrameHeader::kKeyframe)) {
+            --keyframe;
+        }
+
+        if (m_decoded != frame) {
+            // Continue from the last decoded frame if no keyframe lies between
+            size_t first{ m_decoded != SIZE_MAX && m_decoded >= keyframe && m_decoded < frame
+                              ? m_decoded + 1
+                              : keyframe };
+
+            for (size_t current{ first }; current <= frame; ++current) {
+                if (!decodeNext(current, info)) {
+                    m_decoded = SIZE_MAX;
+                    return false;
+                }
+            }
+        } else if (info) {
+            // Already decoded; applying its residuals again would corrupt it
+            TimeSeriesFrameHeader header{};
+            if (!readFrameHeader(frame, header)) { return false; }
+            fillInfo(header, info);
+        }
+
+        // Only the last frame is needed as floats
+        for (size_t i{}; i < m_previous.size(); ++i) {
+            field[i] = fromWord(m_previous[i], m_header.errorBound);
+        }
+        return true;
+    }
+
+    bool TimeSeriesReader::readFrameHeader(size_t frame, TimeSeriesFrameHeader& header) {
+        m_file.seekg(static_cast<std::streamoff>(m_index[frame].offset));
+        m_file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!m_file.good() || header.magic != TimeSeriesFrameHeader::kMagic ||
+            header.tileCount != tileCount(m_header)) {
+            std::cerr << "Time-series frame " << frame << " is corrupt\n";
+            return false;
+        }
+        return true;
+    }
+
+    void TimeSeriesReader::fillInfo(const TimeSeriesFrameHeader& header,
+                                    CheckpointInfo* info) const {
+        if (!info) { return; }
+        info->width = static_cast<int>(m_header.width);
+        info->height = static_cast<int>(m_header.height);
+        info->params = header.params;
+        info->seed = header.seed;
+        info->step = header.step;
+    }
+
+    bool TimeSeriesReader::decodeNext(size_t frame, CheckpointInfo* info) {
+        TimeSeriesFrameHeader header{};
+        if (!readFrameHeader(frame, header)) { return false; }
+
+        // The size table must fit in the payload, and the payload in the
+        // bytes the frame spans in the file
+        uint64_t tableBytes{ static_cast<uint64_t>(header.tileCount) * sizeof(uint32_t) };
+        uint64_t frameBytes{ getFrameBytes(frame) };
+        if (header.payloadBytes < tableBytes || frameBytes < sizeof(header) ||
+            header.payloadBytes > frameBytes - sizeof(header)) {
+            std::cerr << "Time-series frame " << frame << " is corrupt\n";
+            return false;
+        }
+
+        m_payload.resize(header.payloadBytes);
+        m_file.read(reinterpret_cast<char*>(m_payload.data()),
+                    static_cast<std::streamsize>(m_payload.size()));
+        if (!m_file.good()) {
+            std::cerr << "Failed to read time-series frame " << frame << '\n';
+            return false;
+        }
+
+        // Tile offsets from the size table
+        std::vector<uint32_t> sizes(header.tileCount);
+        std::memcpy(sizes.data(), m_payload.data(), tableBytes);
+        std::vector<uint64_t> offsets(header.tileCount);
+        uint64_t offset{ tableBytes };
+        for (size_t tile{}; tile < sizes.size(); ++tile) {
+            offsets[tile] = offset;
+            offset += sizes[tile] & ~kStoredRaw;
+        }
+        // Sums of 32-bit sizes can't wrap, so this also keeps every tile
+        // inside the payload
+        if (offset != header.payloadBytes) {
+            std::cerr << "Time-series frame " << frame << " is corrupt\n";
+            return false;
+        }
+
+        bool keyframe{ (header.flags & TimeSeriesFrameHeader::kKeyframe) != 0 };
+        std::atomic<bool> failed{};
+        forEachTile(header.tileCount, resolveThreads(0), [&](uint32_t tile) {
+            TileRect rect{ tileRect(m_header, tile) };
+            const uint8_t* data{ m_payload.data() + offsets[tile] };
+            uint32_t bytes{ sizes[tile] & ~kStoredRaw };
+            size_t expected{ rect.values() * sizeof(uint32_t) };
+
+            std::vector<uint8_t> shuffled{};
+            if (!(sizes[tile] & kStoredRaw)) {
+#ifdef USE_ZLIB
+                shuffled.resize(expected);
+                uLongf unpacked{ static_cast<uLongf>(expected) };
+                if (uncompress(shuffled.data(), &unpacked, data, bytes) != Z_OK ||
+                    unpacked != expected) {
+                    failed = true;
+                    return;
+                }
+                data = shuffled.data();
+#else
+                failed = true;
+                return;
+#endif
+            } else if (bytes != expected) {
+                failed = true;
+                return;
+            }
+
+            decodeTile(data, m_previous.data(), static_cast<int>(m_header.width),
+                       rect, keyframe, m_header.errorBound);
+        });
+        if (failed) {
+            std::cerr << "Time-series frame " << frame << " is corrupt\n";
+            return false;
+        }
+
+        fillInfo(header, info);
+        m_decoded = frame;
+        return true;
+    }
+
+} // namespace GreyScott
@@ -1,15 +1,251 @@
 #include "Application.hpp"
+#include "TimeSeries.hpp"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <string>
 
-int main(int argc, char* argv[]) {
-    (void)argc;
-    (void)argv;
+namespace {
+    bool parseArguments(int argc, char* argv[], GreyScott::Application::Config& config) {
+        for (int i{ 1 }; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--no-sim-thread") == 0) {
+                config.simulationThread = false;
+            } else if (std::strcmp(argv[i], "--step-rate") == 0 && i + 1 < argc) {
+                try {
+                    config.targetStepRate = std::stof(argv[++i]);
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid step rate: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--steps-per-frame") == 0 && i + 1 < argc) {
+                if (std::strcmp(argv[++i], "auto") == 0) {
+                    config.stepsPerFrame = 0;
+                    continue;
+                }
+                try {
+                    config.stepsPerFrame = std::max(1, std::stoi(argv[i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid steps per frame: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--display-format") == 0 && i + 1 < argc) {
+                std::string format{ argv[++i] };
+                if (format == "rg32f") { config.displayFormat = GreyScott::DisplayFormat::RG32F; }
+                else if (format == "r16f") { config.displayFormat = GreyScott::DisplayFormat::R16F; }
+                else if (format == "r8") { config.displayFormat = GreyScott::DisplayFormat::R8; }
+                else if (format == "rgba8") { config.displayFormat = GreyScott::DisplayFormat::RGBA8; }
+                else {
+                    std::cerr << "Unknown display format: " << format << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--grid") == 0 && i + 1 < argc) {
+                std::string size{ argv[++i] };
+                size_t separator{ size.find('x') };
+                try {
+                    config.gridWidth = std::stoi(size.substr(0, separator));
+                    config.gridHeight = separator == std::string::npos
+                                            ? config.gridWidth
+                                            : std::stoi(size.substr(separator + 1));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid grid size: " << size << '\n';
+                    return false;
+                }
+                if (config.gridWidth < 1 || config.gridHeight < 1) {
+                    std::cerr << "Invalid grid size: " << size << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+                config.checkpointPath = argv[++i];
+            } else if (std::strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc) {
+                try {
+                    config.checkpointInterval = std::stoull(argv[++i]);
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid checkpoint interval: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--restore") == 0 && i + 1 < argc) {
+                config.restorePath = argv[++i];
+            } else if (std::strcmp(argv[i], "--snapshot-every") == 0 && i + 1 < argc) {
+                try {
+                    config.snapshotInterval = std::stoull(argv[++i]);
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid snapshot interval: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--snapshot-prefix") == 0 && i + 1 < argc) {
+                config.snapshotPrefix = argv[++i];
+            } else if (std::strcmp(argv[i], "--snapshot-buffers") == 0 && i + 1 < argc) {
+                try {
+                    config.snapshotBuffers = std::max(1, std::stoi(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid snapshot buffer count: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--snapshot-threads") == 0 && i + 1 < argc) {
+                try {
+                    config.snapshotThreads = std::max(1, std::stoi(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid snapshot thread count: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--snapshot-series") == 0 && i + 1 < argc) {
+                config.snapshotSeries = argv[++i];
+            } else if (std::strcmp(argv[i], "--snapshot-error") == 0 && i + 1 < argc) {
+                try {
+                    config.snapshotErrorBound = std::max(0.0f, std::stof(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid snapshot error bound: " << argv[i] << '\n';
+                    return false;
+                }
+                if (config.snapshotErrorBound > 0.0f &&
+                    config.snapshotErrorBound < GreyScott::TimeSeriesOptions::kMinErrorBound) {
+                    std::cerr << "Snapshot error bound must be 0 (lossless) or at least "
+                              << GreyScott::TimeSeriesOptions::kMinErrorBound << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--snapshot-keyframes") == 0 && i + 1 < argc) {
+                try {
+                    config.snapshotKeyframeInterval = std::max(1, std::stoi(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid keyframe interval: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--snapshot-backpressure") == 0 && i + 1 < argc) {
+                std::string policy{ argv[++i] };
+                if (policy == "block") { config.snapshotBackpressure = GreyScott::Backpressure::Block; }
+                else if (policy == "drop") { config.snapshotBackpressure = GreyScott::Backpressure::Drop; }
+                else if (policy == "throttle") { config.snapshotBackpressure = GreyScott::Backpressure::Throttle; }
+                else {
+                    std::cerr << "Unknown backpressure policy: " << policy << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--io") == 0 && i + 1 < argc) {
+                std::string mode{ argv[++i] };
+                if (mode == "buffered") { config.ioMode = GreyScott::IOMode::Buffered; }
+                else if (mode == "direct") { config.ioMode = GreyScott::IOMode::Direct; }
+                else {
+                    std::cerr << "Unknown I/O mode: " << mode << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--io-depth") == 0 && i + 1 < argc) {
+                try {
+                    config.ioQueueDepth = std::max(1, std::stoi(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid I/O queue depth: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+                config.recordTarget = argv[++i];
+            } else if (std::strcmp(argv[i], "--record-format") == 0 && i + 1 < argc) {
+                std::string format{ argv[++i] };
+                if (format == "png") { config.recordFormat = GreyScott::FrameFormat::PNG; }
+                else if (format == "ppm") { config.recordFormat = GreyScott::FrameFormat::PPM; }
+                else if (format == "pipe") { config.recordFormat = GreyScott::FrameFormat::Pipe; }
+                else {
+                    std::cerr << "Unknown record format: " << format << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--record-every") == 0 && i + 1 < argc) {
+                try {
+                    config.recordInterval = std::max<uint64_t>(1, std::stoull(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid record interval: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--record-buffers") == 0 && i + 1 < argc) {
+                try {
+                    config.recordBuffers = std::max(1, std::stoi(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid record buffer count: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--record-threads") == 0 && i + 1 < argc) {
+                try {
+                    config.recordThreads = std::max(1, std::stoi(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid record thread count: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--record-backpressure") == 0 && i + 1 < argc) {
+                std::string policy{ argv[++i] };
+                if (policy == "block") { config.recordBackpressure = GreyScott::Backpressure::Block; }
+                else if (policy == "drop") { config.recordBackpressure = GreyScott::Backpressure::Drop; }
+                else if (policy == "throttle") { config.recordBackpressure = GreyScott::Backpressure::Throttle; }
+                else {
+                    std::cerr << "Unknown backpressure policy: " << policy << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+                config.shmName = argv[++i];
+                if (!config.shmName.empty() && config.shmName.front() != '/') {
+                    config.shmName.insert(0, "/");
+                }
+            } else if (std::strcmp(argv[i], "--shm-every") == 0 && i + 1 < argc) {
+                try {
+                    config.shmInterval = std::max<uint64_t>(1, std::stoull(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid shared-memory interval: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--shm-slots") == 0 && i + 1 < argc) {
+                try {
+                    config.shmSlots = std::max(2, std::stoi(argv[++i]));
+                } catch (const std::exception&) {
+                    std::cerr << "Invalid shared-memory slot count: " << argv[i] << '\n';
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--control") == 0 && i + 1 < argc) {
+                config.controlSocket = argv[++i];
+            } else if (std::strcmp(argv[i], "--tiled-view") == 0) {
+                config.tiledView = true;
+            } else if (std::strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+                std::string backend{ argv[++i] };
+                if (backend == "cpu") { config.backend = GreyScott::Backend::CPU; }
+                else if (backend == "opencl") { config.backend = GreyScott::Backend::OpenCL; }
+                else if (backend == "gl") {
+                    // Compute shaders need the GL context, which lives on the main thread
+                    config.backend = GreyScott::Backend::GLCompute;
+                    config.simulationThread = false;
+                } else {
+                    std::cerr << "Unknown backend: " << backend << '\n';
+                    return false;
+                }
+            } else {
+                std::cout << "Usage: " << argv[0]
+                          << " [--no-sim-thread] [--step-rate STEPS_PER_SECOND]"
+                             " [--steps-per-frame N|auto]"
+                             " [--display-format rg32f|r16f|r8|rgba8]"
+                             " [--backend cpu|opencl|gl]"
+                             " [--grid WIDTHxHEIGHT] [--tiled-view]"
+                             " [--checkpoint FILE] [--checkpoint-every STEPS]"
+                             " [--restore FILE] [--snapshot-every STEPS]"
+                             " [--snapshot-prefix PREFIX] [--snapshot-buffers N]"
+                             " [--snapshot-threads N]"
+                             " [--snapshot-backpressure block|drop|throttle]"
+                             " [--snapshot-series FILE] [--snapshot-error ABS]"
+                             " [--snapshot-keyframes N]"
+                             " [--io buffered|direct] [--io-depth N]"
+                             " [--record PREFIX|COMMAND] [--record-format png|ppm|pipe]"
+                             " [--record-every STEPS] [--record-buffers N]"
+                             " [--record-threads N]"
+                             " [--record-backpressure block|drop|throttle]"
+                             " [--shm NAME] [--shm-every STEPS] [--shm-slots N]"
+                             " [--control SOCKET]\n";
+                return false;
+            }
+        }
+        return true;
+    }
 
+} // namespace
+
+int main(int argc, char* argv[]) {
     std::cout << "==================================\n";
     std::cout << "Grey-Scott Simulation\n";
     std::cout << "==================================\n\n";
 
     GreyScott::Application::Config config{};
+    if (!parseArguments(argc, argv, config)) { return 1; }
 
     GreyScott::Application app(config);
     if (!app.initialize()) {
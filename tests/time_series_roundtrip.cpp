@@ -0,0 +1,166 @@
+// Round trip of TimeSeriesWriter/TimeSeriesReader, lossless and quantized.
+//
+// Writes 10 frames of an evolving field with a keyframe every 4, then reads
+// them back in order, backwards, and the same delta frame several times in a
+// row, checking each against what was written (bit-exact, or within the
+// error bound). Frames whose payload size was tampered with must then be
+// rejected, as must error bounds too small to quantize to 32 bits. Exits
+// non-zero on the first mismatch.
+//
+// Usage: greyscott_test_time_series [DIRECTORY]
+#include "SimulationCPU.hpp"
+#include "TimeSeries.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr int kSize{ 96 };
+    constexpr int kFrames{ 10 };
+    constexpr int kStepsPerFrame{ 25 };
+
+    using Field = std::vector<float>;
+
+    double maxError(const Field& expected, const Field& actual) {
+        double error{};
+        for (size_t i{}; i < expected.size(); ++i) {
+            error = std::fmax(error, std::fabs(static_cast<double>(expected[i]) - actual[i]));
+        }
+        return error;
+    }
+
+    bool checkFrame(GreyScott::TimeSeriesReader& reader, const std::vector<Field>& frames,
+                    size_t frame, float errorBound, const char* pass) {
+        Field field(frames[frame].size());
+        GreyScott::CheckpointInfo info{};
+        if (!reader.readFrame(frame, field.data(), &info)) {
+            std::cout << "FAILED: " << pass << " read of frame " << frame << '\n';
+            return false;
+        }
+
+        // Quantized values may be off by the bound plus float rounding
+        bool matches{ errorBound > 0.0f
+                          ? maxError(frames[frame], field) <= errorBound * 1.001
+                          : std::memcmp(frames[frame].data(), field.data(),
+                                        field.size() * sizeof(float)) == 0 };
+        if (!matches || info.step != (frame + 1) * kStepsPerFrame || info.width != kSize) {
+            std::cout << "FAILED: " << pass << " read of frame " << frame << " is off by "
+                      << maxError(frames[frame], field) << " (step " << info.step << ")\n";
+            return false;
+        }
+        return true;
+    }
+
+    bool roundTrip(const std::string& path, float errorBound) {
+        using namespace GreyScott;
+
+        SimulationCPU simulation{ kSize, kSize };
+        simulation.setSeed(42);
+        simulation.initialize();
+
+        TimeSeriesOptions options{};
+        options.tileSize = 32;
+        options.keyframeInterval = 4;
+        options.errorBound = errorBound;
+        options.threads = 2;
+
+        std::vector<Field> frames{};
+        TimeSeriesWriter writer{};
+        if (!writer.open(path, kSize, kSize, options)) { return false; }
+        for (int frame{}; frame < kFrames; ++frame) {
+            simulation.step(kStepsPerFrame);
+            CheckpointInfo info{ kSize, kSize, simulation.getParams(),
+                                 static_cast<uint64_t>(frame + 1) * kStepsPerFrame,
+                                 simulation.getSeed() };
+            if (!writer.append(info, simulation.getData())) { return false; }
+            frames.emplace_back(simulation.getData(),
+                                simulation.getData() + static_cast<size_t>(kSize) * kSize * 2);
+        }
+        if (!writer.close()) { return false; }
+
+        TimeSeriesReader reader{};
+        if (!reader.open(path) || reader.getFrameCount() != kFrames) {
+            std::cout << "FAILED: could not reopen " << path << '\n';
+            return false;
+        }
+
+        for (size_t frame{}; frame < kFrames; ++frame) {
+            if (!checkFrame(reader, frames, frame, errorBound, "forward")) { return false; }
+        }
+        for (size_t frame{ kFrames }; frame-- > 0;) {
+            if (!checkFrame(reader, frames, frame, errorBound, "backward")) { return false; }
+        }
+        // Frame 6 is a delta frame (keyframes are 0, 4 and 8)
+        for (int repeat{}; repeat < 3; ++repeat) {
+            if (!checkFrame(reader, frames, 6, errorBound, "repeated")) { return false; }
+        }
+        if (!checkFrame(reader, frames, 7, errorBound, "following")) { return false; }
+
+        std::cout << (errorBound > 0.0f ? "quantized" : "lossless") << ": " << kFrames
+                  << " frames, ratio " << writer.getRatio() << ", passed\n";
+        return true;
+    }
+
+    // Overwrites the payload size in a frame header, as a damaged file might
+    bool setPayloadBytes(const std::string& path, uint64_t offset, uint64_t payloadBytes) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(
+            offset + offsetof(GreyScott::TimeSeriesFrameHeader, payloadBytes)));
+        file.write(reinterpret_cast<const char*>(&payloadBytes), sizeof(payloadBytes));
+        return file.good();
+    }
+
+    bool rejectsCorruptFrames(const std::string& path) {
+        using namespace GreyScott;
+
+        TimeSeriesReader reader{};
+        if (!reader.open(path)) { return false; }
+        uint64_t offset{ reader.getEntry(1).offset };
+        uint64_t tileTable{ 9 * sizeof(uint32_t) }; // 96 / 32 = 3x3 tiles
+
+        Field field(static_cast<size_t>(kSize) * kSize * 2);
+        // Shorter than the size table, then longer than the file
+        for (uint64_t payloadBytes : { tileTable - 4, uint64_t{ 1 } << 40 }) {
+            if (!setPayloadBytes(path, offset, payloadBytes) || !reader.open(path)) {
+                return false;
+            }
+            if (!reader.readFrame(0, field.data()) || reader.readFrame(1, field.data())) {
+                std::cout << "FAILED: frame with " << payloadBytes
+                          << " payload bytes was not rejected\n";
+                return false;
+            }
+        }
+        std::cout << "corrupt frames: rejected, passed\n";
+        return true;
+    }
+
+    bool rejectsTinyErrorBound(const std::string& path) {
+        GreyScott::TimeSeriesOptions options{};
+        options.errorBound = 1e-12f;
+        GreyScott::TimeSeriesWriter writer{};
+        if (writer.open(path, kSize, kSize, options)) {
+            std::cout << "FAILED: error bound " << options.errorBound << " was accepted\n";
+            return false;
+        }
+        std::cout << "tiny error bound: rejected, passed\n";
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string directory{ argc > 1 ? argv[1] : "." };
+    std::string lossless{ directory + "/test_lossless.gsts" };
+    std::string quantized{ directory + "/test_quantized.gsts" };
+
+    bool passed{ roundTrip(lossless, 0.0f) && roundTrip(quantized, 1e-3f) &&
+                 rejectsCorruptFrames(lossless) && rejectsTinyErrorBound(quantized) };
+    std::remove(lossless.c_str());
+    std::remove(quantized.c_str());
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+// Minimal consumer of the shared-memory frame ring that GreyScottSim
+// --shm NAME publishes into.
+//
+// Polls for new frames and reduces each one in place (no copy): prints the
+// step, F/k and the mean and range of U, and counts the frames that were
+// overwritten while being read. Exits after FRAMES frames (default: run
+// until interrupted).
+//
+// Usage: greyscott_shm_reader NAME [FRAMES]
+#include "SharedFrameRing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char* argv[]) {
+    using namespace GreyScott;
+
+    if (argc != 2 && argc != 3) {
+        std::cout << "Usage: greyscott_shm_reader NAME [FRAMES]\n";
+        return 2;
+    }
+    uint64_t limit{ UINT64_MAX };
+    if (argc == 3) {
+        try {
+            limit = std::stoull(argv[2]);
+        } catch (const std::exception&) {
+            std::cerr << "Invalid frame count: " << argv[2] << '\n';
+            return 2;
+        }
+    }
+
+    SharedFrameReader reader{};
+    if (!reader.open(argv[1])) { return 1; }
+    const SharedRingHeader& header{ reader.getHeader() };
+    size_t cells{ static_cast<size_t>(header.width) * header.height };
+    std::cout << header.width << "x" << header.height << ", " << header.slotCount
+              << " slots\n";
+
+    uint64_t read{};
+    uint64_t torn{};
+    uint64_t lastFrame{ UINT64_MAX };
+    auto start{ std::chrono::steady_clock::now() };
+    while (read < limit) {
+        SharedFrameView view{};
+        if (!reader.acquire(view) || view.frame == lastFrame) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        double sum{};
+        float low{ view.field[0] };
+        float high{ view.field[0] };
+        for (size_t i{}; i < cells; ++i) {
+            float u{ view.field[i * 2] };
+            sum += u;
+            low = std::min(low, u);
+            high = std::max(high, u);
+        }
+        if (!reader.validate(view)) {
+            ++torn; // The publisher lapped us; the next acquire gets a newer frame
+            continue;
+        }
+
+        lastFrame = view.frame;
+        ++read;
+        std::cout << "frame " << view.frame << "  step " << view.info.step << "  F "
+                  << view.info.params.F << "  k " << view.info.params.k << "  U mean "
+                  << sum / cells << " [" << low << ", " << high << "]\n";
+    }
+
+    double seconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                        .count() };
+    std::cout << read << " frames in " << seconds << " s, " << torn
+              << " overwritten while reading\n";
+    return 0;
+}
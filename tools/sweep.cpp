@@ -0,0 +1,129 @@
+// Maps the pattern classes of the Grey-Scott model over a grid of (F, k)
+// values.
+//
+// Runs one small simulation per (F, k) pair on every core (and any OpenCL
+// devices given), each to the step budget or until U stops changing, then
+// writes OUT.png, an atlas of the final fields (k left to right, F bottom to
+// top), and OUT.csv with summary statistics per pair.
+//
+// Usage: greyscott_sweep [--F MIN:MAX:COUNT] [--k MIN:MAX:COUNT] [--size N]
+//                        [--steps N] [--check N] [--tolerance X] [--seed N]
+//                        [--threads N] [--lanes 8|16] [--devices 0,1,...]
+//                        [--device-batch N] [--out PREFIX]
+#include "ParameterSweep.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::vector<std::string> splitList(const std::string& text, char delimiter) {
+        std::vector<std::string> items{};
+        std::stringstream stream{ text };
+        std::string item{};
+        while (std::getline(stream, item, delimiter)) {
+            if (!item.empty()) { items.push_back(item); }
+        }
+        return items;
+    }
+
+    bool parseRange(const std::string& text, float& low, float& high, int& count) {
+        std::vector<std::string> parts{ splitList(text, ':') };
+        if (parts.size() != 3) { return false; }
+        low = std::stof(parts[0]);
+        high = std::stof(parts[1]);
+        count = std::stoi(parts[2]);
+        return count >= 1 && high >= low;
+    }
+
+    void printUsage() {
+        GreyScott::SweepOptions defaults{};
+        std::cout << "Usage: greyscott_sweep [options]\n"
+                  << "  --F MIN:MAX:COUNT  Feed rates (default " << defaults.fMin << ":"
+                  << defaults.fMax << ":" << defaults.fCount << ")\n"
+                  << "  --k MIN:MAX:COUNT  Kill rates (default " << defaults.kMin << ":"
+                  << defaults.kMax << ":" << defaults.kCount << ")\n"
+                  << "  --size N           Grid side per pair (default " << defaults.size << ")\n"
+                  << "  --steps N          Step budget per pair (default " << defaults.maxSteps
+                  << ")\n"
+                  << "  --check N          Steps between steady-state checks (default "
+                  << defaults.checkInterval << ")\n"
+                  << "  --tolerance X      RMS change of U per step counted as steady, 0 = off\n"
+                  << "                     (default " << defaults.tolerance << ")\n"
+                  << "  --seed N           Seed of the shared initial pattern (default "
+                  << defaults.seed << ")\n"
+                  << "  --threads N        CPU workers (default: hardware threads)\n"
+                  << "  --lanes 8|16       Pairs per CPU worker, stepped in SIMD lanes\n"
+                  << "                     (default 16 with AVX-512, else 8)\n"
+                  << "  --devices LIST     OpenCL device indices to use as well\n"
+                  << "  --device-batch N   Pairs per launch on each device (default "
+                  << defaults.deviceBatch << ")\n"
+                  << "  --out PREFIX       Writes PREFIX.png and PREFIX.csv (default sweep)\n";
+    }
+
+    bool parseOptions(int argc, char* argv[], GreyScott::SweepOptions& options,
+                      std::string& output) {
+        for (int i{ 1 }; i < argc; ++i) {
+            std::string arg{ argv[i] };
+            if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return false;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for " << arg << '\n';
+                return false;
+            }
+
+            std::string value{ argv[++i] };
+            bool valid{ true };
+            if (arg == "--F") { valid = parseRange(value, options.fMin, options.fMax, options.fCount); }
+            else if (arg == "--k") { valid = parseRange(value, options.kMin, options.kMax, options.kCount); }
+            else if (arg == "--size") { options.size = std::stoi(value); }
+            else if (arg == "--steps") { options.maxSteps = std::stoull(value); }
+            else if (arg == "--check") { options.checkInterval = std::stoull(value); }
+            else if (arg == "--tolerance") { options.tolerance = std::stof(value); }
+            else if (arg == "--seed") { options.seed = static_cast<uint32_t>(std::stoul(value)); }
+            else if (arg == "--threads") { options.threads = std::stoi(value); }
+            else if (arg == "--lanes") { options.lanes = std::stoi(value); }
+            else if (arg == "--devices") {
+                options.devices.clear();
+                for (const auto& item : splitList(value, ',')) {
+                    options.devices.push_back(std::stoi(item));
+                }
+            }
+            else if (arg == "--device-batch") { options.deviceBatch = std::stoi(value); }
+            else if (arg == "--out") { output = value; }
+            else {
+                std::cerr << "Unknown option: " << arg << '\n';
+                printUsage();
+                return false;
+            }
+            if (!valid) {
+                std::cerr << "Invalid range for " << arg << ": " << value << '\n';
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace GreyScott;
+
+    SweepOptions options{};
+    std::string output{ "sweep" };
+    try {
+        if (!parseOptions(argc, argv, options, output)) { return 2; }
+    } catch (const std::exception&) {
+        std::cerr << "Invalid number in the options\n";
+        return 2;
+    }
+
+    ParameterSweep sweep{};
+    if (!sweep.run(options)) { return 1; }
+    if (!sweep.writeAtlas(output + ".png") || !sweep.writeCSV(output + ".csv")) { return 1; }
+
+    std::cout << "Wrote " << output << ".png (" << sweep.getAtlasWidth() << "x"
+              << sweep.getAtlasHeight() << ") and " << output << ".csv\n";
+    return 0;
+}
@@ -0,0 +1,182 @@
+// Numerical cross-validation of the OpenCL engine against SimulationCPU.
+//
+// Both engines start from the same seeded state and are stepped in lockstep;
+// every --check-every steps the fields are compared (max/mean absolute
+// error, max ULP distance, RMS divergence). The process exits non-zero when
+// the error exceeds the configured tolerances, so it can gate CI runs; a
+// CPU OpenCL device such as POCL is sufficient. Without any OpenCL platform
+// it exits with 77, which CTest reports as skipped.
+//
+// Usage: greyscott_validate [--size N] [--steps N] [--check-every N]
+//                           [--seed S] [--kernel file:name]
+//                           [--tolerance ABS] [--ulp-tolerance ULPS]
+#include "SimulationCPU.hpp"
+#ifdef USE_OPENCL
+#include "ComputeManager.hpp"
+#include "Simulation.hpp"
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+    // No OpenCL platform to validate on; registered as the test's skip code
+    constexpr int kExitSkipped{ 77 };
+
+    struct ValidateOptions {
+        int size{ 256 };
+        int steps{ 2000 };
+        int checkEvery{ 100 };
+        uint32_t seed{ 1234 };
+        std::string kernelFile{ "kernels/grey_scott.cl" };
+        std::string kernelName{ "grey_scott_step" };
+        double tolerance{ 1e-3 };
+        int64_t ulpTolerance{ -1 };
+    };
+
+    struct FieldError {
+        double maxAbs{};
+        double meanAbs{};
+        double rms{};
+        int64_t maxUlp{};
+    };
+
+#ifdef USE_OPENCL
+    // Maps float bit patterns onto a monotonic integer line so that the
+    // difference of two mapped values is their distance in ULPs
+    int64_t orderedBits(float value) {
+        int32_t bits{};
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits < 0 ? static_cast<int64_t>(INT32_MIN) - bits : bits;
+    }
+
+    FieldError compareFields(const float* reference, const float* candidate,
+                             size_t count) {
+        FieldError error{};
+        double sumAbs{};
+        double sumSquares{};
+        for (size_t i{}; i < count; ++i) {
+            double diff{ std::fabs(static_cast<double>(reference[i]) - candidate[i]) };
+            error.maxAbs = std::max(error.maxAbs, diff);
+            sumAbs += diff;
+            sumSquares += diff * diff;
+
+            int64_t ulps{ orderedBits(reference[i]) - orderedBits(candidate[i]) };
+            error.maxUlp = std::max(error.maxUlp, ulps < 0 ? -ulps : ulps);
+        }
+        error.meanAbs = sumAbs / count;
+        error.rms = std::sqrt(sumSquares / count);
+        return error;
+    }
+#endif
+
+    bool parseOptions(int argc, char* argv[], ValidateOptions& options) {
+        for (int i{ 1 }; i < argc; ++i) {
+            std::string arg{ argv[i] };
+            if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+                std::cout << "Usage: greyscott_validate [--size N] [--steps N] "
+                             "[--check-every N] [--seed S] [--kernel file:name] "
+                             "[--tolerance ABS] [--ulp-tolerance ULPS]\n";
+                return false;
+            }
+
+            std::string value{ argv[++i] };
+            if (arg == "--size") { options.size = std::stoi(value); }
+            else if (arg == "--steps") { options.steps = std::stoi(value); }
+            else if (arg == "--check-every") { options.checkEvery = std::max(1, std::stoi(value)); }
+            else if (arg == "--seed") { options.seed = static_cast<uint32_t>(std::stoul(value)); }
+            else if (arg == "--tolerance") { options.tolerance = std::stod(value); }
+            else if (arg == "--ulp-tolerance") { options.ulpTolerance = std::stoll(value); }
+            else if (arg == "--kernel") {
+                size_t colon{ value.find(':') };
+                if (colon == std::string::npos) {
+                    std::cerr << "Kernel must be given as file:name\n";
+                    return false;
+                }
+                options.kernelFile = value.substr(0, colon);
+                options.kernelName = value.substr(colon + 1);
+            } else {
+                std::cerr << "Unknown option: " << arg << '\n';
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace GreyScott;
+
+    ValidateOptions options{};
+    try {
+        if (!parseOptions(argc, argv, options)) { return 2; }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid argument: " << e.what() << '\n';
+        return 2;
+    }
+
+#ifdef USE_OPENCL
+    ComputeManager computeManager{};
+    if (!computeManager.initialize(false)) {
+        std::cerr << "OpenCL unavailable, cannot validate\n";
+        return kExitSkipped;
+    }
+
+    SimulationCPU reference(options.size, options.size);
+    reference.setSeed(options.seed);
+    reference.initialize();
+
+    Simulation candidate(options.size, options.size, &computeManager);
+    candidate.setKernel(options.kernelFile, options.kernelName);
+    if (!candidate.initialize()) { return 2; }
+    candidate.setParams(reference.getParams());
+    candidate.syncFrom(reference.getData());
+
+    size_t count{ static_cast<size_t>(options.size) * options.size * 2 };
+    FieldError worst{};
+
+    std::cout << "\nValidating " << options.kernelName << " against SimulationCPU ("
+              << options.size << "x" << options.size << ", seed " << options.seed
+              << ")\n";
+    std::cout << std::setw(8) << "step" << std::setw(14) << "max abs"
+              << std::setw(14) << "mean abs" << std::setw(14) << "rms"
+              << std::setw(12) << "max ulp" << '\n';
+
+    for (int step{ 1 }; step <= options.steps; ++step) {
+        reference.step(reference.getParams());
+        candidate.step();
+
+        if (step % options.checkEvery != 0 && step != options.steps) { continue; }
+
+        candidate.forceReadBack();
+        FieldError error{ compareFields(reference.getData(), candidate.getData(), count) };
+        worst.maxAbs = std::max(worst.maxAbs, error.maxAbs);
+        worst.maxUlp = std::max(worst.maxUlp, error.maxUlp);
+
+        std::cout << std::setw(8) << step << std::scientific << std::setprecision(3)
+                  << std::setw(14) << error.maxAbs << std::setw(14) << error.meanAbs
+                  << std::setw(14) << error.rms << std::defaultfloat
+                  << std::setw(12) << error.maxUlp << '\n';
+    }
+
+    bool absFailed{ worst.maxAbs > options.tolerance };
+    bool ulpFailed{ options.ulpTolerance >= 0 && worst.maxUlp > options.ulpTolerance };
+    if (absFailed || ulpFailed) {
+        std::cout << "FAILED: max abs error " << worst.maxAbs << " (tolerance "
+                  << options.tolerance << "), max ULP " << worst.maxUlp << '\n';
+        return 1;
+    }
+
+    std::cout << "PASSED: max abs error " << worst.maxAbs << ", max ULP "
+              << worst.maxUlp << '\n';
+    return 0;
+#else
+    std::cerr << "Built without OpenCL, nothing to validate\n";
+    return 2;
+#endif
+}
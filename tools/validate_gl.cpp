@@ -0,0 +1,238 @@
+// Numerical cross-validation of the OpenGL compute-shader engine against
+// SimulationCPU.
+//
+// Opens a hidden GL 4.3 window (falling back to SDL's offscreen driver when
+// there is no display), steps both engines from the same seeded state and
+// compares the fields every --check-every steps. The display texture is
+// checked against the state it should show as well, right after the state
+// is uploaded and after stepping. Exits non-zero when the error exceeds
+// --tolerance or the engine fails to initialize, or with 77 (skipped under
+// CTest) only when no GL 4.3 context can be created. Mesa's llvmpipe is
+// sufficient, e.g. with LIBGL_ALWAYS_SOFTWARE=1.
+//
+// Usage: greyscott_validate_gl [--size N] [--steps N] [--check-every N]
+//                              [--seed S] [--tolerance ABS]
+#include "SimulationCPU.hpp"
+#include "SimulationGL.hpp"
+#include <GL/glew.h>
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr int kExitSkipped{ 77 };
+
+    struct ValidateOptions {
+        int size{ 256 };
+        int steps{ 2000 };
+        int checkEvery{ 100 };
+        uint32_t seed{ 1234 };
+        double tolerance{ 1e-3 };
+    };
+
+    struct FieldError {
+        double maxAbs{};
+        double meanAbs{};
+    };
+
+    FieldError compareFields(const float* reference, const float* candidate, size_t count) {
+        FieldError error{};
+        double sumAbs{};
+        for (size_t i{}; i < count; ++i) {
+            double diff{ std::fabs(static_cast<double>(reference[i]) - candidate[i]) };
+            error.maxAbs = std::max(error.maxAbs, diff);
+            sumAbs += diff;
+        }
+        error.meanAbs = sumAbs / count;
+        return error;
+    }
+
+    // The RG32F display texture holds U and V as the state does
+    void readDisplay(const GreyScott::SimulationGL& simulation, std::vector<float>& texels) {
+        glBindTexture(GL_TEXTURE_2D, simulation.getDisplayTexture());
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RG, GL_FLOAT, texels.data());
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    bool parseOptions(int argc, char* argv[], ValidateOptions& options) {
+        for (int i{ 1 }; i < argc; ++i) {
+            std::string arg{ argv[i] };
+            if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+                std::cout << "Usage: greyscott_validate_gl [--size N] [--steps N] "
+                             "[--check-every N] [--seed S] [--tolerance ABS]\n";
+                return false;
+            }
+
+            std::string value{ argv[++i] };
+            if (arg == "--size") { options.size = std::stoi(value); }
+            else if (arg == "--steps") { options.steps = std::stoi(value); }
+            else if (arg == "--check-every") { options.checkEvery = std::max(1, std::stoi(value)); }
+            else if (arg == "--seed") { options.seed = static_cast<uint32_t>(std::stoul(value)); }
+            else if (arg == "--tolerance") { options.tolerance = std::stod(value); }
+            else {
+                std::cerr << "Unknown option: " << arg << '\n';
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Hidden SDL window with a current GL 4.3 core context
+     */
+    class HeadlessContext {
+    public:
+        ~HeadlessContext() {
+            if (m_context) { SDL_GL_DeleteContext(m_context); }
+            if (m_window) { SDL_DestroyWindow(m_window); }
+            if (m_sdl) { SDL_Quit(); }
+        }
+
+        bool create() {
+            if (!initVideo()) { return false; }
+
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+
+            m_window = SDL_CreateWindow("greyscott_validate_gl", SDL_WINDOWPOS_CENTERED,
+                                        SDL_WINDOWPOS_CENTERED, 64, 64,
+                                        SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+            if (!m_window) {
+                std::cerr << "Failed to create window: " << SDL_GetError() << '\n';
+                return false;
+            }
+            m_context = SDL_GL_CreateContext(m_window);
+            if (!m_context) {
+                std::cerr << "Failed to create a GL 4.3 context: " << SDL_GetError() << '\n';
+                return false;
+            }
+
+            glewExperimental = GL_TRUE;
+            GLenum glewError{ glewInit() };
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+            // EGL-backed contexts (offscreen driver) have no GLX display;
+            // the GL entry points are loaded regardless
+            if (glewError == GLEW_ERROR_NO_GLX_DISPLAY) { glewError = GLEW_OK; }
+#endif
+            if (glewError != GLEW_OK) {
+                std::cerr << "Failed to initialize GLEW: " << glewGetErrorString(glewError)
+                          << '\n';
+                return false;
+            }
+            glGetError(); // GLEW may leave GL_INVALID_ENUM behind
+            return true;
+        }
+
+    private:
+        bool initVideo() {
+            if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+                m_sdl = true;
+                return true;
+            }
+
+            // No display server, e.g. on CI: try EGL without a window system
+            std::string error{ SDL_GetError() };
+            SDL_SetHint("SDL_VIDEODRIVER", "offscreen");
+            if (SDL_Init(SDL_INIT_VIDEO) == 0) {
+                m_sdl = true;
+                return true;
+            }
+            std::cerr << "Failed to initialize SDL video: " << error << '\n';
+            return false;
+        }
+
+        SDL_Window* m_window{};
+        SDL_GLContext m_context{};
+        bool m_sdl{};
+    };
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace GreyScott;
+
+    ValidateOptions options{};
+    try {
+        if (!parseOptions(argc, argv, options)) { return 2; }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid argument: " << e.what() << '\n';
+        return 2;
+    }
+
+    HeadlessContext context{};
+    if (!context.create()) {
+        std::cerr << "OpenGL 4.3 unavailable, cannot validate\n";
+        return kExitSkipped;
+    }
+    std::cout << "OpenGL renderer: " << glGetString(GL_RENDERER) << '\n';
+
+    SimulationCPU reference(options.size, options.size);
+    reference.setSeed(options.seed);
+    reference.initialize();
+
+    SimulationGL candidate(options.size, options.size);
+    candidate.setDisplayFormat(DisplayFormat::RG32F);
+    // The context is there, so this is the engine's own shaders failing
+    if (!candidate.initialize()) {
+        std::cout << "FAILED: SimulationGL did not initialize\n";
+        return 1;
+    }
+    candidate.setParams(reference.getParams());
+    candidate.syncFrom(reference.getData());
+
+    size_t count{ static_cast<size_t>(options.size) * options.size * 2 };
+    std::vector<float> display(count);
+    bool failed{};
+
+    // An uploaded state must be displayed before any step is taken
+    readDisplay(candidate, display);
+    FieldError uploaded{ compareFields(reference.getData(), display.data(), count) };
+    if (uploaded.maxAbs != 0.0) {
+        std::cout << "FAILED: display texture differs from the uploaded state by "
+                  << uploaded.maxAbs << '\n';
+        failed = true;
+    }
+
+    std::cout << "\nValidating SimulationGL against SimulationCPU (" << options.size << "x"
+              << options.size << ", seed " << options.seed << ")\n";
+    std::cout << std::setw(8) << "step" << std::setw(14) << "max abs"
+              << std::setw(14) << "mean abs" << std::setw(14) << "display" << '\n';
+
+    double worst{};
+    for (int step{ 1 }; step <= options.steps; ++step) {
+        reference.step(reference.getParams());
+        candidate.step();
+
+        if (step % options.checkEvery != 0 && step != options.steps) { continue; }
+
+        candidate.forceReadBack();
+        FieldError error{ compareFields(reference.getData(), candidate.getData(), count) };
+        readDisplay(candidate, display);
+        FieldError shown{ compareFields(candidate.getData(), display.data(), count) };
+        worst = std::max(worst, error.maxAbs);
+        if (shown.maxAbs != 0.0) { failed = true; }
+
+        std::cout << std::setw(8) << step << std::scientific << std::setprecision(3)
+                  << std::setw(14) << error.maxAbs << std::setw(14) << error.meanAbs
+                  << std::setw(14) << shown.maxAbs << std::defaultfloat << '\n';
+    }
+
+    if (worst > options.tolerance) {
+        std::cout << "FAILED: max abs error " << worst << " (tolerance " << options.tolerance
+                  << ")\n";
+        return 1;
+    }
+    if (failed) {
+        std::cout << "FAILED: display texture does not show the current state\n";
+        return 1;
+    }
+
+    std::cout << "PASSED: max abs error " << worst << '\n';
+    return 0;
+}